@@ -0,0 +1,399 @@
+//=============================================================================
+// adaptive_engine.cpp
+//
+//    A version of the Engine that fits only as many of the (k,h) cells as
+//    the smoothness of the results requires, and interpolates the rest.
+//
+// notes:
+// o  The results are smooth functions of ln k and ln h nearly everywhere;
+//    they change sharply only near the thicknesses at which observations
+//    switch between the confined and unconfined branches of
+//    DischargePotential.
+//
+// o  The fit starts from a coarse lattice of "coarse" set points along each
+//    axis of the full k_count x h_count grid. A rectangle of the lattice
+//    is tested by fitting the midpoints of its edges and its center, and
+//    comparing each with the bilinear interpolation, in ln k and ln h, of
+//    the four corners. If every recharge, magnitude, and direction, and
+//    their standard deviations, agree to within "tolerance" times the
+//    fitted standard deviation, the rectangle is accepted and its
+//    remaining cells are interpolated. Otherwise it is split at its
+//    midpoints into (up to) four rectangles, whose corners are already
+//    fit, and each is tested in turn.
+//
+// o  The tolerance is relative to the statistical uncertainty of each
+//    result: an interpolation error much smaller than the standard
+//    deviation is immaterial. A tolerance of 0 fits every cell.
+//
+// o  The tolerance is checked only at the test points, the edge midpoints
+//    and center, where a smooth result's bilinear interpolation error is
+//    largest. It is not a bound on the error of every interpolated cell.
+//    The error at other cells of an accepted rectangle can be larger, e.g.
+//    where a recharge crosses zero or an observation switches branches
+//    between the test points. On the sample data the largest such errors
+//    were about 1.3 times the tolerance.
+//
+// o  The rectangles are refined one level at a time. All of the new test
+//    points of a level are fit in parallel.
+//
+// o  At a fixed head, the discharge potential and its standard deviation
+//    are proportional to k, and so are the recharge and magnitude and their
+//    standard deviations. Hence the standard deviations are interpolated in
+//    their logarithms, and the recharge and magnitude as multiples of their
+//    standard deviations. Without pumping wells, these interpolations are
+//    exact along k.
+//
+// o  The directions are interpolated relative to the first corner, so that
+//    a rectangle may straddle the branch cut.
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+
+#include "adaptive_engine.h"
+#include "engine.h"
+#include "normal_equations.h"
+#include "numerical_constants.h"
+#include "parallel_for-inl.h"
+#include "preprocess.h"
+
+//-----------------------------------------------------------------------------
+namespace {
+
+   //--------------------------------------------------------------------------
+   // A rectangle of the grid, [i0,i1] x [j0,j1], inclusive.
+   //--------------------------------------------------------------------------
+   struct Rectangle {
+      int i0, i1;
+      int j0, j1;
+   };
+
+   // Every field of the CellResult, in the order of RESULT_FIELDS and then
+   // FIT_FIELDS.
+   double CellResult::* const ALL_FIELDS[] = {
+      &CellResult::r_ev, &CellResult::r_sd,
+      &CellResult::m_ev, &CellResult::m_sd,
+      &CellResult::d_ev, &CellResult::d_sd,
+      &CellResult::wrss, &CellResult::reduced_chisq, &CellResult::loglik
+   };
+
+   //--------------------------------------------------------------------------
+   // The lattice of "coarse" evenly spaced indices from 0 to count-1.
+   //--------------------------------------------------------------------------
+   std::vector<int> CoarseNodes( int count, int coarse ) {
+      const int n = std::min(coarse, count);
+      if (n < 2)
+         return std::vector<int>(1, 0);
+
+      std::vector<int> nodes(n);
+      for (int t = 0; t < n; ++t)
+         nodes[t] = (t*(count-1) + (n-1)/2) / (n-1);
+      return nodes;
+   }
+
+   //--------------------------------------------------------------------------
+   // The split points of [a0,a1]: {a0, a1}, with the midpoint between them
+   // if there is one.
+   //--------------------------------------------------------------------------
+   std::vector<int> Split( int a0, int a1 ) {
+      if (a1 - a0 < 2)
+         return std::vector<int>{a0, a1};
+      return std::vector<int>{a0, (a0+a1)/2, a1};
+   }
+
+   //--------------------------------------------------------------------------
+   // The fraction of the way from x0 to x1 at x.
+   //--------------------------------------------------------------------------
+   double Fraction( double x0, double x1, double x ) {
+      return (x1 > x0) ? (x - x0)/(x1 - x0) : 0.0;
+   }
+
+   //--------------------------------------------------------------------------
+   // The bilinear interpolation of the corners, c00 = (i0,j0), c10 = (i1,j0),
+   // c01 = (i0,j1), and c11 = (i1,j1), at fractions s along k and t along h.
+   //--------------------------------------------------------------------------
+   CellResult Interpolate(
+      const CellResult& c00, const CellResult& c10,
+      const CellResult& c01, const CellResult& c11,
+      double s, double t ) {
+
+      const double w[4] = { (1-s)*(1-t), s*(1-t), (1-s)*t, s*t };
+      const CellResult* c[4] = { &c00, &c10, &c01, &c11 };
+
+      CellResult cell;
+      for (double CellResult::* field : ALL_FIELDS) {
+         cell.*field = 0.0;
+         for (int a = 0; a < 4; ++a)
+            cell.*field += w[a] * (c[a]->*field);
+      }
+
+      // The standard deviations geometrically, and the expected values as
+      // multiples of them.
+      double ln_r_sd = 0.0, ln_m_sd = 0.0, ln_d_sd = 0.0, r_z = 0.0, m_z = 0.0, d = 0.0;
+      for (int a = 0; a < 4; ++a) {
+         ln_r_sd += w[a] * std::log(c[a]->r_sd);
+         ln_m_sd += w[a] * std::log(c[a]->m_sd);
+         ln_d_sd += w[a] * std::log(c[a]->d_sd);
+         r_z     += w[a] * c[a]->r_ev / c[a]->r_sd;
+         m_z     += w[a] * c[a]->m_ev / c[a]->m_sd;
+         d       += w[a] * std::remainder(c[a]->d_ev - c00.d_ev, TWO_PI);
+      }
+
+      cell.r_sd = std::exp(ln_r_sd);
+      cell.m_sd = std::exp(ln_m_sd);
+      cell.d_sd = std::exp(ln_d_sd);
+      cell.r_ev = r_z * cell.r_sd;
+      cell.m_ev = m_z * cell.m_sd;
+      cell.d_ev = std::remainder(c00.d_ev + d, TWO_PI);
+      return cell;
+   }
+
+   //--------------------------------------------------------------------------
+   // True if the interpolated cell agrees with the fitted cell to within
+   // tolerance times the fitted standard deviations.
+   //--------------------------------------------------------------------------
+   bool Agrees( const CellResult& fit, const CellResult& interpolated, double tolerance ) {
+      const double r = tolerance * fit.r_sd;
+      const double m = tolerance * fit.m_sd;
+      const double d = tolerance * fit.d_sd;
+      return std::fabs(fit.r_ev - interpolated.r_ev) <= r
+          && std::fabs(fit.r_sd - interpolated.r_sd) <= r
+          && std::fabs(fit.m_ev - interpolated.m_ev) <= m
+          && std::fabs(fit.m_sd - interpolated.m_sd) <= m
+          && std::fabs(std::remainder(fit.d_ev - interpolated.d_ev, TWO_PI)) <= d
+          && std::fabs(fit.d_sd - interpolated.d_sd) <= d;
+   }
+}
+
+//=============================================================================
+// AdaptiveEngine
+//
+//    As Engine, fitting only the cells needed to interpolate the rest to
+//    within the tolerance; see the notes above. The sink receives the full
+//    k_count x h_count grid. Each fitted cell is also written to
+//    "points_out", one .csv line per cell,
+//
+//       i, j, k, h, recharge_ev, ..., direction_sd
+//
+//    after a header line, in the order in which they were fit.
+//
+// Arguments:
+//    xo, yo         the model origin.
+//    k_alpha, ...   the conductivity and thickness distributions, as in
+//                   Engine.
+//    radius         the well buffer radius.
+//    obs            the observations.
+//    wells          the pumping wells.
+//    coarse         the number of lattice points along each axis to start.
+//    tolerance      the largest acceptable interpolation error, as a
+//                   fraction of the standard deviation.
+//    nthreads       the maximum number of threads; see ThreadCount.
+//    sink           receives each row of results.
+//    points_out     the output stream for the fitted cells.
+//
+// Returns:
+//    the number of cells fit.
+//=============================================================================
+int AdaptiveEngine(
+   double xo, double yo,
+   double k_alpha, double k_beta, int k_count,
+   double h_alpha, double h_beta, int h_count,
+   double radius,
+   const ObsTable& obs,
+   const std::vector<WellRecord>& wells,
+   int coarse,
+   double tolerance,
+   int nthreads,
+   ResultSink& sink,
+   std::ostream& points_out) {
+
+   // Manifest constants.
+   const int MINIMUM_COUNT = 10; // At least this many unique observation locations.
+
+   const int n = QUADRATIC_TERMS;
+
+   std::vector<double> k = SetPoints(k_alpha, k_beta, k_count);
+   std::vector<double> h = SetPoints(h_alpha, h_beta, h_count);
+
+   std::vector<int> active = ActiveIndices(obs, wells, radius, true);
+
+   int Mactive = active.size();
+   int Munique = CountUniqueLocations(obs, active);
+   if (Munique < MINIMUM_COUNT) {
+      std::stringstream message;
+      message << "Too few unique active observation locations: " << Munique << " < " << MINIMUM_COUNT << std::endl;
+      throw TooFewObservations(message.str());
+   }
+   std::cout << Mactive << " active observation data records at " << Munique << " unique locations." << std::endl;
+
+   const int M = Mactive;
+   const double log_head_sd = HeadLogSdSum(obs, active);
+
+   std::vector<double> rows(M*n);
+   std::vector<double> Phi_wells(M);
+   for (int m = 0; m < M; ++m) {
+      QuadraticBasis(obs.x()[active[m]] - xo, obs.y()[active[m]] - yo, &rows[m*n]);
+      Phi_wells[m] = WellPotential(obs.x()[active[m]], obs.y()[active[m]], wells);
+   }
+
+   std::vector<double> ln_k(k_count), ln_h(h_count);
+   for (int i = 0; i < k_count; ++i)
+      ln_k[i] = std::log(k[i]);
+   for (int j = 0; j < h_count; ++j)
+      ln_h[j] = std::log(h[j]);
+
+   // grid[i*h_count + j] is cell (i,j); fitted[] marks the cells that are,
+   // or are about to be, fit.
+   std::vector<CellResult> grid(k_count * h_count);
+   std::vector<char> fitted(k_count * h_count, 0);
+   std::vector<int> order;
+
+   // Fit the listed cells, in parallel, and mark them.
+   auto Fit = [&]( const std::vector<int>& cells ) {
+      ParallelFor(0, static_cast<int>(cells.size()), nthreads, [&](int c) {
+         const int i = cells[c] / h_count;
+         const int j = cells[c] % h_count;
+
+         NormalEquations equations;
+         for (int m = 0; m < M; ++m) {
+            double Phi_ev, Phi_sd;
+            DischargePotential(obs.head_ev()[active[m]], obs.head_sd()[active[m]], k[i], h[j], Phi_ev, Phi_sd);
+            equations.Add(&rows[m*n], 1.0/(Phi_sd*Phi_sd), Phi_ev - Phi_wells[m]);
+         }
+
+         Matrix XtWX, XtWY;
+         equations.Assemble(XtWX, XtWY);
+
+         Matrix P_ev, P_cov;
+         std::tie(P_ev, P_cov) = SolveNormalEquations(XtWX, XtWY);
+
+         CellResult& cell = grid[cells[c]];
+         cell = ComputeCellResult(P_ev, P_cov);
+         SetGoodnessOfFit(cell, WeightedResidualSumOfSquares(equations.yWy(), XtWY, P_ev), M, n, log_head_sd);
+      });
+      order.insert(order.end(), cells.begin(), cells.end());
+   };
+
+   // Queue cell (i,j) to be fit, unless it already is.
+   auto Queue = [&]( int i, int j, std::vector<int>& cells ) {
+      if (!fitted[i*h_count + j]) {
+         fitted[i*h_count + j] = 1;
+         cells.push_back(i*h_count + j);
+      }
+   };
+
+   // The coarse lattice.
+   const std::vector<int> k_nodes = CoarseNodes(k_count, coarse);
+   const std::vector<int> h_nodes = CoarseNodes(h_count, coarse);
+
+   std::vector<int> cells;
+   for (int i : k_nodes)
+      for (int j : h_nodes)
+         Queue(i, j, cells);
+   Fit(cells);
+
+   std::vector<Rectangle> pending;
+   const size_t k_rectangles = std::max<size_t>(k_nodes.size(), 2) - 1;
+   const size_t h_rectangles = std::max<size_t>(h_nodes.size(), 2) - 1;
+   for (size_t a = 0; a < k_rectangles; ++a) {
+      for (size_t b = 0; b < h_rectangles; ++b) {
+         const int i1 = k_nodes[std::min(a+1, k_nodes.size()-1)];
+         const int j1 = h_nodes[std::min(b+1, h_nodes.size()-1)];
+         pending.push_back( Rectangle{k_nodes[a], i1, h_nodes[b], j1} );
+      }
+   }
+
+   // Refine one level at a time.
+   std::vector<Rectangle> accepted;
+   while (!pending.empty()) {
+      cells.clear();
+      for (const Rectangle& r : pending)
+         for (int i : Split(r.i0, r.i1))
+            for (int j : Split(r.j0, r.j1))
+               Queue(i, j, cells);
+      Fit(cells);
+
+      std::vector<Rectangle> next;
+      for (const Rectangle& r : pending) {
+         if (r.i1 - r.i0 < 2 && r.j1 - r.j0 < 2)
+            continue;
+
+         const CellResult& c00 = grid[r.i0*h_count + r.j0];
+         const CellResult& c10 = grid[r.i1*h_count + r.j0];
+         const CellResult& c01 = grid[r.i0*h_count + r.j1];
+         const CellResult& c11 = grid[r.i1*h_count + r.j1];
+
+         const std::vector<int> is = Split(r.i0, r.i1);
+         const std::vector<int> js = Split(r.j0, r.j1);
+
+         bool agrees = true;
+         for (int i : is) {
+            for (int j : js) {
+               const double s = Fraction(ln_k[r.i0], ln_k[r.i1], ln_k[i]);
+               const double t = Fraction(ln_h[r.j0], ln_h[r.j1], ln_h[j]);
+               agrees = agrees && Agrees(grid[i*h_count + j], Interpolate(c00, c10, c01, c11, s, t), tolerance);
+            }
+         }
+
+         if (agrees)
+            accepted.push_back(r);
+         else {
+            for (size_t a = 0; a+1 < is.size(); ++a)
+               for (size_t b = 0; b+1 < js.size(); ++b)
+                  next.push_back( Rectangle{is[a], is[a+1], js[b], js[b+1]} );
+         }
+      }
+      pending.swap(next);
+   }
+
+   // Interpolate the cells that were not fit.
+   for (const Rectangle& r : accepted) {
+      const CellResult& c00 = grid[r.i0*h_count + r.j0];
+      const CellResult& c10 = grid[r.i1*h_count + r.j0];
+      const CellResult& c01 = grid[r.i0*h_count + r.j1];
+      const CellResult& c11 = grid[r.i1*h_count + r.j1];
+
+      for (int i = r.i0; i <= r.i1; ++i) {
+         for (int j = r.j0; j <= r.j1; ++j) {
+            if (fitted[i*h_count + j])
+               continue;
+            const double s = Fraction(ln_k[r.i0], ln_k[r.i1], ln_k[i]);
+            const double t = Fraction(ln_h[r.j0], ln_h[r.j1], ln_h[j]);
+            grid[i*h_count + j] = Interpolate(c00, c10, c01, c11, s, t);
+         }
+      }
+   }
+
+   sink.Begin(k, h);
+   for (int i = 0; i < k_count; ++i)
+      sink.Row(i, std::vector<CellResult>(grid.begin() + i*h_count, grid.begin() + (i+1)*h_count));
+   sink.End();
+
+   points_out << "i,j,k,h";
+   for (int f = 0; f < RESULT_FIELD_COUNT; ++f)
+      points_out << ',' << RESULT_FIELDS[f].name;
+   points_out << '\n';
+   points_out.precision(17);
+
+   for (int c : order) {
+      const int i = c / h_count;
+      const int j = c % h_count;
+      points_out << i << ',' << j << ',' << k[i] << ',' << h[j];
+      for (int f = 0; f < RESULT_FIELD_COUNT; ++f)
+         points_out << ',' << RESULT_FIELDS[f].scale * (grid[c].*RESULT_FIELDS[f].value);
+      points_out << '\n';
+   }
+
+   const int nfits = order.size();
+   std::cout << nfits << " of " << k_count*h_count << " (k,h) cells fit; the rest interpolated." << std::endl;
+   return nfits;
+}
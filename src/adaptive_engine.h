@@ -0,0 +1,38 @@
+//=============================================================================
+// adaptive_engine.h
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#ifndef ADAPTIVE_ENGINE_H
+#define ADAPTIVE_ENGINE_H
+
+#include <ostream>
+#include <vector>
+
+#include "obs_table.h"
+#include "read_data.h"
+#include "result_sink.h"
+
+//=============================================================================
+int AdaptiveEngine(
+   double xo, double yo,
+   double k_alpha, double k_beta, int k_count,
+   double h_alpha, double h_beta, int h_count,
+   double radius,
+   const ObsTable& obs,
+   const std::vector<WellRecord>& wells,
+   int coarse,
+   double tolerance,
+   int nthreads,
+   ResultSink& sink,
+   std::ostream& points_out
+);
+
+//=============================================================================
+#endif  // ADAPTIVE_ENGINE_H
@@ -0,0 +1,464 @@
+//=============================================================================
+// binary_data.cpp
+//
+//    Read and write the observation and well data in a compact binary
+//    columnar format, so that large data sets are parsed from text only once.
+//
+// notes:
+// o  The file layout is a fixed 64-byte header followed by six sections.
+//    Every section starts on a 64-byte boundary, and all values are stored
+//    little-endian.
+//
+//       header         magic "GIMIWANB", version (u32), kind (u32),
+//                      record count (u64), string count (u64), string
+//                      table bytes (u64), and zero padding.
+//
+//       column 0..3    one double per record. For observations the columns
+//                      are {x, y, head_ev, head_sd}; for wells the columns
+//                      are {x, y, r, q}.
+//
+//       id index       one u32 per record: the index of the record's id in
+//                      the interned string table.
+//
+//       offsets        (string count + 1) u64 offsets into the string bytes.
+//
+//       strings        the unique id strings, concatenated.
+//
+// o  Repeated ids (e.g. the same well nest logged many times) are stored
+//    only once in the string table.
+//
+// o  The loader maps the file into memory and hands out pointers directly
+//    into the mapping; nothing is parsed or copied. The header, the string
+//    offsets, and the id index are validated once at open, so that a
+//    corrupt file cannot read outside the mapping. The observation heads
+//    and their standard deviations are checked at open as well.
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "binary_data.h"
+#include "numerical_constants.h"
+
+//-----------------------------------------------------------------------------
+namespace {
+   const char     MAGIC[8]       = {'G','I','M','I','W','A','N','B'};
+   const uint32_t FORMAT_VERSION = 1;
+   const uint64_t HEADER_BYTES   = 64;
+   const uint64_t ALIGNMENT      = 64;
+
+   //--------------------------------------------------------------------------
+   uint64_t Pad( uint64_t n ) {
+      return (n + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+   }
+
+   //--------------------------------------------------------------------------
+   bool isLittleEndian() {
+      const uint16_t probe = 1;
+      return *reinterpret_cast<const unsigned char*>(&probe) == 1;
+   }
+
+   //--------------------------------------------------------------------------
+   // Section offsets, computed from the three counts in the header.
+   //--------------------------------------------------------------------------
+   struct Layout {
+      uint64_t column[BINARY_COLUMNS];
+      uint64_t id_index;
+      uint64_t offsets;
+      uint64_t strings;
+      uint64_t total;
+
+      Layout( uint64_t count, uint64_t nstrings, uint64_t string_bytes ) {
+         uint64_t position = HEADER_BYTES;
+         for (int c = 0; c < BINARY_COLUMNS; ++c) {
+            column[c] = position;
+            position += Pad(count * sizeof(double));
+         }
+         id_index = position;
+         position += Pad(count * sizeof(uint32_t));
+         offsets  = position;
+         position += Pad((nstrings + 1) * sizeof(uint64_t));
+         strings  = position;
+         total    = position + string_bytes;
+      }
+   };
+
+   //--------------------------------------------------------------------------
+   void PutU32( std::vector<char>& buffer, uint64_t offset, uint32_t v ) {
+      for (int b = 0; b < 4; ++b)
+         buffer[offset + b] = static_cast<char>((v >> (8*b)) & 0xFF);
+   }
+
+   void PutU64( std::vector<char>& buffer, uint64_t offset, uint64_t v ) {
+      for (int b = 0; b < 8; ++b)
+         buffer[offset + b] = static_cast<char>((v >> (8*b)) & 0xFF);
+   }
+
+   void PutDouble( std::vector<char>& buffer, uint64_t offset, double x ) {
+      uint64_t v;
+      memcpy(&v, &x, sizeof(v));
+      PutU64(buffer, offset, v);
+   }
+
+   uint32_t GetU32( const char* p ) {
+      uint32_t v = 0;
+      for (int b = 3; b >= 0; --b)
+         v = (v << 8) | static_cast<unsigned char>(p[b]);
+      return v;
+   }
+
+   uint64_t GetU64( const char* p ) {
+      uint64_t v = 0;
+      for (int b = 7; b >= 0; --b)
+         v = (v << 8) | static_cast<unsigned char>(p[b]);
+      return v;
+   }
+
+   //--------------------------------------------------------------------------
+   // Assemble the complete file image in memory, then write it with a single
+   // call. The caller supplies the ids and the four columns, record by record.
+   //--------------------------------------------------------------------------
+   void write_columnar( const std::string& outfilename, BinaryKind kind,
+      const std::vector<std::string>& ids, const std::vector<double> (&columns)[BINARY_COLUMNS] )
+   {
+      const uint64_t count = ids.size();
+
+      // Intern the id strings.
+      std::unordered_map<std::string, uint32_t> lookup;
+      std::vector<const std::string*> unique;
+      std::vector<uint32_t> id_index(count);
+      uint64_t string_bytes = 0;
+
+      for (uint64_t m = 0; m < count; ++m) {
+         auto it = lookup.find(ids[m]);
+         if (it == lookup.end()) {
+            it = lookup.emplace(ids[m], static_cast<uint32_t>(unique.size())).first;
+            unique.push_back(&it->first);
+            string_bytes += ids[m].size();
+         }
+         id_index[m] = it->second;
+      }
+
+      const uint64_t nstrings = unique.size();
+      Layout layout(count, nstrings, string_bytes);
+      std::vector<char> buffer(layout.total, 0);
+
+      // The header.
+      memcpy(buffer.data(), MAGIC, sizeof(MAGIC));
+      PutU32(buffer,  8, FORMAT_VERSION);
+      PutU32(buffer, 12, kind);
+      PutU64(buffer, 16, count);
+      PutU64(buffer, 24, nstrings);
+      PutU64(buffer, 32, string_bytes);
+
+      // The data columns.
+      for (int c = 0; c < BINARY_COLUMNS; ++c)
+         for (uint64_t m = 0; m < count; ++m)
+            PutDouble(buffer, layout.column[c] + m*sizeof(double), columns[c][m]);
+
+      // The interned id table.
+      for (uint64_t m = 0; m < count; ++m)
+         PutU32(buffer, layout.id_index + m*sizeof(uint32_t), id_index[m]);
+
+      uint64_t position = 0;
+      for (uint64_t s = 0; s < nstrings; ++s) {
+         PutU64(buffer, layout.offsets + s*sizeof(uint64_t), position);
+         memcpy(buffer.data() + layout.strings + position, unique[s]->data(), unique[s]->size());
+         position += unique[s]->size();
+      }
+      PutU64(buffer, layout.offsets + nstrings*sizeof(uint64_t), position);
+
+      // Write the image.
+      std::ofstream outfile( outfilename, std::ios::binary );
+      if ( outfile.fail() ) {
+         std::stringstream message;
+         message << "Could not open <" << outfilename << "> for output.";
+         throw InvalidBinaryFile(message.str());
+      }
+
+      outfile.write(buffer.data(), buffer.size());
+      if ( outfile.fail() ) {
+         std::stringstream message;
+         message << "Writing <" << outfilename << "> failed.";
+         throw InvalidBinaryFile(message.str());
+      }
+   }
+}
+
+//=============================================================================
+// MappedFile
+//=============================================================================
+MappedFile::MappedFile( const std::string& filename )
+:  m_Data( nullptr ),
+   m_Size( 0 ),
+   m_Handle( nullptr )
+{
+   std::stringstream message;
+   message << "Could not map <" << filename << "> into memory.";
+
+#ifdef _WIN32
+   HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+      OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+   if (file == INVALID_HANDLE_VALUE)
+      throw InvalidBinaryFile(message.str());
+
+   LARGE_INTEGER size;
+   if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+      CloseHandle(file);
+      throw InvalidBinaryFile(message.str());
+   }
+
+   HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+   CloseHandle(file);
+   if (mapping == nullptr)
+      throw InvalidBinaryFile(message.str());
+
+   const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+   if (view == nullptr) {
+      CloseHandle(mapping);
+      throw InvalidBinaryFile(message.str());
+   }
+
+   m_Data   = static_cast<const char*>(view);
+   m_Size   = static_cast<std::size_t>(size.QuadPart);
+   m_Handle = mapping;
+#else
+   int fd = open(filename.c_str(), O_RDONLY);
+   if (fd < 0)
+      throw InvalidBinaryFile(message.str());
+
+   struct stat status;
+   if (fstat(fd, &status) != 0 || status.st_size == 0) {
+      close(fd);
+      throw InvalidBinaryFile(message.str());
+   }
+
+   void* view = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+   close(fd);
+   if (view == MAP_FAILED)
+      throw InvalidBinaryFile(message.str());
+
+   m_Data = static_cast<const char*>(view);
+   m_Size = static_cast<std::size_t>(status.st_size);
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifdef _WIN32
+   UnmapViewOfFile(m_Data);
+   CloseHandle(static_cast<HANDLE>(m_Handle));
+#else
+   munmap(const_cast<char*>(m_Data), m_Size);
+#endif
+}
+
+const char* MappedFile::Data() const {
+   return m_Data;
+}
+
+std::size_t MappedFile::Size() const {
+   return m_Size;
+}
+
+//=============================================================================
+// ColumnarFile
+//=============================================================================
+ColumnarFile::ColumnarFile( const std::string& filename, BinaryKind kind )
+:  m_File( filename ),
+   m_Count( 0 ),
+   m_Columns(),
+   m_IdIndex( nullptr ),
+   m_StringOffsets( nullptr ),
+   m_Strings( nullptr )
+{
+   std::stringstream message;
+   message << "<" << filename << "> is not a valid Gimiwan binary ";
+   message << (kind == BINARY_OBSERVATIONS ? "observation" : "well") << " file";
+
+   const char* base = m_File.Data();
+
+   if (m_File.Size() < HEADER_BYTES || memcmp(base, MAGIC, sizeof(MAGIC)) != 0) {
+      message << ".";
+      throw InvalidBinaryFile(message.str());
+   }
+   if (GetU32(base+8) != FORMAT_VERSION) {
+      message << ": unsupported version " << GetU32(base+8) << ".";
+      throw InvalidBinaryFile(message.str());
+   }
+   if (GetU32(base+12) != kind) {
+      message << ": the file holds the other kind of records.";
+      throw InvalidBinaryFile(message.str());
+   }
+
+   const uint64_t count        = GetU64(base+16);
+   const uint64_t nstrings     = GetU64(base+24);
+   const uint64_t string_bytes = GetU64(base+32);
+
+   if (count > 0x7FFFFFFF || nstrings > count || string_bytes > m_File.Size()) {
+      message << ": corrupt header.";
+      throw InvalidBinaryFile(message.str());
+   }
+
+   Layout layout(count, nstrings, string_bytes);
+   if (m_File.Size() < layout.total) {
+      message << ": the file is truncated.";
+      throw InvalidBinaryFile(message.str());
+   }
+
+   // The zero-copy view reinterprets the little-endian columns in place.
+   if (!isLittleEndian()) {
+      message << ": binary files require a little-endian host.";
+      throw InvalidBinaryFile(message.str());
+   }
+
+   m_Count    = static_cast<int>(count);
+   for (int c = 0; c < BINARY_COLUMNS; ++c)
+      m_Columns[c] = reinterpret_cast<const double*>(base + layout.column[c]);
+   m_IdIndex       = reinterpret_cast<const uint32_t*>(base + layout.id_index);
+   m_StringOffsets = reinterpret_cast<const uint64_t*>(base + layout.offsets);
+   m_Strings       = base + layout.strings;
+
+   // Every id must be a valid string, and every string must lie within the
+   // string table, so that Id need not check either.
+   if (m_StringOffsets[0] != 0 || m_StringOffsets[nstrings] != string_bytes) {
+      message << ": corrupt id strings.";
+      throw InvalidBinaryFile(message.str());
+   }
+   for (uint64_t s = 0; s < nstrings; ++s) {
+      if (m_StringOffsets[s] > m_StringOffsets[s+1]) {
+         message << ": corrupt id strings.";
+         throw InvalidBinaryFile(message.str());
+      }
+   }
+   for (uint64_t m = 0; m < count; ++m) {
+      if (m_IdIndex[m] >= nstrings) {
+         message << ": corrupt id index.";
+         throw InvalidBinaryFile(message.str());
+      }
+   }
+
+   // The same value checks as the .csv reader, so that no caller need
+   // repeat them. A NaN fails the test as well.
+   if (kind == BINARY_OBSERVATIONS) {
+      for (uint64_t m = 0; m < count; ++m) {
+         const char* name = nullptr;
+         if (!(m_Columns[2][m] >= EPS))
+            name = "head_ev";
+         else if (!(m_Columns[3][m] >= EPS))
+            name = "head_sd";
+
+         if (name != nullptr) {
+            std::stringstream invalid;
+            invalid << "Invalid observation " << name << " in record " << m+1 << " of file " << filename << ".";
+            throw InvalidBinaryFile(invalid.str());
+         }
+      }
+   }
+}
+
+int ColumnarFile::Count() const {
+   return m_Count;
+}
+
+const double* ColumnarFile::Column( int c ) const {
+   return m_Columns[c];
+}
+
+std::string ColumnarFile::Id( int m ) const {
+   uint32_t s = m_IdIndex[m];
+   return std::string(m_Strings + m_StringOffsets[s], m_Strings + m_StringOffsets[s+1]);
+}
+
+//=============================================================================
+// is_binary_file
+//
+//    Returns true if the named file starts with the binary columnar magic
+//    string. Any file that cannot be opened is reported as not binary, so
+//    that the text reader produces the usual error message.
+//=============================================================================
+bool is_binary_file( const std::string& filename ) {
+   std::ifstream inpfile( filename, std::ios::binary );
+   char magic[sizeof(MAGIC)];
+
+   if ( !inpfile.read(magic, sizeof(magic)) )
+      return false;
+   return memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+//-----------------------------------------------------------------------------
+void write_obs_binary( const std::string& outfilename, const std::vector<ObsRecord>& obs ) {
+   std::vector<std::string> ids(obs.size());
+   std::vector<double> columns[BINARY_COLUMNS];
+   for (int c = 0; c < BINARY_COLUMNS; ++c)
+      columns[c].resize(obs.size());
+
+   for (std::size_t m = 0; m < obs.size(); ++m) {
+      ids[m]        = obs[m].id;
+      columns[0][m] = obs[m].x;
+      columns[1][m] = obs[m].y;
+      columns[2][m] = obs[m].head_ev;
+      columns[3][m] = obs[m].head_sd;
+   }
+
+   write_columnar(outfilename, BINARY_OBSERVATIONS, ids, columns);
+}
+
+//-----------------------------------------------------------------------------
+void write_well_binary( const std::string& outfilename, const std::vector<WellRecord>& wells ) {
+   std::vector<std::string> ids(wells.size());
+   std::vector<double> columns[BINARY_COLUMNS];
+   for (int c = 0; c < BINARY_COLUMNS; ++c)
+      columns[c].resize(wells.size());
+
+   for (std::size_t n = 0; n < wells.size(); ++n) {
+      ids[n]        = wells[n].id;
+      columns[0][n] = wells[n].x;
+      columns[1][n] = wells[n].y;
+      columns[2][n] = wells[n].r;
+      columns[3][n] = wells[n].q;
+   }
+
+   write_columnar(outfilename, BINARY_WELLS, ids, columns);
+}
+
+//-----------------------------------------------------------------------------
+std::vector<ObsRecord> read_obs_binary( const std::string& inpfilename ) {
+   ColumnarFile file( inpfilename, BINARY_OBSERVATIONS );
+   std::vector<ObsRecord> obs(file.Count());
+
+   for (int m = 0; m < file.Count(); ++m) {
+      obs[m] = ObsRecord{ file.Id(m), file.Column(0)[m], file.Column(1)[m],
+                          file.Column(2)[m], file.Column(3)[m] };
+   }
+   return obs;
+}
+
+//-----------------------------------------------------------------------------
+std::vector<WellRecord> read_well_binary( const std::string& inpfilename ) {
+   ColumnarFile file( inpfilename, BINARY_WELLS );
+   std::vector<WellRecord> wells(file.Count());
+
+   for (int n = 0; n < file.Count(); ++n) {
+      wells[n] = WellRecord{ file.Id(n), file.Column(0)[n], file.Column(1)[n],
+                             file.Column(2)[n], file.Column(3)[n] };
+   }
+   return wells;
+}
@@ -0,0 +1,99 @@
+//=============================================================================
+// binary_data.h
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#ifndef BINARY_DATA_H
+#define BINARY_DATA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "read_data.h"
+
+//-----------------------------------------------------------------------------
+class InvalidBinaryFile : public std::runtime_error {
+   public :
+      InvalidBinaryFile( const std::string& message ) : std::runtime_error(message) {
+      }
+};
+
+//-----------------------------------------------------------------------------
+// The two kinds of record sets stored in the binary columnar format. For
+// observations the four columns are {x, y, head_ev, head_sd}; for wells the
+// four columns are {x, y, r, q}.
+//-----------------------------------------------------------------------------
+enum BinaryKind : uint32_t {
+   BINARY_OBSERVATIONS = 1,
+   BINARY_WELLS        = 2
+};
+
+const int BINARY_COLUMNS = 4;
+
+//-----------------------------------------------------------------------------
+// MappedFile
+//
+//    A read-only memory mapping of an entire file. The mapping is released
+//    when the object is destroyed.
+//-----------------------------------------------------------------------------
+class MappedFile {
+   public:
+      explicit MappedFile( const std::string& filename );
+      ~MappedFile();
+
+      MappedFile( const MappedFile& ) = delete;
+      MappedFile& operator=( const MappedFile& ) = delete;
+
+      const char* Data() const;
+      std::size_t Size() const;
+
+   private:
+      const char* m_Data;
+      std::size_t m_Size;
+      void*       m_Handle;
+};
+
+//-----------------------------------------------------------------------------
+// ColumnarFile
+//
+//    A zero-copy view of a binary columnar observation or well file. The
+//    columns point directly into the memory mapping, so they remain valid
+//    only as long as the ColumnarFile exists.
+//-----------------------------------------------------------------------------
+class ColumnarFile {
+   public:
+      ColumnarFile( const std::string& filename, BinaryKind kind );
+
+      int Count() const;                        // number of records
+      const double* Column( int c ) const;      // 0 <= c < BINARY_COLUMNS
+      std::string Id( int m ) const;            // id of the m'th record
+
+   private:
+      MappedFile      m_File;
+      int             m_Count;
+      const double*   m_Columns[BINARY_COLUMNS];
+      const uint32_t* m_IdIndex;
+      const uint64_t* m_StringOffsets;
+      const char*     m_Strings;
+};
+
+//-----------------------------------------------------------------------------
+bool is_binary_file( const std::string& filename );
+
+void write_obs_binary( const std::string& outfilename, const std::vector<ObsRecord>& obs );
+void write_well_binary( const std::string& outfilename, const std::vector<WellRecord>& wells );
+
+std::vector<ObsRecord> read_obs_binary( const std::string& inpfilename );
+std::vector<WellRecord> read_well_binary( const std::string& inpfilename );
+
+//=============================================================================
+#endif  // BINARY_DATA_H
@@ -0,0 +1,268 @@
+//=============================================================================
+// bootstrap.cpp
+//
+//    Nonparametric (case resampling) bootstrap distributions of the
+//    recharge, magnitude, and direction.
+//
+// notes:
+// o  A bootstrap replicate resamples the M active observations with
+//    replacement, which is the same as giving observation m the weight
+//    c_m w_m, where (c_1, ..., c_M) is a multinomial(M; 1/M, ..., 1/M)
+//    draw. Each replicate is therefore evaluated directly from the weighted
+//    moment sums, sum(c_m w_m x_m x_m') and sum(c_m w_m x_m y_m), over the
+//    observations with c_m > 0; no matrices are rebuilt.
+//
+// o  Replicate r uses numbers r*M, ..., r*M + M-1 of the counter-based
+//    stream "seed" (see counter_rng-inl.h). The replicates can thus be
+//    evaluated in any order, on any number of threads, and the results are
+//    reproducible. Every (k,h) cell uses the same resamples.
+//
+// o  Each replicate is evaluated at its fitted parameters,
+//
+//       recharge  = -2(A + B)
+//       magnitude = sqrt(D^2 + E^2)
+//       direction = atan2(-E, -D)
+//
+//    without the first-order second-moment approximations used by
+//    ComputeGeohydrologyStatistics. The directions are summarized relative
+//    to the all-observation direction, so that the statistics are not upset
+//    by the branch cut at +/- 180 degrees.
+//
+// o  A resample that cannot determine the quadratic model (too few
+//    distinct observations) is discarded.
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#include <algorithm>
+#include <cmath>
+#include <math.h>
+
+#include "bootstrap.h"
+#include "counter_rng-inl.h"
+#include "engine.h"
+#include "normal_equations.h"
+#include "numerical_constants.h"
+#include "parallel_for-inl.h"
+
+//-----------------------------------------------------------------------------
+namespace {
+
+   //--------------------------------------------------------------------------
+   // The descriptors at the given fitted parameters.
+   //--------------------------------------------------------------------------
+   void Descriptors( const Matrix& P, double& recharge, double& magnitude, double& direction ) {
+      recharge  = -2.0*(P(0,0) + P(1,0));
+      magnitude = hypot(P(3,0), P(4,0));
+      direction = std::atan2(-P(4,0), -P(3,0));
+   }
+
+   //--------------------------------------------------------------------------
+   // The p'th quantile of sorted values, interpolated linearly.
+   //--------------------------------------------------------------------------
+   double Percentile( const std::vector<double>& sorted, double p ) {
+      double position = p * (sorted.size() - 1);
+      int below = static_cast<int>(std::floor(position));
+      int above = std::min(below + 1, static_cast<int>(sorted.size()) - 1);
+      return sorted[below] + (position - below)*(sorted[above] - sorted[below]);
+   }
+
+   //--------------------------------------------------------------------------
+   // Summarize a set of values. The values are sorted in place.
+   //--------------------------------------------------------------------------
+   BootstrapStatistic Summarize( std::vector<double>& values ) {
+      BootstrapStatistic s = {0.0, 0.0, 0.0, 0.0};
+      const int n = values.size();
+      if (n == 0)
+         return s;
+
+      double sum = 0.0;
+      for (double v : values)
+         sum += v;
+      s.mean = sum / n;
+
+      double ss = 0.0;
+      for (double v : values)
+         ss += (v - s.mean)*(v - s.mean);
+      s.sd = (n > 1) ? std::sqrt(ss/(n - 1)) : 0.0;
+
+      std::sort(values.begin(), values.end());
+      s.lower = Percentile(values, 0.025);
+      s.upper = Percentile(values, 0.975);
+      return s;
+   }
+}
+
+//=============================================================================
+// Bootstrap
+//
+// Arguments:
+//    rows           the M basis rows, QUADRATIC_TERMS values each.
+//    w, y           the M weights and right-hand-side values.
+//    nreplicates    the number of bootstrap replicates.
+//    seed           the random number stream.
+//    nthreads       the maximum number of threads; see ThreadCount.
+//
+// Returns:
+//    The bootstrap distributions of the three descriptors.
+//=============================================================================
+BootstrapResult Bootstrap(
+   const std::vector<double>& rows,
+   const std::vector<double>& w,
+   const std::vector<double>& y,
+   int nreplicates,
+   uint64_t seed,
+   int nthreads) {
+
+   const int M = w.size();
+   const int n = QUADRATIC_TERMS;
+
+   // The all-observation direction, the reference for the directions.
+   NormalEquations all;
+   for (int m = 0; m < M; ++m)
+      all.Add(&rows[m*n], w[m], y[m]);
+
+   Matrix XtWX, XtWY;
+   all.Assemble(XtWX, XtWY);
+
+   Matrix P_ev, P_cov;
+   std::tie(P_ev, P_cov) = SolveNormalEquations(XtWX, XtWY);
+
+   double r0, m0, d0;
+   Descriptors(P_ev, r0, m0, d0);
+
+   // Evaluate the replicates; NaN marks a discarded replicate.
+   std::vector<double> recharge(nreplicates);
+   std::vector<double> magnitude(nreplicates);
+   std::vector<double> direction(nreplicates);
+
+   ParallelFor(0, nreplicates, nthreads, [&](int r) {
+      std::vector<int> counts(M, 0);
+      for (int draw = 0; draw < M; ++draw) {
+         int m = static_cast<int>( CounterUniform(seed, uint64_t(r)*M + draw) * M );
+         ++counts[std::min(m, M-1)];
+      }
+
+      NormalEquations equations;
+      for (int m = 0; m < M; ++m)
+         if (counts[m] > 0)
+            equations.Add(&rows[m*n], counts[m]*w[m], y[m]);
+
+      Matrix A, b;
+      equations.Assemble(A, b);
+
+      try {
+         Matrix Q_ev, Q_cov;
+         std::tie(Q_ev, Q_cov) = SolveNormalEquations(A, b);
+         Descriptors(Q_ev, recharge[r], magnitude[r], direction[r]);
+         direction[r] = d0 + std::remainder(direction[r] - d0, TWO_PI);
+      }
+      catch (CholeskyDecompositionFailed&) {
+         recharge[r] = magnitude[r] = direction[r] = NAN;
+      }
+   });
+
+   // Drop the discarded replicates, and summarize the rest.
+   auto Kept = [](std::vector<double>& v) {
+      v.erase( std::remove_if(v.begin(), v.end(), [](double x) { return std::isnan(x); }), v.end() );
+   };
+   Kept(recharge);
+   Kept(magnitude);
+   Kept(direction);
+
+   BootstrapResult result;
+   result.replicates = recharge.size();
+   result.recharge   = Summarize(recharge);
+   result.magnitude  = Summarize(magnitude);
+   result.direction  = Summarize(direction);
+   return result;
+}
+
+//=============================================================================
+// BootstrapEngine
+//
+//    Compute the bootstrap distributions in every (k,h) cell, and write them
+//    to "out" as .csv lines
+//
+//       k, h, replicates,
+//       recharge_mean, recharge_sd, recharge_lower, recharge_upper,
+//       magnitude_mean, ..., direction_upper
+//
+//    after a header line. The directions are in degrees.
+//
+// Arguments:
+//    xo, yo         the model origin.
+//    k_alpha, ...   the conductivity and thickness distributions, as in
+//                   Engine.
+//    radius         the well buffer radius.
+//    obs            the observations.
+//    wells          the pumping wells.
+//    nreplicates    the number of bootstrap replicates per cell.
+//    seed           the random number stream.
+//    nthreads       the maximum number of threads; see ThreadCount.
+//    out            the output stream.
+//=============================================================================
+void BootstrapEngine(
+   double xo, double yo,
+   double k_alpha, double k_beta, int k_count,
+   double h_alpha, double h_beta, int h_count,
+   double radius,
+   const ObsTable& obs,
+   const std::vector<WellRecord>& wells,
+   int nreplicates,
+   uint64_t seed,
+   int nthreads,
+   std::ostream& out) {
+
+   const std::vector<int> active = ActiveIndices(obs, wells, radius, false);
+   const int M = active.size();
+   const int n = QUADRATIC_TERMS;
+
+   // The basis rows and the well potentials do not depend on k or h.
+   std::vector<double> rows(M*n);
+   std::vector<double> Phi_wells(M);
+   for (int m = 0; m < M; ++m) {
+      QuadraticBasis(obs.x()[active[m]] - xo, obs.y()[active[m]] - yo, &rows[m*n]);
+      Phi_wells[m] = WellPotential(obs.x()[active[m]], obs.y()[active[m]], wells);
+   }
+
+   std::vector<double> k = SetPoints(k_alpha, k_beta, k_count);
+   std::vector<double> h = SetPoints(h_alpha, h_beta, h_count);
+
+   std::vector<double> w(M);
+   std::vector<double> y(M);
+
+   out << "k,h,replicates,"
+       << "recharge_mean,recharge_sd,recharge_lower,recharge_upper,"
+       << "magnitude_mean,magnitude_sd,magnitude_lower,magnitude_upper,"
+       << "direction_mean,direction_sd,direction_lower,direction_upper\n";
+   out.precision(17);
+
+   auto Write = [&out]( const BootstrapStatistic& s, double scale ) {
+      out << ',' << scale*s.mean << ',' << scale*s.sd << ',' << scale*s.lower << ',' << scale*s.upper;
+   };
+
+   for (int i = 0; i < k_count; ++i) {
+      for (int j = 0; j < h_count; ++j) {
+         for (int m = 0; m < M; ++m) {
+            double Phi_ev, Phi_sd;
+            DischargePotential(obs.head_ev()[active[m]], obs.head_sd()[active[m]], k[i], h[j], Phi_ev, Phi_sd);
+            w[m] = 1.0/(Phi_sd*Phi_sd);
+            y[m] = Phi_ev - Phi_wells[m];
+         }
+
+         BootstrapResult result = Bootstrap(rows, w, y, nreplicates, seed, nthreads);
+
+         out << k[i] << ',' << h[j] << ',' << result.replicates;
+         Write(result.recharge, 1.0);
+         Write(result.magnitude, 1.0);
+         Write(result.direction, RAD_TO_DEG);
+         out << '\n';
+      }
+   }
+}
@@ -0,0 +1,64 @@
+//=============================================================================
+// bootstrap.h
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#ifndef BOOTSTRAP_H
+#define BOOTSTRAP_H
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "obs_table.h"
+#include "read_data.h"
+
+//-----------------------------------------------------------------------------
+// The bootstrap distribution of one hydrogeologic descriptor: its mean,
+// standard deviation, and the 2.5 and 97.5 percentiles.
+//-----------------------------------------------------------------------------
+struct BootstrapStatistic {
+   double mean;
+   double sd;
+   double lower;
+   double upper;
+};
+
+struct BootstrapResult {
+   int replicates;               // the number that could be fit
+   BootstrapStatistic recharge;
+   BootstrapStatistic magnitude;
+   BootstrapStatistic direction; // [radians]
+};
+
+//-----------------------------------------------------------------------------
+BootstrapResult Bootstrap(
+   const std::vector<double>& rows,
+   const std::vector<double>& w,
+   const std::vector<double>& y,
+   int nreplicates,
+   uint64_t seed,
+   int nthreads
+);
+
+void BootstrapEngine(
+   double xo, double yo,
+   double k_alpha, double k_beta, int k_count,
+   double h_alpha, double h_beta, int h_count,
+   double radius,
+   const ObsTable& obs,
+   const std::vector<WellRecord>& wells,
+   int nreplicates,
+   uint64_t seed,
+   int nthreads,
+   std::ostream& out
+);
+
+//=============================================================================
+#endif  // BOOTSTRAP_H
@@ -0,0 +1,290 @@
+//=============================================================================
+// correlated_errors.cpp
+//
+//    Fit the quadratic model with correlated observation errors: errors
+//    shared by every observation of a survey datum, a sampling campaign, or
+//    a season, in addition to the independent error of each observation.
+//
+// notes:
+// o  The observation covariance matrix is diagonal plus low rank,
+//
+//       V = D + U U'
+//
+//    where D = diag(Phi_sd^2) holds the independent errors, and each of the
+//    r columns of the sparse (M x r) U holds the loadings of the
+//    observations on one shared, unit variance, error factor. In discharge
+//    potential units, a loading is DischargePotentialSlope times the head
+//    standard deviation from the factor file.
+//
+// o  By the Woodbury identity, with W = inv(D),
+//
+//       inv(V) = W - W U inv(C) U'W,    C = I + U'W U,
+//
+//    so, with the Cholesky decomposition C = LL' and Z = inv(L) [U'WX, U'Wy],
+//
+//       X'inv(V)X = X'WX - Z'Z
+//       X'inv(V)y = X'Wy - Z'z.
+//
+//    The cost is O(M) for the sums plus O(r^3) for C; neither V nor its
+//    inverse is ever formed.
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <unordered_map>
+
+#include "correlated_errors.h"
+#include "engine.h"
+#include "linear_systems.h"
+#include "normal_equations.h"
+#include "preprocess.h"
+
+//=============================================================================
+// BuildErrorFactors
+//
+//    Index the factor records by observation and by factor. The factors are
+//    numbered in order of first appearance.
+//
+// Notes:
+// o  Throws InvalidFactorRecord if a record names an observation that is
+//    not in the table, or whose ID is shared by more than one observation.
+//    Observation IDs need not be unique otherwise.
+//=============================================================================
+ErrorFactors BuildErrorFactors(
+   const ObsTable& obs,
+   const std::vector<FactorRecord>& records) {
+
+   // A repeated ID maps to -1.
+   std::unordered_map<std::string, int> obs_index;
+   for (int m = 0; m < obs.size(); ++m) {
+      auto inserted = obs_index.insert(std::make_pair(obs.id(m), m));
+      if (!inserted.second)
+         inserted.first->second = -1;
+   }
+
+   std::map<std::string, int> factor_index;
+
+   ErrorFactors factors;
+   for (const FactorRecord& record : records) {
+      auto found = obs_index.find(record.obs_id);
+      if (found == obs_index.end()) {
+         std::stringstream message;
+         message << "The factor data refer to an unknown observation, " << record.obs_id << ".";
+         throw InvalidFactorRecord(message.str());
+      }
+      if (found->second < 0) {
+         std::stringstream message;
+         message << "The factor data refer to an observation ID that is not unique, " << record.obs_id << ".";
+         throw InvalidFactorRecord(message.str());
+      }
+
+      auto inserted = factor_index.insert(std::make_pair(record.factor_id, static_cast<int>(factors.names.size())));
+      if (inserted.second)
+         factors.names.push_back(record.factor_id);
+
+      factors.loadings.push_back( FactorLoading{found->second, inserted.first->second, record.head_sd} );
+   }
+
+   return factors;
+}
+
+//=============================================================================
+// FitCorrelatedModel
+//
+// Arguments:
+//    rows           the M basis rows, QUADRATIC_TERMS values each.
+//    w, y           the M inverse variances of the independent errors, and
+//                   the right-hand-side values.
+//    loadings       the nonzero loadings, with "obs" indexing the rows, in
+//                   discharge potential units.
+//    nfactors       the number of factors, r.
+//    nthreads       the maximum number of threads for the r x r system;
+//                   see ThreadCount.
+//
+// Returns:
+//    The generalized least squares P_ev and P_cov, as SolveNormalEquations.
+//=============================================================================
+std::tuple<Matrix, Matrix> FitCorrelatedModel(
+   const std::vector<double>& rows,
+   const std::vector<double>& w,
+   const std::vector<double>& y,
+   const std::vector<FactorLoading>& loadings,
+   int nfactors,
+   int nthreads) {
+
+   const int M = w.size();
+   const int n = QUADRATIC_TERMS;
+
+   // The independent error sums, X'WX and X'Wy.
+   NormalEquations equations;
+   for (int m = 0; m < M; ++m)
+      equations.Add(&rows[m*n], w[m], y[m]);
+
+   Matrix XtWX, XtWY;
+   equations.Assemble(XtWX, XtWY);
+
+   if (nfactors == 0)
+      return SolveNormalEquations(XtWX, XtWY);
+
+   // C = I + U'WU, and F = [U'WX, U'Wy]. The loadings are visited one
+   // observation at a time, so that U'WU picks up every pair of factors
+   // sharing an observation.
+   std::vector<FactorLoading> sorted(loadings);
+   std::stable_sort(sorted.begin(), sorted.end(),
+      [](const FactorLoading& a, const FactorLoading& b) { return a.obs < b.obs; });
+
+   Matrix C;
+   Identity(C, nfactors);
+   Matrix F(nfactors, n+1, 0.0);
+
+   for (size_t first = 0; first < sorted.size(); ) {
+      size_t last = first;
+      while (last < sorted.size() && sorted[last].obs == sorted[first].obs)
+         ++last;
+
+      const int m = sorted[first].obs;
+      const double* x = &rows[m*n];
+
+      for (size_t a = first; a < last; ++a) {
+         const double wu = w[m] * sorted[a].value;
+         double* f = F.Base(sorted[a].factor, 0);
+         for (int t = 0; t < n; ++t)
+            f[t] += wu * x[t];
+         f[n] += wu * y[m];
+
+         for (size_t b = first; b < last; ++b)
+            C(sorted[a].factor, sorted[b].factor) += wu * sorted[b].value;
+      }
+      first = last;
+   }
+
+   // Z = inv(L) F, and the Woodbury corrections Z'Z.
+   if (!CholeskyFactor(C, nthreads)) {
+      std::stringstream message;
+      message << "Cholesky Decomposition failed." << std::endl;
+      throw CholeskyDecompositionFailed(message.str());
+   }
+   TriangularSolve(C, F, false, nthreads);
+
+   Matrix ZtZ;
+   Multiply_MtM(F, F, ZtZ);
+
+   for (int i = 0; i < n; ++i) {
+      for (int j = 0; j < n; ++j)
+         XtWX(i,j) -= ZtZ(i,j);
+      XtWY(i,0) -= ZtZ(i,n);
+   }
+
+   return SolveNormalEquations(XtWX, XtWY);
+}
+
+//=============================================================================
+// CorrelatedEngine
+//
+//    As Engine, with the shared error factors added to the observation
+//    covariance.
+//
+// Arguments:
+//    xo, yo         the model origin.
+//    k_alpha, ...   the conductivity and thickness distributions, as in
+//                   Engine.
+//    radius         the well buffer radius.
+//    obs            the observations.
+//    wells          the pumping wells.
+//    factors        the shared error factors.
+//    nthreads       the maximum number of threads; see ThreadCount.
+//    sink           receives each row of results as soon as it is complete.
+//=============================================================================
+void CorrelatedEngine(
+   double xo, double yo,
+   double k_alpha, double k_beta, int k_count,
+   double h_alpha, double h_beta, int h_count,
+   double radius,
+   const ObsTable& obs,
+   const std::vector<WellRecord>& wells,
+   const ErrorFactors& factors,
+   int nthreads,
+   ResultSink& sink) {
+
+   // Manifest constants.
+   const int MINIMUM_COUNT = 10; // At least this many unique observation locations.
+
+   const std::vector<int> active = ActiveIndices(obs, wells, radius, true);
+
+   int Mactive = active.size();
+   int Munique = CountUniqueLocations(obs, active);
+   if (Munique < MINIMUM_COUNT) {
+      std::stringstream message;
+      message << "Too few unique active observation locations: " << Munique << " < " << MINIMUM_COUNT << std::endl;
+      throw TooFewObservations(message.str());
+   }
+   std::cout << Mactive << " active observation data records at " << Munique << " unique locations." << std::endl;
+
+   const int M = Mactive;
+   const int n = QUADRATIC_TERMS;
+
+   // The basis rows and the well potentials do not depend on k or h.
+   std::vector<double> rows(M*n);
+   std::vector<double> Phi_wells(M);
+   for (int m = 0; m < M; ++m) {
+      QuadraticBasis(obs.x()[active[m]] - xo, obs.y()[active[m]] - yo, &rows[m*n]);
+      Phi_wells[m] = WellPotential(obs.x()[active[m]], obs.y()[active[m]], wells);
+   }
+
+   // Keep the loadings of the active observations, indexed by row.
+   std::vector<int> position(obs.size(), -1);
+   for (int m = 0; m < M; ++m)
+      position[active[m]] = m;
+
+   std::vector<FactorLoading> loadings;
+   std::vector<double> head_sd;
+   for (const FactorLoading& loading : factors.loadings) {
+      if (position[loading.obs] >= 0) {
+         loadings.push_back( FactorLoading{position[loading.obs], loading.factor, 0.0} );
+         head_sd.push_back(loading.value);
+      }
+   }
+   std::cout << loadings.size() << " factor loadings on " << factors.names.size() << " shared error factors." << std::endl;
+
+   std::vector<double> k = SetPoints(k_alpha, k_beta, k_count);
+   std::vector<double> h = SetPoints(h_alpha, h_beta, h_count);
+
+   sink.Begin(k, h);
+
+   std::vector<double> w(M);
+   std::vector<double> y(M);
+   std::vector<CellResult> row(h_count);
+
+   for (int i = 0; i < k_count; ++i) {
+      for (int j = 0; j < h_count; ++j) {
+         for (int m = 0; m < M; ++m) {
+            double Phi_ev, Phi_sd;
+            DischargePotential(obs.head_ev()[active[m]], obs.head_sd()[active[m]], k[i], h[j], Phi_ev, Phi_sd);
+            w[m] = 1.0/(Phi_sd*Phi_sd);
+            y[m] = Phi_ev - Phi_wells[m];
+         }
+
+         for (size_t l = 0; l < loadings.size(); ++l) {
+            const double head_ev = obs.head_ev()[active[loadings[l].obs]];
+            loadings[l].value = DischargePotentialSlope(head_ev, k[i], h[j]) * head_sd[l];
+         }
+
+         Matrix P_ev, P_cov;
+         std::tie(P_ev, P_cov) = FitCorrelatedModel(rows, w, y, loadings, factors.names.size(), nthreads);
+
+         row[j] = ComputeCellResult(P_ev, P_cov);
+      }
+      sink.Row(i, row);
+   }
+
+   sink.End();
+}
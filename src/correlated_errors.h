@@ -0,0 +1,70 @@
+//=============================================================================
+// correlated_errors.h
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#ifndef CORRELATED_ERRORS_H
+#define CORRELATED_ERRORS_H
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "matrix.h"
+#include "obs_table.h"
+#include "read_data.h"
+#include "result_sink.h"
+
+//-----------------------------------------------------------------------------
+// One nonzero of the (M x r) factor loading matrix U.
+//-----------------------------------------------------------------------------
+struct FactorLoading {
+   int    obs;         // the observation (row)
+   int    factor;      // the factor (column)
+   double value;       // the loading
+};
+
+//-----------------------------------------------------------------------------
+// The shared error factors, with the observations indexed into an ObsTable
+// and the loadings in head units [L].
+//-----------------------------------------------------------------------------
+struct ErrorFactors {
+   std::vector<std::string>   names;
+   std::vector<FactorLoading> loadings;
+};
+
+ErrorFactors BuildErrorFactors(
+   const ObsTable& obs,
+   const std::vector<FactorRecord>& records
+);
+
+//-----------------------------------------------------------------------------
+std::tuple<Matrix, Matrix> FitCorrelatedModel(
+   const std::vector<double>& rows,
+   const std::vector<double>& w,
+   const std::vector<double>& y,
+   const std::vector<FactorLoading>& loadings,
+   int nfactors,
+   int nthreads
+);
+
+void CorrelatedEngine(
+   double xo, double yo,
+   double k_alpha, double k_beta, int k_count,
+   double h_alpha, double h_beta, int h_count,
+   double radius,
+   const ObsTable& obs,
+   const std::vector<WellRecord>& wells,
+   const ErrorFactors& factors,
+   int nthreads,
+   ResultSink& sink
+);
+
+//=============================================================================
+#endif  // CORRELATED_ERRORS_H
@@ -0,0 +1,56 @@
+//=============================================================================
+// counter_rng-inl.h
+//
+//    A counter-based pseudo-random number generator.
+//
+// notes:
+// o  The n'th number of stream "key" is a pure function of (key, n): the
+//    SplitMix64 finalizer applied twice. There is no generator state to
+//    share or to advance, so any thread can compute any number of any
+//    stream, and the results do not depend on how the work is divided.
+//
+//       Steele, G. L., D. Lea, and C. H. Flood, 2014, Fast splittable
+//       pseudorandom number generators, OOPSLA 2014, pp. 453-472.
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#ifndef COUNTER_RNG_H
+#define COUNTER_RNG_H
+
+#include <cstdint>
+
+//-----------------------------------------------------------------------------
+// The SplitMix64 output function.
+//-----------------------------------------------------------------------------
+inline uint64_t SplitMix64( uint64_t z )
+{
+   z += 0x9E3779B97F4A7C15u;
+   z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9u;
+   z = (z ^ (z >> 27)) * 0x94D049BB133111EBu;
+   return z ^ (z >> 31);
+}
+
+//-----------------------------------------------------------------------------
+// The n'th 64-bit number of stream "key".
+//-----------------------------------------------------------------------------
+inline uint64_t CounterRandom( uint64_t key, uint64_t n )
+{
+   return SplitMix64( SplitMix64(key) ^ n );
+}
+
+//-----------------------------------------------------------------------------
+// The n'th number of stream "key", uniform on [0,1).
+//-----------------------------------------------------------------------------
+inline double CounterUniform( uint64_t key, uint64_t n )
+{
+   return (CounterRandom(key, n) >> 11) * (1.0/9007199254740992.0);
+}
+
+//=============================================================================
+#endif  // COUNTER_RNG_H
@@ -1,8 +1,11 @@
 //=============================================================================
 // engine.cpp
 //
-//    Compute the boomerang statistic for each measured location using the
-//    conic/quadratic groundwater model.
+//    Fit the conic/quadratic discharge potential model at every (k,h) set
+//    point, and compute the recharge, flow magnitude, and flow direction at
+//    the origin, with their standard deviations. The boomerang statistic
+//    for each measured location is computed by LeaveOneOut, in
+//    leave_one_out.cpp.
 //
 // author:
 //    Dr. Randal J. Barnes
@@ -12,8 +15,10 @@
 // version:
 //    30 June 2017
 //=============================================================================
+#include <algorithm>
 #include <cassert>
 #include <iomanip>
+#include <limits>
 #include <math.h>
 #include <numeric>
 #include <sstream>
@@ -21,6 +26,7 @@
 #include "engine.h"
 #include "linear_systems.h"
 #include "numerical_constants.h"
+#include "preprocess.h"
 #include "special_functions.h"
 
 //=============================================================================
@@ -32,7 +38,10 @@ Results::Results() :
    M_ev(),
    M_sd(),
    D_ev(),
-   D_sd() {
+   D_sd(),
+   WRSS(),
+   ChiSq(),
+   LogLik() {
 }
 
 Results::Results( int k_count, int h_count ) :
@@ -43,53 +52,146 @@ Results::Results( int k_count, int h_count ) :
    M_ev(k_count, h_count),
    M_sd(k_count, h_count),
    D_ev(k_count, h_count),
-   D_sd(k_count, h_count) {
+   D_sd(k_count, h_count),
+   WRSS(k_count, h_count),
+   ChiSq(k_count, h_count),
+   LogLik(k_count, h_count) {
+}
+
+//=============================================================================
+MemoryResultSink::MemoryResultSink( Results& results )
+:  m_Results( results ) {
+}
+
+void MemoryResultSink::Begin( const std::vector<double>& k, const std::vector<double>& h ) {
+   m_Results = Results(k.size(), h.size());
+   m_Results.k = k;
+   m_Results.h = h;
+}
+
+void MemoryResultSink::Row( int i, const std::vector<CellResult>& row ) {
+   for (int j = 0; j < static_cast<int>(row.size()); ++j) {
+      m_Results.R_ev(i,j) = row[j].r_ev;
+      m_Results.R_sd(i,j) = row[j].r_sd;
+
+      m_Results.M_ev(i,j) = row[j].m_ev;
+      m_Results.M_sd(i,j) = row[j].m_sd;
+
+      m_Results.D_ev(i,j) = row[j].d_ev;
+      m_Results.D_sd(i,j) = row[j].d_sd;
+
+      m_Results.WRSS(i,j)   = row[j].wrss;
+      m_Results.ChiSq(i,j)  = row[j].reduced_chisq;
+      m_Results.LogLik(i,j) = row[j].loglik;
+   }
+}
+
+void MemoryResultSink::End() {
+}
+
+//=============================================================================
+// DischargePotential
+//
+//    Use a first-order second moment approximation to compute the expected
+//    value and the standard deviation of the discharge potential at an
+//    observation location from the given expected value and standard
+//    deviation of the piezometric head.
+//=============================================================================
+void DischargePotential(
+   double head_ev, double head_sd,
+   double conductivity, double thickness,
+   double& Phi_ev, double& Phi_sd) {
+   if (head_ev < thickness) {
+      Phi_ev = 0.5*conductivity * (head_ev*head_ev + head_sd*head_sd);
+      Phi_sd = conductivity * head_ev * head_sd;
+   } else {
+      Phi_ev = conductivity * thickness * (head_ev - 0.5*thickness);
+      Phi_sd = conductivity * thickness * head_sd;
+   }
+}
+
+//=============================================================================
+// HeadLogSdSum
+//
+//    The sum of log(head_sd) over the observations selected by the index
+//    view "active"; see SetGoodnessOfFit.
+//=============================================================================
+double HeadLogSdSum( const ObsTable& obs, const std::vector<int>& active ) {
+   double sum = 0.0;
+   for (int m : active)
+      sum += std::log(obs.head_sd()[m]);
+   return sum;
+}
+
+//=============================================================================
+// DischargePotentialSlope
+//
+//    The derivative of the discharge potential with respect to the head at
+//    the expected head: the factor that converts a head error into a
+//    discharge potential error, as in DischargePotential.
+//=============================================================================
+double DischargePotentialSlope( double head_ev, double conductivity, double thickness ) {
+   if (head_ev < thickness)
+      return conductivity * head_ev;
+   else
+      return conductivity * thickness;
+}
+
+//=============================================================================
+// WellPotential
+//
+//    Compute the contribution to the discharge potential at (x,y) due to all
+//    of the pumping wells combined.
+//=============================================================================
+double WellPotential( double x, double y, const std::vector<WellRecord>& wells ) {
+   double Phi = 0.0;
+   for (const WellRecord& well : wells) {
+      double separation_distance = hypot(x-well.x, y-well.y);
+      if (separation_distance >= well.r)
+         Phi += well.q/TWO_PI * std::log(separation_distance);
+      else
+         Phi += well.q/TWO_PI * std::log(well.r);
+   }
+   return Phi;
 }
 
 //=============================================================================
 // SetupQuadraticModel
+//
+//    Setup the regression matrix (X), the inverse of the observation variance
+//    matrix (Vinv), and the right-hand-side matrix (Y) using only the
+//    observations selected by the index view "active".
 //=============================================================================
 std::tuple<Matrix, Matrix, Matrix> SetupQuadraticModel(
    double xo,
    double yo,
    double conductivity,
    double thickness,
-   std::vector<ObsRecord> obs,
-   std::vector<WellRecord> wells) {
-   const int M = obs.size();     // number of observations
-   const int N = wells.size();   // number of pumping wells
+   const ObsTable& obs,
+   const std::vector<int>& active,
+   const std::vector<WellRecord>& wells) {
+   const int M = active.size();  // number of observations
+
+   const double* obs_x       = obs.x();
+   const double* obs_y       = obs.y();
+   const double* obs_head_ev = obs.head_ev();
+   const double* obs_head_sd = obs.head_sd();
 
    // Setup the regression matrix (X) for the quadratic discharge
    // potential model.
-   Matrix X(M,6);
+   Matrix X(M,QUADRATIC_TERMS);
 
    for (int m = 0; m < M; ++m) {
-      double dx = obs[m].x - xo;
-      double dy = obs[m].y - yo;
-
-      X(m,0) = dx*dx;
-      X(m,1) = dy*dy;
-      X(m,2) = dx*dy;
-      X(m,3) = dx;
-      X(m,4) = dy;
-      X(m,5) = 1;
+      QuadraticBasis(obs_x[active[m]] - xo, obs_y[active[m]] - yo, X.Base(m,0));
    }
 
-   // Use a first-order second moment approximation to compute the expected
-   // values and the standard deviations of the discharge potentials at the
-   // observation locations from the given expected values and standard
-   // deviations of the piezometric heads.
+   // Compute the expected values and the standard deviations of the
+   // discharge potentials at the observation locations.
    std::vector<double> Phi_ev(M);
    std::vector<double> Phi_sd(M);
 
    for (int m = 0; m < M; ++m) {
-      if (obs[m].head_ev < thickness) {
-         Phi_ev[m] = 0.5*conductivity * (obs[m].head_ev*obs[m].head_ev + obs[m].head_sd*obs[m].head_sd);
-         Phi_sd[m] = conductivity * obs[m].head_ev * obs[m].head_sd;
-      } else {
-         Phi_ev[m] = conductivity * thickness * (obs[m].head_ev - 0.5*thickness);
-         Phi_sd[m] = conductivity * thickness * obs[m].head_sd;
-      }
+      DischargePotential(obs_head_ev[active[m]], obs_head_sd[active[m]], conductivity, thickness, Phi_ev[m], Phi_sd[m]);
    }
 
    // Setup the the inverse of the observation variance matrix (Vinv).
@@ -106,27 +208,75 @@ std::tuple<Matrix, Matrix, Matrix> SetupQuadraticModel(
    std::vector<double> Phi_wells(M);
 
    for (int m = 0; m < M; ++m) {
-      Phi_wells[m] = 0.0;
-      for (int n = 0; n < N; ++n) {
-         double separation_distance = hypot(obs[m].x-wells[n].x, obs[m].y-wells[n].y);
-         if (separation_distance >= wells[n].r)
-            Phi_wells[m] += wells[n].q/TWO_PI * std::log(separation_distance);
-         else
-            Phi_wells[m] += wells[n].q/TWO_PI * std::log(wells[n].r);
-      }
+      Phi_wells[m] = WellPotential(obs_x[active[m]], obs_y[active[m]], wells);
    }
 
    // Setup the right-hand-side matrix (Y).
    Matrix Y(M,1);
 
    for (int m = 0; m < M; ++m) {
-      for ( int n = 0; n < N; ++n)
-         Y(m,0) = Phi_ev[m] - Phi_wells[m];
+      Y(m,0) = Phi_ev[m] - Phi_wells[m];
    }
 
    return std::make_tuple(X, Vinv, Y);
 }
 
+//-----------------------------------------------------------------------------
+std::tuple<Matrix, Matrix, Matrix> SetupQuadraticModel(
+   double xo,
+   double yo,
+   double conductivity,
+   double thickness,
+   const std::vector<ObsRecord>& obs,
+   const std::vector<WellRecord>& wells) {
+   ObsTable table(obs);
+   return SetupQuadraticModel(xo, yo, conductivity, thickness, table, AllIndices(table), wells);
+}
+
+
+//=============================================================================
+// SetupWeightedModel
+//
+//    Setup the weighted regression matrix for the active observations,
+//
+//       Z = [ sqrt(w) X, sqrt(w) Y ]
+//
+//    where w = 1/Phi_sd^2 is the inverse variance of each observation, so
+//    that Z'Z = [X'WX, X'WY; Y'WX, Y'WY]. Neither the (M x M) inverse
+//    variance matrix nor X'WX is formed.
+//=============================================================================
+Matrix SetupWeightedModel(
+   double xo,
+   double yo,
+   double conductivity,
+   double thickness,
+   const ObsTable& obs,
+   const std::vector<int>& active,
+   const std::vector<WellRecord>& wells) {
+   const int M = active.size();  // number of observations
+
+   const double* obs_x       = obs.x();
+   const double* obs_y       = obs.y();
+   const double* obs_head_ev = obs.head_ev();
+   const double* obs_head_sd = obs.head_sd();
+
+   Matrix Z(M, QUADRATIC_TERMS+1);
+
+   for (int m = 0; m < M; ++m) {
+      double Phi_ev, Phi_sd;
+      DischargePotential(obs_head_ev[active[m]], obs_head_sd[active[m]], conductivity, thickness, Phi_ev, Phi_sd);
+
+      double* z = Z.Base(m,0);
+      QuadraticBasis(obs_x[active[m]] - xo, obs_y[active[m]] - yo, z);
+      z[QUADRATIC_TERMS] = Phi_ev - WellPotential(obs_x[active[m]], obs_y[active[m]], wells);
+
+      for (int t = 0; t <= QUADRATIC_TERMS; ++t)
+         z[t] /= Phi_sd;
+   }
+
+   return Z;
+}
+
 
 //=============================================================================
 // FitQuadraticModel
@@ -139,6 +289,19 @@ std::tuple<Matrix, Matrix> FitQuadraticModel(
    const Matrix& X,
    const Matrix& Vinv,
    const Matrix& Y ) {
+   double wrss;
+   return FitQuadraticModel(X, Vinv, Y, wrss);
+}
+
+//-----------------------------------------------------------------------------
+// As above, and also computes the weighted residual sum of squares, wrss,
+// from Y'inv(V)Y and X'inv(V)Y; see WeightedResidualSumOfSquares.
+//-----------------------------------------------------------------------------
+std::tuple<Matrix, Matrix> FitQuadraticModel(
+   const Matrix& X,
+   const Matrix& Vinv,
+   const Matrix& Y,
+   double& wrss ) {
 
    Matrix VinvX;
    Multiply_MM(Vinv, X, VinvX);
@@ -152,15 +315,104 @@ std::tuple<Matrix, Matrix> FitQuadraticModel(
    Matrix XtVinvY;
    Multiply_MtM(X, VinvY, XtVinvY);
 
+   Matrix YtVinvY;
+   Multiply_MtM(Y, VinvY, YtVinvY);
+
+   Matrix P_ev, P_cov;
+   std::tie(P_ev, P_cov) = SolveNormalEquations(XtVinvX, XtVinvY);
+
+   wrss = WeightedResidualSumOfSquares(YtVinvY(0,0), XtVinvY, P_ev);
+   return std::make_tuple(P_ev, P_cov);
+}
+
+
+//=============================================================================
+// FitWeightedModelQR
+//
+// Computes the same fit as FitQuadraticModel from the weighted regression
+// matrix Z of SetupWeightedModel, by a QR factorization, Z = QR, instead of
+// the normal equations. With the augmented triangular factor
+//
+//    R = [ U, z ]
+//        [ 0, r ]
+//
+// U'U = X'WX, so P_ev = inv(U) z and P_cov = inv(U) inv(U)'.
+//=============================================================================
+std::tuple<Matrix, Matrix> FitWeightedModelQR(
+   const Matrix& Z,
+   int nthreads ) {
+   double wrss;
+   return FitWeightedModelQR(Z, nthreads, wrss);
+}
+
+//-----------------------------------------------------------------------------
+// As above, and also returns the weighted residual sum of squares, which is
+// r^2, with no cancellation.
+//-----------------------------------------------------------------------------
+std::tuple<Matrix, Matrix> FitWeightedModelQR(
+   const Matrix& Z,
+   int nthreads,
+   double& wrss ) {
+
+   const int n = QUADRATIC_TERMS;
+
+   Matrix R;
+   TsqrFactor(Z, nthreads, R);
+
+   double largest = 0.0;
+   for (int i = 0; i < n; ++i)
+      largest = std::max(largest, fabs(R(i,i)));
+
+   // Invert U by back substitution, one column at a time.
+   Matrix Uinv(n, n, 0.0);
+   for (int c = 0; c < n; ++c) {
+      for (int i = c; i >= 0; --i) {
+         if (!(fabs(R(i,i)) > EPS*largest)) {
+            std::stringstream message;
+            message << "QR factorization failed; the regression matrix is rank deficient." << std::endl;
+            throw QRFactorizationFailed(message.str());
+         }
+
+         double sum = (i == c) ? 1.0 : 0.0;
+         for (int j = i+1; j <= c; ++j)
+            sum -= R(i,j) * Uinv(j,c);
+         Uinv(i,c) = sum / R(i,i);
+      }
+   }
+
+   Matrix P_ev(n, 1, 0.0);
+   for (int i = 0; i < n; ++i)
+      for (int j = i; j < n; ++j)
+         P_ev(i,0) += Uinv(i,j) * R(j,n);
+
+   Matrix P_cov;
+   Multiply_MMt(Uinv, Uinv, P_cov);
+
+   wrss = R(n,n) * R(n,n);
+   return std::make_tuple(P_ev, P_cov);
+}
+
+
+//=============================================================================
+// SolveNormalEquations
+//
+// Solves the weighted least squares normal equations, (X'WX) P = X'Wy, for
+// the expected values of the model parameters, P_ev, and computes their
+// covariance matrix, P_cov = inv(X'WX).
+//=============================================================================
+std::tuple<Matrix, Matrix> SolveNormalEquations(
+   const Matrix& XtWX,
+   const Matrix& XtWY ) {
+
    Matrix L;
-   if (!CholeskyDecomposition(XtVinvX, L)) {
+   if (!CholeskyDecomposition(XtWX, L)) {
       std::stringstream message;
       message << "Cholesky Decomposition failed." << std::endl;
       throw CholeskyDecompositionFailed(message.str());
    }
 
    Matrix P_ev;
-   CholeskySolve(L, XtVinvY, P_ev);
+   CholeskySolve(L, XtWY, P_ev);
 
    Matrix P_cov;
    CholeskyInverse(L, P_cov);
@@ -185,19 +437,37 @@ std::tuple<double, double, double, double, double, double>
 ComputeGeohydrologyStatistics(
    const Matrix& P_ev,
    const Matrix& P_cov) {
+   typedef PolynomialModel<2> Model;
+   return ComputeGeohydrologyStatistics(P_ev, P_cov, Model::XX, Model::YY, Model::X, Model::Y);
+}
+
+//-----------------------------------------------------------------------------
+// As above, for a polynomial model of any order, given the positions of the
+// dx^2, dy^2, dx, and dy coefficients in P_ev. The recharge at the origin
+// depends only on the second degree terms, and the flow only on the first
+// degree terms. A linear model has no second degree terms (xx and yy are
+// -1), and so no recharge.
+//-----------------------------------------------------------------------------
+std::tuple<double, double, double, double, double, double>
+ComputeGeohydrologyStatistics(
+   const Matrix& P_ev,
+   const Matrix& P_cov,
+   int xx, int yy, int x, int y) {
 
    // To simplify the notation, we extract and rename the necessary components.
-   double EA  = P_ev(0,0);
-   double EB  = P_ev(1,0);
-   double VA  = P_cov(0,0);
-   double VB  = P_cov(1,1);
-   double CAB = P_cov(0,1);
-
-   double EQx   = -P_ev(3,0);
-   double EQy   = -P_ev(4,0);
-   double VQx   = P_cov(3,3);
-   double VQy   = P_cov(4,4);
-   double CQxQy = P_cov(3,4);
+   const bool curved = (xx >= 0 && yy >= 0);
+
+   double EA  = curved ? P_ev(xx,0) : 0.0;
+   double EB  = curved ? P_ev(yy,0) : 0.0;
+   double VA  = curved ? P_cov(xx,xx) : 0.0;
+   double VB  = curved ? P_cov(yy,yy) : 0.0;
+   double CAB = curved ? P_cov(xx,yy) : 0.0;
+
+   double EQx   = -P_ev(x,0);
+   double EQy   = -P_ev(y,0);
+   double VQx   = P_cov(x,x);
+   double VQy   = P_cov(y,y);
+   double CQxQy = P_cov(x,y);
 
    // To simplify the notation, we define intermediate variables {S,T,U}, and
    // we compute the various necessary partial derivatives.
@@ -219,7 +489,7 @@ ComputeGeohydrologyStatistics(
    double d2UdQxdQy = ( EQy*EQy - EQx*EQx ) / (S*S);
 
    // Compute the statistics for the recharge.
-   double r_ev = -2.0*(EA + EB);
+   double r_ev = curved ? -2.0*(EA + EB) : 0.0;
    double r_va = 4.0*(VA + VB + 2*CAB);
    double r_sd = std::sqrt( std::max(r_va, EPS));
 
@@ -236,6 +506,124 @@ ComputeGeohydrologyStatistics(
    return std::make_tuple(r_ev, r_sd, m_ev, m_sd, d_ev, d_sd);
 }
 
+//-----------------------------------------------------------------------------
+CellResult ComputeCellResult( const Matrix& P_ev, const Matrix& P_cov ) {
+   CellResult cell;
+   std::tie(cell.r_ev, cell.r_sd, cell.m_ev, cell.m_sd, cell.d_ev, cell.d_sd) =
+      ComputeGeohydrologyStatistics(P_ev, P_cov);
+   return cell;
+}
+
+
+//=============================================================================
+// WeightedResidualSumOfSquares
+//
+// Computes (y - XP)'W(y - XP) for the weighted least squares solution P_ev
+// from the sufficient statistics, y'Wy and X'Wy. Since X'WX P_ev = X'Wy,
+//
+//    wrss = y'Wy - P_ev'X'Wy,
+//
+// which needs neither the observations nor the residuals. The difference
+// can lose digits to cancellation when the fit is very good, so it is
+// bounded below by zero.
+//=============================================================================
+double WeightedResidualSumOfSquares(
+   double yWy,
+   const Matrix& XtWY,
+   const Matrix& P_ev ) {
+   double fitted = 0.0;
+   for (int t = 0; t < P_ev.nRows(); ++t)
+      fitted += P_ev(t,0) * XtWY(t,0);
+   return std::max(yWy - fitted, 0.0);
+}
+
+
+//=============================================================================
+// SetGoodnessOfFit
+//
+// Sets the goodness of fit of the model in "cell" from the weighted residual
+// sum of squares, wrss, of a fit of "terms" parameters to "count"
+// observations, with log_head_sd = sum(log(head_sd)); see HeadLogSdSum.
+//
+//    reduced_chisq = wrss / (count - terms)
+//    loglik        = -(wrss + count log(2 pi))/2 - log_head_sd
+//
+// The reduced chi-square is near one when the observation variances are
+// consistent with the misfit. The log-likelihood is that of the observed
+// heads under independent Gaussian errors: the density of the discharge
+// potentials, -(wrss + count log(2 pi))/2 - sum(log(Phi_sd)), times the
+// Jacobian |dPhi/dhead| = Phi_sd/head_sd of each observation. The Phi_sd
+// cancel, so the heads, not the (k,h)-dependent potentials, are the data,
+// and the log-likelihood is comparable between (k,h) cells.
+//=============================================================================
+void SetGoodnessOfFit(
+   CellResult& cell,
+   double wrss,
+   int count,
+   int terms,
+   double log_head_sd ) {
+   cell.wrss          = wrss;
+   cell.reduced_chisq = (count > terms) ? wrss / (count - terms) : std::numeric_limits<double>::quiet_NaN();
+   cell.loglik        = -0.5*(wrss + count*std::log(TWO_PI)) - log_head_sd;
+}
+
+
+//=============================================================================
+// SetPoints
+//
+// Computes "count" set-points for a lognormal distribution with log-mean
+// "alpha" and log-standard deviation "beta". Each set-point is at the center
+// of an interval containing equal probability.
+//=============================================================================
+std::vector<double> SetPoints( double alpha, double beta, int count ) {
+   std::vector<double> v(count);
+   for (int i = 0; i < count; ++i ) {
+      double p = 1.0/double(2.0*count) + double(i)/double(count);
+      v[i] = exp(alpha + beta*GaussianCDFInv(p));
+   }
+   return v;
+}
+
+
+//=============================================================================
+// ActiveIndices
+//
+// Returns the index view of the observations that are not within "radius"
+// of any pumping well. If "report" is true, each deactivated observation is
+// listed on std::cout.
+//=============================================================================
+std::vector<int> ActiveIndices(
+   const ObsTable& obs,
+   const std::vector<WellRecord>& wells,
+   double radius,
+   bool report) {
+
+   const int M = obs.size();     // number of observations
+   const int N = wells.size();   // number of pumping wells
+
+   const double* obs_x = obs.x();
+   const double* obs_y = obs.y();
+
+   std::vector<int> active;
+   active.reserve(M);
+
+   for (int m = 0; m < M; ++m) {
+      bool is_active = true;
+      for (int n = 0; n < N; ++n) {
+         double separation_distance = hypot(obs_x[m]-wells[n].x, obs_y[m]-wells[n].y);
+         if (separation_distance < radius) {
+            is_active = false;
+            if (report)
+               std::cout << " --Obs(" << m << ") deactivated due to proximity with Well(" << n << ")" << std::endl;
+         }
+      }
+      if (is_active)
+         active.push_back(m);
+   }
+
+   return active;
+}
+
 
 //=============================================================================
 // Engine
@@ -243,7 +631,18 @@ ComputeGeohydrologyStatistics(
 //
 // Arguments:
 //
-// Returns:
+//    xo, yo         the model origin.
+//    k_alpha, ...   the lognormal conductivity distribution, and the number
+//                   of set-points.
+//    h_alpha, ...   the lognormal thickness distribution, and the number of
+//                   set-points.
+//    radius         the well buffer radius.
+//    obs            the observations.
+//    wells          the pumping wells.
+//    method         how each cell is fit; see FitMethod.
+//    nthreads       the maximum number of threads for the QR factorization;
+//                   see ThreadCount.
+//    sink           receives each row of results as soon as it is complete.
 //
 // Notes:
 // o  The reported boomerang statistics are defined using the hydrogeologic
@@ -255,100 +654,122 @@ ComputeGeohydrologyStatistics(
 //
 //    computed at the specified focus location.
 //
+// o  Only one row of results is held at a time; the sink decides whether
+//    to keep them.
+//
 //=============================================================================
-Results Engine(
+void Engine(
    double xo, double yo,
    double k_alpha, double k_beta, int k_count,
    double h_alpha, double h_beta, int h_count,
    double radius,
-   std::vector<ObsRecord> obs,
-   std::vector<WellRecord> wells) {
+   const ObsTable& obs,
+   const std::vector<WellRecord>& wells,
+   FitMethod method,
+   int nthreads,
+   ResultSink& sink) {
+
+   // Compute the set-points for both k and h. Each set-point is at the center
+   // of an interval containing equal probability. For example, if n = 10 the
+   // set points would be at the {5, 15, 25, ..., 75, 85, 95} percentiles. As
+   // a result, the distribution of the actual values, k's and h's, are highly
+   // nonuniform.
+   std::vector<double> k = SetPoints(k_alpha, k_beta, k_count);
+   std::vector<double> h = SetPoints(h_alpha, h_beta, h_count);
+
+   Engine(xo, yo, k, h, radius, obs, wells, method, nthreads, sink);
+}
+
+//-----------------------------------------------------------------------------
+// As above, at the given conductivities, k, and thicknesses, h, such as the
+// nodes of QuadraturePoints.
+//-----------------------------------------------------------------------------
+void Engine(
+   double xo, double yo,
+   const std::vector<double>& k,
+   const std::vector<double>& h,
+   double radius,
+   const ObsTable& obs,
+   const std::vector<WellRecord>& wells,
+   FitMethod method,
+   int nthreads,
+   ResultSink& sink) {
 
    // Manifest constants.
    const int MINIMUM_COUNT = 10; // At least this many unique observation locations.
 
-   const int M = obs.size();     // number of observations
-   const int N = wells.size();   // number of pumping wells
-
-   // Deactivate observations that are too close to a pumping well.
-   std::vector<int> is_active(M);
-   std::fill(is_active.begin(), is_active.end(), 1);
+   const int k_count = k.size();
+   const int h_count = h.size();
 
-   for (int m = 0; m < M; ++m) {
-      for (int n = 0; n < N; ++n) {
-         double separation_distance = hypot(obs[m].x-wells[n].x, obs[m].y-wells[n].y);
-         if (separation_distance < radius) {
-            is_active[m] = 0;
-            std::cout << " --Obs(" << m << ") deactivated due to proximity with Well(" << n << ")" << std::endl;
-         }
-      }
-   }
+   // Deactivate observations that are too close to a pumping well. The
+   // remaining observations are identified by an index view into the table.
+   std::vector<int> active = ActiveIndices(obs, wells, radius, true);
 
-   int Mactive = std::accumulate(is_active.begin(), is_active.end(), int(0));
-   if (Mactive < MINIMUM_COUNT) {
+   int Mactive = active.size();
+   int Munique = CountUniqueLocations(obs, active);
+   if (Munique < MINIMUM_COUNT) {
       std::stringstream message;
-      message << "Too few active observations: " << Mactive << " < " << MINIMUM_COUNT << std::endl;
+      message << "Too few unique active observation locations: " << Munique << " < " << MINIMUM_COUNT << std::endl;
       throw TooFewObservations(message.str());
    }
+   std::cout << Mactive << " active observation data records at " << Munique << " unique locations." << std::endl;
 
-   std::vector<ObsRecord> active_obs(Mactive);
-   int mm = 0;
-   for (int m = 0; m < M; ++m) {
-      if (is_active[m]) {
-         active_obs[mm++] = obs[m];
-      }
-   }
-   std::cout << active_obs.size() << " active observation data records." << std::endl;
-
-   // Initialize the results.
-   Results results(k_count, h_count);
+   const double log_head_sd = HeadLogSdSum(obs, active);
 
-   // Compute the set-points for both k and h. Each set-point is at the center
-   // of an interval containing equal probability. For example, if n = 10 the
-   // set points would be at the {5, 15, 25, ..., 75, 85, 95} percentiles. As
-   // a result, the distribution of the actual values, k's and h's, are highly
-   // nonuniform.
-   std::vector<double> k(k_count);
-   for (int i = 0; i < k_count; ++i ) {
-      double p = 1.0/double(2.0*k_count) + double(i)/double(k_count);
-      k[i] = exp(k_alpha + k_beta*GaussianCDFInv(p));
-   }
-   results.k = k;
+   sink.Begin(k, h);
 
-   std::vector<double> h(h_count);
-   for (int j = 0; j < h_count; ++j ) {
-      double p = 1.0/double(2.0*h_count) + double(j)/double(h_count);
-      h[j] = exp(h_alpha + h_beta*GaussianCDFInv(p));
-   }
-   results.h = h;
+   // Compute and emit the results one row at a time.
+   std::vector<CellResult> row(h_count);
 
-   // Fill the results.
    for (int i = 0; i < k_count; ++i) {
       for (int j = 0; j < h_count; ++j) {
 
          // Setup the regression for the quadratic discharge potential model
-         // using the current k and h, and only the active obs.
-         Matrix X, Vinv, Y;
-         std::tie(X, Vinv, Y) = SetupQuadraticModel(xo, yo, k[i], h[j], active_obs, wells);
-
-         // Fit the parameters using all of the active observations.
+         // using the current k and h, and only the active obs, and fit the
+         // parameters using all of the active observations.
          Matrix P_ev, P_cov;
-         std::tie(P_ev, P_cov) = FitQuadraticModel(X, Vinv, Y);
+         double wrss;
 
+         if (method == FIT_QR) {
+            Matrix Z = SetupWeightedModel(xo, yo, k[i], h[j], obs, active, wells);
+            std::tie(P_ev, P_cov) = FitWeightedModelQR(Z, nthreads, wrss);
+         }
+         else {
+            Matrix X, Vinv, Y;
+            std::tie(X, Vinv, Y) = SetupQuadraticModel(xo, yo, k[i], h[j], obs, active, wells);
+            std::tie(P_ev, P_cov) = FitQuadraticModel(X, Vinv, Y, wrss);
+         }
 
-         double r_ev, r_sd, m_ev, m_sd, d_ev, d_sd;
-         std::tie(r_ev, r_sd, m_ev, m_sd, d_ev, d_sd) = ComputeGeohydrologyStatistics(P_ev, P_cov);
-
-         results.R_ev(i,j) = r_ev;
-         results.R_sd(i,j) = r_sd;
-
-         results.M_ev(i,j) = m_ev;
-         results.M_sd(i,j) = m_sd;
-
-         results.D_ev(i,j) = d_ev;
-         results.D_sd(i,j) = d_sd;
+         row[j] = ComputeCellResult(P_ev, P_cov);
+         SetGoodnessOfFit(row[j], wrss, Mactive, QUADRATIC_TERMS, log_head_sd);
       }
+      sink.Row(i, row);
    }
 
+   sink.End();
+}
+
+//-----------------------------------------------------------------------------
+Results Engine(
+   double xo, double yo,
+   double k_alpha, double k_beta, int k_count,
+   double h_alpha, double h_beta, int h_count,
+   double radius,
+   const ObsTable& obs,
+   const std::vector<WellRecord>& wells) {
+   Results results;
+   MemoryResultSink sink(results);
+   Engine(xo, yo, k_alpha, k_beta, k_count, h_alpha, h_beta, h_count, radius, obs, wells, FIT_NORMAL_EQUATIONS, 0, sink);
    return results;
 }
+
+//-----------------------------------------------------------------------------
+Results Engine(
+   double xo, double yo,
+   double k_alpha, double k_beta, int k_count,
+   double h_alpha, double h_beta, int h_count,
+   double radius,
+   const std::vector<ObsRecord>& obs,
+   const std::vector<WellRecord>& wells) {
+   return Engine(xo, yo, k_alpha, k_beta, k_count, h_alpha, h_beta, h_count, radius, ObsTable(obs), wells);
+}
@@ -17,7 +17,10 @@
 #include <vector>
 
 #include "matrix.h"
+#include "normal_equations.h"
+#include "obs_table.h"
 #include "read_data.h"
+#include "result_sink.h"
 
 
 //=============================================================================
@@ -33,6 +36,23 @@ class CholeskyDecompositionFailed: public std::runtime_error {
       }
 };
 
+class QRFactorizationFailed: public std::runtime_error {
+   public :
+      QRFactorizationFailed( const std::string& message ) : std::runtime_error(message) {
+      }
+};
+
+//-----------------------------------------------------------------------------
+// How the weighted least squares model is fit: by a Cholesky decomposition
+// of the normal equations, X'WX P = X'Wy, or by a QR factorization of the
+// weighted regression matrix, which never forms X'WX and so loses half as
+// many digits when X'WX is poorly conditioned.
+//-----------------------------------------------------------------------------
+enum FitMethod {
+   FIT_NORMAL_EQUATIONS,
+   FIT_QR
+};
+
 //=============================================================================
 class Results {
    public:
@@ -48,19 +68,81 @@ class Results {
       Matrix D_ev;
       Matrix D_sd;
 
+      Matrix WRSS;
+      Matrix ChiSq;
+      Matrix LogLik;
+
       Results();
       Results( int k_count, int h_count );
 };
 
+//-----------------------------------------------------------------------------
+// A ResultSink that collects the rows into a Results object.
+//-----------------------------------------------------------------------------
+class MemoryResultSink : public ResultSink {
+   public:
+      MemoryResultSink( Results& results );
+
+      void Begin( const std::vector<double>& k, const std::vector<double>& h );
+      void Row( int i, const std::vector<CellResult>& row );
+      void End();
+
+   private:
+      Results& m_Results;
+};
+
 
 //=============================================================================
+void Engine(
+   double xo, double yo,
+   double k_alpha, double k_beta, int k_count,
+   double h_alpha, double h_beta, int h_count,
+   double radius,
+   const ObsTable& obs,
+   const std::vector<WellRecord>& wells,
+   FitMethod method,
+   int nthreads,
+   ResultSink& sink
+);
+
+void Engine(
+   double xo, double yo,
+   const std::vector<double>& k,
+   const std::vector<double>& h,
+   double radius,
+   const ObsTable& obs,
+   const std::vector<WellRecord>& wells,
+   FitMethod method,
+   int nthreads,
+   ResultSink& sink
+);
+
+Results Engine(
+   double xo, double yo,
+   double k_alpha, double k_beta, int k_count,
+   double h_alpha, double h_beta, int h_count,
+   double radius,
+   const ObsTable& obs,
+   const std::vector<WellRecord>& wells
+);
+
 Results Engine(
    double xo, double yo,
    double k_alpha, double k_beta, int k_count,
    double h_alpha, double h_beta, int h_count,
    double radius,
-   std::vector<ObsRecord> obs,
-   std::vector<WellRecord> wells
+   const std::vector<ObsRecord>& obs,
+   const std::vector<WellRecord>& wells
+);
+
+std::tuple<Matrix, Matrix, Matrix>
+SetupQuadraticModel(
+   double xo, double yo,
+   double conductivity,
+   double thickness,
+   const ObsTable& obs,
+   const std::vector<int>& active,
+   const std::vector<WellRecord>& wells
 );
 
 std::tuple<Matrix, Matrix, Matrix>
@@ -68,8 +150,31 @@ SetupQuadraticModel(
    double xo, double yo,
    double conductivity,
    double thickness,
-   std::vector<ObsRecord> obs,
-   std::vector<WellRecord> wells
+   const std::vector<ObsRecord>& obs,
+   const std::vector<WellRecord>& wells
+);
+
+Matrix
+SetupWeightedModel(
+   double xo, double yo,
+   double conductivity,
+   double thickness,
+   const ObsTable& obs,
+   const std::vector<int>& active,
+   const std::vector<WellRecord>& wells
+);
+
+std::tuple<Matrix, Matrix>
+FitWeightedModelQR(
+   const Matrix& Z,
+   int nthreads
+);
+
+std::tuple<Matrix, Matrix>
+FitWeightedModelQR(
+   const Matrix& Z,
+   int nthreads,
+   double& wrss
 );
 
 std::tuple<Matrix, Matrix>
@@ -79,11 +184,83 @@ FitQuadraticModel(
    const Matrix& Y
 );
 
+std::tuple<Matrix, Matrix>
+FitQuadraticModel(
+   const Matrix& X,
+   const Matrix& Vinv,
+   const Matrix& Y,
+   double& wrss
+);
+
+std::tuple<Matrix, Matrix>
+SolveNormalEquations(
+   const Matrix& XtWX,
+   const Matrix& XtWY
+);
+
+void DischargePotential(
+   double head_ev, double head_sd,
+   double conductivity, double thickness,
+   double& Phi_ev, double& Phi_sd
+);
+
+double DischargePotentialSlope(
+   double head_ev,
+   double conductivity, double thickness
+);
+
+double WellPotential(
+   double x, double y,
+   const std::vector<WellRecord>& wells
+);
+
+double HeadLogSdSum(
+   const ObsTable& obs,
+   const std::vector<int>& active
+);
+
+std::vector<int> ActiveIndices(
+   const ObsTable& obs,
+   const std::vector<WellRecord>& wells,
+   double radius,
+   bool report
+);
+
+std::vector<double> SetPoints(
+   double alpha, double beta, int count
+);
+
+std::tuple<double, double, double, double, double, double>
+ComputeGeohydrologyStatistics(
+   const Matrix& P_ev,
+   const Matrix& P_cov
+);
+
 std::tuple<double, double, double, double, double, double>
 ComputeGeohydrologyStatistics(
+   const Matrix& P_ev,
+   const Matrix& P_cov,
+   int xx, int yy, int x, int y
+);
+
+CellResult ComputeCellResult(
    const Matrix& P_ev,
    const Matrix& P_cov
 );
 
+double WeightedResidualSumOfSquares(
+   double yWy,
+   const Matrix& XtWY,
+   const Matrix& P_ev
+);
+
+void SetGoodnessOfFit(
+   CellResult& cell,
+   double wrss,
+   int count,
+   int terms,
+   double log_head_sd
+);
+
 //=============================================================================
 #endif  // ENGINE_H
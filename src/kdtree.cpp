@@ -0,0 +1,157 @@
+//=============================================================================
+// kdtree.cpp
+//
+//    A static two-dimensional k-d tree.
+//
+// notes:
+// o  The tree is implicit: the points are permuted so that the node for the
+//    range [lo,hi) is the point at mid = (lo+hi)/2, the points in [lo,mid)
+//    lie on the low side of its splitting line, and those in [mid+1,hi) on
+//    the high side. Each range is split across its wider extent.
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#include <algorithm>
+#include <utility>
+
+#include "kdtree.h"
+
+//-----------------------------------------------------------------------------
+KdTree::KdTree( const double* x, const double* y, int count )
+:  m_x( x, x + count ),
+   m_y( y, y + count ),
+   m_Index( count ),
+   m_Axis( count, 0 ) {
+
+   for (int m = 0; m < count; ++m)
+      m_Index[m] = m;
+
+   Build(0, count);
+}
+
+//-----------------------------------------------------------------------------
+int KdTree::size() const {
+   return m_Index.size();
+}
+
+//-----------------------------------------------------------------------------
+// Order the range [lo,hi) about its median along its wider extent, and
+// recurse on both halves.
+//-----------------------------------------------------------------------------
+void KdTree::Build( int lo, int hi ) {
+   if (hi - lo <= 1)
+      return;
+
+   auto xrange = std::minmax_element(m_x.begin() + lo, m_x.begin() + hi);
+   auto yrange = std::minmax_element(m_y.begin() + lo, m_y.begin() + hi);
+   const char axis = (*xrange.second - *xrange.first >= *yrange.second - *yrange.first) ? 0 : 1;
+
+   // Sort a permutation of the range, then apply it to all three arrays.
+   const std::vector<double>& key = (axis == 0) ? m_x : m_y;
+   const int mid = (lo + hi)/2;
+
+   std::vector<int> order(hi - lo);
+   for (int i = 0; i < hi - lo; ++i)
+      order[i] = lo + i;
+   std::nth_element(order.begin(), order.begin() + (mid - lo), order.end(),
+      [&key](int a, int b) { return key[a] < key[b]; });
+
+   std::vector<double> x(hi - lo), y(hi - lo);
+   std::vector<int> index(hi - lo);
+   for (int i = 0; i < hi - lo; ++i) {
+      x[i]     = m_x[order[i]];
+      y[i]     = m_y[order[i]];
+      index[i] = m_Index[order[i]];
+   }
+   std::copy(x.begin(), x.end(), m_x.begin() + lo);
+   std::copy(y.begin(), y.end(), m_y.begin() + lo);
+   std::copy(index.begin(), index.end(), m_Index.begin() + lo);
+
+   m_Axis[mid] = axis;
+   Build(lo, mid);
+   Build(mid + 1, hi);
+}
+
+//-----------------------------------------------------------------------------
+void KdTree::Within( double x, double y, double radius, std::vector<int>& found ) const {
+   found.clear();
+   Within(0, size(), x, y, radius*radius, found);
+}
+
+void KdTree::Within( int lo, int hi, double x, double y, double r2, std::vector<int>& found ) const {
+   if (lo >= hi)
+      return;
+
+   const int mid = (lo + hi)/2;
+   const double dx = m_x[mid] - x;
+   const double dy = m_y[mid] - y;
+   if (dx*dx + dy*dy <= r2)
+      found.push_back(m_Index[mid]);
+
+   // The signed distance from the query to the splitting line.
+   const double d = (m_Axis[mid] == 0) ? -dx : -dy;
+   if (d <= 0 || d*d <= r2)
+      Within(lo, mid, x, y, r2, found);
+   if (d >= 0 || d*d <= r2)
+      Within(mid + 1, hi, x, y, r2, found);
+}
+
+//-----------------------------------------------------------------------------
+void KdTree::Nearest( double x, double y, int count, double radius, std::vector<int>& found ) const {
+   found.clear();
+   if (count <= 0)
+      return;
+
+   // A max-heap of (squared distance, index) of the best points so far; r2
+   // shrinks to the worst of them once the heap is full.
+   std::vector<std::pair<double,int>> heap;
+   heap.reserve(count + 1);
+   double r2 = radius*radius;
+
+   Nearest(0, size(), x, y, count, r2, heap);
+
+   std::sort_heap(heap.begin(), heap.end());
+   for (const std::pair<double,int>& item : heap)
+      found.push_back(item.second);
+}
+
+void KdTree::Nearest( int lo, int hi, double x, double y, int count, double& r2,
+   std::vector<std::pair<double,int>>& heap ) const
+{
+   if (lo >= hi)
+      return;
+
+   const int mid = (lo + hi)/2;
+   const double dx = m_x[mid] - x;
+   const double dy = m_y[mid] - y;
+   const double dist2 = dx*dx + dy*dy;
+
+   if (dist2 <= r2) {
+      heap.push_back( std::make_pair(dist2, m_Index[mid]) );
+      std::push_heap(heap.begin(), heap.end());
+      if (static_cast<int>(heap.size()) > count) {
+         std::pop_heap(heap.begin(), heap.end());
+         heap.pop_back();
+      }
+      if (static_cast<int>(heap.size()) == count)
+         r2 = std::min(r2, heap.front().first);
+   }
+
+   // Search the near side first, so that r2 shrinks as early as possible.
+   const double d = (m_Axis[mid] == 0) ? -dx : -dy;
+   if (d <= 0) {
+      Nearest(lo, mid, x, y, count, r2, heap);
+      if (d*d <= r2)
+         Nearest(mid + 1, hi, x, y, count, r2, heap);
+   } else {
+      Nearest(mid + 1, hi, x, y, count, r2, heap);
+      if (d*d <= r2)
+         Nearest(lo, mid, x, y, count, r2, heap);
+   }
+}
@@ -0,0 +1,52 @@
+//=============================================================================
+// kdtree.h
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#ifndef KDTREE_H
+#define KDTREE_H
+
+#include <utility>
+#include <vector>
+
+//=============================================================================
+// KdTree
+//
+//    A static two-dimensional k-d tree over a set of points, for gathering
+//    the points near a query location. The tree holds its own copy of the
+//    coordinates, in tree order, and reports the points by their original
+//    indices.
+//=============================================================================
+class KdTree {
+   public:
+      KdTree( const double* x, const double* y, int count );
+
+      int size() const;
+
+      // All of the points within distance "radius" of (x,y).
+      void Within( double x, double y, double radius, std::vector<int>& found ) const;
+
+      // The (at most) "count" points nearest to (x,y) that are also within
+      // distance "radius"; pass INF for no distance limit.
+      void Nearest( double x, double y, int count, double radius, std::vector<int>& found ) const;
+
+   private:
+      void Build( int lo, int hi );
+      void Within( int lo, int hi, double x, double y, double r2, std::vector<int>& found ) const;
+      void Nearest( int lo, int hi, double x, double y, int count, double& r2,
+         std::vector<std::pair<double,int>>& heap ) const;
+
+      std::vector<double> m_x;
+      std::vector<double> m_y;
+      std::vector<int>    m_Index;
+      std::vector<char>   m_Axis;      // split axis of the node at the middle of each range
+};
+
+//=============================================================================
+#endif  // KDTREE_H
@@ -0,0 +1,60 @@
+//=============================================================================
+// leave_one_out.h
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#ifndef LEAVE_ONE_OUT_H
+#define LEAVE_ONE_OUT_H
+
+#include <ostream>
+#include <vector>
+
+#include "matrix.h"
+#include "obs_table.h"
+#include "read_data.h"
+
+//-----------------------------------------------------------------------------
+// The leave-one-out diagnostics for one observation in one (k,h) cell. The
+// residuals are in discharge potential units [L^3/T]; the changes are the
+// leave-one-out value minus the all-observation value.
+//-----------------------------------------------------------------------------
+struct LooRecord {
+   double leverage;        // h = w x'inv(X'WX)x
+   double residual;        // y - x'P
+   double loo_residual;    // y - x'P(-m) = residual/(1-h)
+   double boomerang;       // loo_residual / its standard deviation
+
+   double d_recharge;
+   double d_magnitude;
+   double d_direction;     // [radians], wrapped to [-pi, pi]
+};
+
+//-----------------------------------------------------------------------------
+std::vector<LooRecord> LeaveOneOut(
+   const Matrix& P_ev,
+   const Matrix& P_cov,
+   const std::vector<double>& rows,
+   const std::vector<double>& w,
+   const std::vector<double>& y,
+   int nthreads
+);
+
+void LeaveOneOutEngine(
+   double xo, double yo,
+   double k_alpha, double k_beta, int k_count,
+   double h_alpha, double h_beta, int h_count,
+   double radius,
+   const ObsTable& obs,
+   const std::vector<WellRecord>& wells,
+   int nthreads,
+   std::ostream& out
+);
+
+//=============================================================================
+#endif  // LEAVE_ONE_OUT_H
@@ -18,13 +18,126 @@
 //=============================================================================
 #include "linear_systems.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <vector>
 
+#include "parallel_for-inl.h"
 #include "sum_product-inl.h"
 
 namespace{
    double MIN_DIVISOR = 1e-12;
+
+   // The number of rows in each leaf block of TsqrFactor.
+   const int TSQR_BLOCK_ROWS = 1024;
+
+   // The tile size of the blocked Cholesky decomposition and triangular
+   // solves. A tile of doubles fits comfortably in a level 2 cache.
+   const int CHOLESKY_BLOCK = 64;
+
+   //--------------------------------------------------------------------------
+   // Factor the diagonal block A[k0:k1, k0:k1] in place, left-looking over
+   // the columns of the block. The columns before k0 have already been
+   // subtracted by the trailing updates.
+   //--------------------------------------------------------------------------
+   bool FactorDiagonalBlock( Matrix& A, int k0, int k1 ) {
+      for (int j = k0; j < k1; ++j) {
+         for (int k = j; k < k1; ++k)
+            A(k,j) -= SumProduct(j-k0, A.Base(j,k0), A.Base(k,k0));
+
+         if (A(j,j) < MIN_DIVISOR) return false;
+         A(j,j) = sqrt(A(j,j));
+
+         for (int k = j+1; k < k1; ++k)
+            A(k,j) /= A(j,j);
+      }
+      return true;
+   }
+
+   //--------------------------------------------------------------------------
+   // Overwrite the rows [r0, r1) of the panel A[:, k0:k1] with the panel
+   // times inv(L_kk)', where L_kk is the factored diagonal block.
+   //--------------------------------------------------------------------------
+   void SolvePanel( Matrix& A, int k0, int k1, int r0, int r1 ) {
+      for (int i = r0; i < r1; ++i) {
+         for (int j = k0; j < k1; ++j)
+            A(i,j) = (A(i,j) - SumProduct(j-k0, A.Base(i,k0), A.Base(j,k0))) / A(j,j);
+      }
+   }
+
+   //--------------------------------------------------------------------------
+   // Subtract the panel's contribution from the lower triangle of the
+   // trailing tile A[r0:r1, c0:c1]: A(i,j) -= A(i,k0:k1) A(j,k0:k1)'.
+   //--------------------------------------------------------------------------
+   void UpdateTile( Matrix& A, int k0, int k1, int r0, int r1, int c0, int c1 ) {
+      for (int i = r0; i < r1; ++i) {
+         const int end = std::min(c1, i+1);
+         for (int j = c0; j < end; ++j)
+            A(i,j) -= SumProduct(k1-k0, A.Base(i,k0), A.Base(j,k0));
+      }
+   }
+
+   //--------------------------------------------------------------------------
+   // B(i, c0:c1) -= L(i,j) B(j, c0:c1), a row of B at a time.
+   //--------------------------------------------------------------------------
+   inline void SubtractRow( Matrix& B, int i, int j, double a, int c0, int c1 ) {
+      double* bi = B.Base(i,0);
+      const double* bj = B.Base(j,0);
+      for (int c = c0; c < c1; ++c)
+         bi[c] -= a * bj[c];
+   }
+
+   //--------------------------------------------------------------------------
+   // Triangularize
+   //
+   //    Reduce the (M x N) Matrix A to upper triangular form in place using
+   //    Householder reflections, Golub and Van Loan (1996), Algorithm 5.2.1,
+   //    and return the (N x N) triangular factor R, padded with zero rows if
+   //    M < N.
+   //
+   //    Each reflection is applied a row at a time, w' = v'A then
+   //    A -= beta v w', so the row-major storage is swept contiguously.
+   //--------------------------------------------------------------------------
+   void Triangularize( Matrix& A, Matrix& R ) {
+      const int M = A.nRows();
+      const int N = A.nCols();
+
+      std::vector<double> v(M);
+      std::vector<double> w(N);
+
+      for (int k = 0; k < std::min(M, N); ++k) {
+         double alpha = sqrt( SumProduct(M-k, A.Base(k,k), N, A.Base(k,k), N) );
+         if (alpha == 0.0) continue;
+         if (A(k,k) > 0) alpha = -alpha;
+
+         for (int i = k; i < M; ++i)
+            v[i] = A(i,k);
+         v[k] -= alpha;
+         const double beta = -1.0 / (alpha * v[k]);   // 2/v'v
+
+         std::fill(w.begin() + k+1, w.end(), 0.0);
+         for (int i = k; i < M; ++i) {
+            const double* a = A.Base(i,0);
+            for (int j = k+1; j < N; ++j)
+               w[j] += v[i] * a[j];
+         }
+         for (int i = k; i < M; ++i) {
+            double* a = A.Base(i,0);
+            const double bv = beta * v[i];
+            for (int j = k+1; j < N; ++j)
+               a[j] -= bv * w[j];
+            a[k] = 0.0;
+         }
+         A(k,k) = alpha;
+      }
+
+      R.Resize(N,N);
+      R = 0.0;
+      for (int i = 0; i < std::min(M, N); ++i)
+         for (int j = i; j < N; ++j)
+            R(i,j) = A(i,j);
+   }
 }
 
 //=============================================================================
@@ -54,6 +167,8 @@ namespace{
 //
 // o  The routine CholeskySolve is this routine's complementary pair.
 //
+// o  This is a single-threaded wrapper around CholeskyFactor.
+//
 // References:
 //
 // o  Golub, G.H., and Van Loan, C.F., 1996, MATRIX COMPUTATIONS, 3rd Edition,
@@ -64,28 +179,174 @@ bool CholeskyDecomposition( const Matrix& A, Matrix& L )
    // Validate the arguments.
    assert(isSquare(A));
 
-   // Define local constants.
+   // Carry out the Cholesky decomposition on a copy of Matrix "A".
+   L = A;
+   return CholeskyFactor(L, 1);
+}
+
+//=============================================================================
+// CholeskyFactor
+//
+//    Compute the Cholesky decomposition of the symmetric positive definite
+//    Matrix "A" in place, using a blocked, right-looking algorithm.
+//
+// Arguments:
+//
+//    A        on entrance, a symmetric positive definite Matrix; only the
+//             lower triangular portion is accessed.
+//             on exit, the lower triangular Matrix L where A = LL', with the
+//             strict upper triangle set to zero.
+//
+//    nthreads the maximum number of threads; see ThreadCount.
+//
+// Return:
+//
+//    true  if the decomposition was completed successfully;
+//    false if not, in which case A is partially overwritten.
+//
+// Notes:
+//
+// o  For each block column of CHOLESKY_BLOCK columns: the diagonal block is
+//    factored, the panel below it is solved against the diagonal block,
+//    and the panel's outer product is subtracted from the trailing lower
+//    triangle, one CHOLESKY_BLOCK x CHOLESKY_BLOCK tile at a time. The
+//    panel rows and the trailing tiles are independent, so they are
+//    processed in parallel. Every inner loop is a dot product of two rows,
+//    contiguous in the row-major storage.
+//
+// o  The tiles are fixed by the size of A, not by the number of threads,
+//    so the result does not depend on the number of threads.
+//
+// o  A Matrix with at most CHOLESKY_BLOCK rows is a single diagonal block,
+//    factored exactly as Golub and Van Loan (1996), Algorithm 4.2-1.
+//=============================================================================
+bool CholeskyFactor( Matrix& A, int nthreads )
+{
+   assert(isSquare(A));
    const int N = A.nRows();
+   const int NB = CHOLESKY_BLOCK;
 
-   // Carry out the Cholesky decomposition on Matrix "A".
-   L = A;
-   for (int j = 0; j < N; ++j) {
-      if (j > 0) {
-         for (int k = j; k < N; ++k)
-            L(k,j) -= SumProduct(j, L.Base(j,0), L.Base(k,0));
-      }
+   for (int k0 = 0; k0 < N; k0 += NB) {
+      const int k1 = std::min(N, k0 + NB);
 
-      if (L(j,j) < MIN_DIVISOR) return false;
-      L(j,j) = sqrt(L(j,j));
+      if (!FactorDiagonalBlock(A, k0, k1)) return false;
+      if (k1 == N) break;
 
-      for (int k = j+1; k < N; ++k) {
-         L(k,j) /= L(j,j);
-         L(j,k) = 0.0;
-      }
+      const int ntiles = (N - k1 + NB - 1) / NB;
+
+      ParallelFor(0, ntiles, nthreads, [&](int t) {
+         SolvePanel(A, k0, k1, k1 + t*NB, std::min(N, k1 + (t+1)*NB));
+      });
+
+      std::vector<std::pair<int,int>> tiles;
+      for (int ti = 0; ti < ntiles; ++ti)
+         for (int tj = 0; tj <= ti; ++tj)
+            tiles.push_back(std::make_pair(ti, tj));
+
+      ParallelFor(0, static_cast<int>(tiles.size()), nthreads, [&](int t) {
+         const int r0 = k1 + tiles[t].first*NB;
+         const int c0 = k1 + tiles[t].second*NB;
+         UpdateTile(A, k0, k1, r0, std::min(N, r0 + NB), c0, std::min(N, c0 + NB));
+      });
    }
+
+   for (int i = 0; i < N; ++i)
+      for (int j = i+1; j < N; ++j)
+         A(i,j) = 0.0;
+
    return true;
 }
 
+//=============================================================================
+// TriangularSolve
+//
+//    Solve L X = B, or L' X = B, for X in place, where L is lower triangular:
+//    i.e. the blocked forward or back substitution (TRSM) matching
+//    CholeskyFactor.
+//
+// Arguments:
+//
+//    L        the (N x N) lower triangular Matrix; the strict upper
+//             triangle is not accessed.
+//    B        on entrance, the (N x P) right hand sides;
+//             on exit, the solutions.
+//    transpose solve L' X = B if true, L X = B if false.
+//    nthreads the maximum number of threads; see ThreadCount.
+//
+// Notes:
+//
+// o  The right hand sides are independent, so the columns of B are split
+//    into chunks of CHOLESKY_BLOCK columns, solved in parallel. Within a
+//    chunk, the rows are processed a CHOLESKY_BLOCK x CHOLESKY_BLOCK tile
+//    of L at a time, and each update is a contiguous row of B.
+//
+// o  A Matrix with at most CHOLESKY_BLOCK rows is a single tile, solved
+//    exactly as Golub and Van Loan (1983), Algorithms 4.1-1 and 4.1-2.
+//=============================================================================
+void TriangularSolve( const Matrix& L, Matrix& B, bool transpose, int nthreads )
+{
+   assert( L.nRows() == L.nCols() );
+   assert( B.nRows() == L.nRows() );
+
+   const int N = L.nRows();
+   const int P = B.nCols();
+   const int NB = CHOLESKY_BLOCK;
+   const int nblocks = (N + NB - 1) / NB;
+
+   ParallelFor(0, (P + NB - 1) / NB, nthreads, [&](int chunk) {
+      const int c0 = chunk*NB;
+      const int c1 = std::min(P, c0 + NB);
+
+      if (!transpose) {
+         // Forward substitution: the off-diagonal tiles to the left, then
+         // the diagonal tile.
+         for (int bi = 0; bi < nblocks; ++bi) {
+            const int i0 = bi*NB;
+            const int i1 = std::min(N, i0 + NB);
+
+            for (int j0 = 0; j0 < i0; j0 += NB) {
+               for (int i = i0; i < i1; ++i)
+                  for (int j = j0; j < j0 + NB; ++j)
+                     SubtractRow(B, i, j, L(i,j), c0, c1);
+            }
+
+            for (int i = i0; i < i1; ++i) {
+               for (int j = i0; j < i; ++j)
+                  SubtractRow(B, i, j, L(i,j), c0, c1);
+
+               double* bi_row = B.Base(i,0);
+               for (int c = c0; c < c1; ++c)
+                  bi_row[c] /= L(i,i);
+            }
+         }
+      }
+      else {
+         // Back substitution: the off-diagonal tiles below (in L), then the
+         // diagonal tile. A tile of L' is read a row of L at a time.
+         for (int bi = nblocks-1; bi >= 0; --bi) {
+            const int i0 = bi*NB;
+            const int i1 = std::min(N, i0 + NB);
+
+            for (int j0 = i1; j0 < N; j0 += NB) {
+               const int j1 = std::min(N, j0 + NB);
+               for (int j = j0; j < j1; ++j)
+                  for (int i = i0; i < i1; ++i)
+                     SubtractRow(B, i, j, L(j,i), c0, c1);
+            }
+
+            for (int i = i1-1; i >= i0; --i) {
+               for (int j = i+1; j < i1; ++j)
+                  SubtractRow(B, i, j, L(j,i), c0, c1);
+
+               double* bi_row = B.Base(i,0);
+               for (int c = c0; c < c1; ++c)
+                  bi_row[c] /= L(i,i);
+            }
+         }
+      }
+   });
+}
+
 //=============================================================================
 // CholeskySolve
 //
@@ -115,6 +376,8 @@ bool CholeskyDecomposition( const Matrix& A, Matrix& L )
 //    however, in both sub-systems the soultion overwrites the right hand
 //    side vector b.
 //
+// o  This is a single-threaded wrapper around TriangularSolve.
+//
 // References:
 //
 //    Golub, G.H., and Van Loan, C.F., 1983, MATRIX COMPUTATIONS, Johns
@@ -127,30 +390,10 @@ void CholeskySolve( const Matrix& L, const Matrix& b, Matrix& x )
    assert( L.nRows() == L.nCols() );
    assert( b.nRows() == L.nRows() );
 
-   // Define local constants.
-   const int N = L.nRows();
-
-   // Solve L y = b using forward elimination.
+   // Solve L y = b, then L' x = y, in place.
    x = b;
-
-   double Sum;
-   for (int i = 0; i < N; i++) {
-      Sum = x(i,0);
-      for (int j = 0; j < i; ++j)
-         Sum -= L(i,j) * x(j,0);
-
-      x(i,0) = Sum / L(i,i);
-   }
-
-   // Solve L' x = y using back substitution.
-   // See Golub and Van Loan, 1983, Algorithm 4.1-2, page 53.
-   for (int i = N-1; i >= 0; --i) {
-      Sum = x(i,0);
-      for (int j=i+1; j<N; ++j)
-         Sum -= L(j,i) * x(j,0);
-
-      x(i,0) = Sum / L(i,i);
-   }
+   TriangularSolve(L, x, false, 1);
+   TriangularSolve(L, x, true, 1);
 }
 
 //=============================================================================
@@ -167,30 +410,154 @@ void CholeskySolve( const Matrix& L, const Matrix& b, Matrix& x )
 //
 // Notes:
 // o  The computation of the inverse is based upon the standard Cholesky
-//    decompostion.
-//
-// References:
-// o  Stewart, G., 1998, "Matrix Algorithms - Volume I: Basic Decompositions",
-//    SIAM, Philadelphia, 458pp., ISBN 0-89871-414-1.
+//    decompostion: inv(A) = inv(L)' inv(L), with inv(L) from TriangularSolve.
+//    The result is exactly symmetric.
 //=============================================================================
-void CholeskyInverse( const Matrix& L, Matrix& Ainv ) 
+void CholeskyInverse( const Matrix& L, Matrix& Ainv )
 {
    assert( L.nRows() > 0 );
    assert( L.nRows() == L.nCols() );
    const int N = L.nRows();
 
-   Matrix LL(L);
+   // Invert L by solving L X = I.
+   Matrix LL;
+   Identity(LL, N);
+   TriangularSolve(L, LL, false, 1);
+
+   // A = L L' --> Ainv = (L')~ L~ = (L~)' L~
+   Multiply_MtM( LL, LL, Ainv );
+}
+
+//=============================================================================
+// CholeskyUpdate
+//
+//    Overwrite the Cholesky decomposition L of A = LL' with the Cholesky
+//    decomposition of the rank-one update A + xx', in O(N^2) operations.
+//
+// Arguments:
+//    L     on entrance, the Cholesky decomposition of A;
+//          on exit, the Cholesky decomposition of A + xx'.
+//
+//    x     the (N x 1) update vector.
+//
+// Notes:
+// o  Adding an observation with basis row r and weight w to the normal
+//    equations is the update with x = sqrt(w) r.
+//
+// o  The update is carried out with a sequence of Givens rotations, one
+//    per column of L, following Golub and Van Loan (1996), Section 12.5.
+//    The update cannot fail.
+//=============================================================================
+void CholeskyUpdate( Matrix& L, const Matrix& x )
+{
+   assert( x.nCols() == 1 );
+   CholeskyUpdateBatch( L, x );
+}
+
+//=============================================================================
+// CholeskyDowndate
+//
+//    Overwrite the Cholesky decomposition L of A = LL' with the Cholesky
+//    decomposition of the rank-one downdate A - xx', in O(N^2) operations.
+//
+// Arguments:
+//    L     on entrance, the Cholesky decomposition of A;
+//          on exit, the Cholesky decomposition of A - xx', or unchanged if
+//          the downdate fails.
+//
+//    x     the (N x 1) downdate vector.
+//
+// Return:
+//    true  if the downdate was completed successfully;
+//    false if A - xx' is not positive definite, using the same test as
+//          CholeskyDecomposition.
+//
+// Notes:
+// o  Removing an observation with basis row r and weight w from the normal
+//    equations is the downdate with x = sqrt(w) r.
+//
+// o  The downdate is carried out with a sequence of hyperbolic rotations,
+//    one per column of L.
+//=============================================================================
+bool CholeskyDowndate( Matrix& L, const Matrix& x )
+{
+   assert( x.nCols() == 1 );
+   return CholeskyDowndateBatch( L, x );
+}
+
+//=============================================================================
+// CholeskyUpdateBatch
+//
+//    As CholeskyUpdate, for the rank-P update A + XX' with an (N x P) X:
+//    i.e. one rank-one update for each column of X.
+//
+// Notes:
+// o  All P rotations are applied to each column of L before moving on to
+//    the next, so L is swept only once. The result is the same as P calls
+//    to CholeskyUpdate.
+//=============================================================================
+void CholeskyUpdateBatch( Matrix& L, const Matrix& X )
+{
+   assert( L.nRows() == L.nCols() );
+   assert( X.nRows() == L.nRows() );
+
+   const int N = L.nRows();
+   const int P = X.nCols();
+
+   Matrix V( X );
 
-   // Invert L in place; remember that L is lower triangular.
    for (int k = 0; k < N; ++k) {
-      LL(k,k) = 1.0/LL(k,k);
+      for (int p = 0; p < P; ++p) {
+         const double r = hypot( L(k,k), V(k,p) );
+         const double c = r / L(k,k);
+         const double s = V(k,p) / L(k,k);
+         L(k,k) = r;
+
+         for (int i = k+1; i < N; ++i) {
+            L(i,k) = (L(i,k) + s*V(i,p)) / c;
+            V(i,p) = c*V(i,p) - s*L(i,k);
+         }
+      }
+   }
+}
+
+//=============================================================================
+// CholeskyDowndateBatch
+//
+//    As CholeskyDowndate, for the rank-P downdate A - XX' with an (N x P) X.
+//    If any of the intermediate matrices is not positive definite, false is
+//    returned and L is unchanged.
+//=============================================================================
+bool CholeskyDowndateBatch( Matrix& L, const Matrix& X )
+{
+   assert( L.nRows() == L.nCols() );
+   assert( X.nRows() == L.nRows() );
 
-      for (int i = 0; i < k; ++i)
-         LL(k,i) = -LL(k,k) * SumProduct( k-i, LL.Base(i,i), N, LL.Base(k,i) );
+   const int N = L.nRows();
+   const int P = X.nCols();
+
+   Matrix LL( L );
+   Matrix V( X );
+
+   for (int k = 0; k < N; ++k) {
+      for (int p = 0; p < P; ++p) {
+         const double r2 = (LL(k,k) - V(k,p)) * (LL(k,k) + V(k,p));
+         if (!(r2 >= MIN_DIVISOR)) return false;
+
+         const double r = sqrt(r2);
+         const double c = r / LL(k,k);
+         const double s = V(k,p) / LL(k,k);
+         LL(k,k) = r;
+
+         for (int i = k+1; i < N; ++i) {
+            LL(i,k) = (LL(i,k) - s*V(i,p)) / c;
+            V(i,p)  = c*V(i,p) - s*LL(i,k);
+         }
+      }
    }
 
-   // A = L L' --> Ainv = (L')~ L~ = (L~)' L~
-   Multiply_MtM( LL, LL, Ainv );
+   L = LL;
+   return true;
 }
 
 //=============================================================================
@@ -210,35 +577,20 @@ void CholeskyInverse( const Matrix& L, Matrix& Ainv )
 // o  Only the lower triangular portion of A is accessed, so only the lower
 //    triangular portion needs to be filled.
 //
-// o  The inversion in place for an lower triangular Matrix is based upon
-//    the pseudo-code given in Stewart (1998, p. 179).
+// o  This is a wrapper around CholeskyDecomposition and CholeskyInverse.
+//    false is returned if A is not positive definite.
 //
 // o  The matrices A and Ainv may be the same space in memory.
-//
-// References:
-// o  Stewart, G., 1998, "Matrix Algorithms - Volume I: Basic Decompositions",
-//    SIAM, Philadelphia, 458pp., ISBN 0-89871-414-1.
 //=============================================================================
 bool RSPDInv( const Matrix& A, Matrix& Ainv )
 {
    assert(isSquare(A));
-   const int N = A.nRows();
 
    // Compute the Cholesky decomposition of "A", putting the result in "L".
    Matrix L;
-   CholeskyDecomposition(A,L);
-
-   // Invert L in place; remember that L is lower triangular.
-   for (int k = 0; k < N; ++k) {
-      L(k,k) = 1.0/L(k,k);
-
-      for (int i = 0; i < k; ++i)
-         L(k,i) = -L(k,k) * SumProduct( k-i, L.Base(i,i), N, L.Base(k,i) );
-   }
-
-   // A = L L' --> Ainv = (L')~ L~ = (L~)' L~
-   Multiply_MtM( L, L, Ainv );
+   if (!CholeskyDecomposition(A,L)) return false;
 
+   CholeskyInverse(L, Ainv);
    return true;
 }
 
@@ -380,6 +732,127 @@ bool LeastSquaresSolve( const Matrix& A, const Matrix& B, Matrix& X )
 }
 
 
+//=============================================================================
+// TsqrFactor
+//
+// Purpose:
+//    Compute the upper triangular factor R of the QR factorization of a
+//    tall Matrix, A = QR, without forming Q, using the communication-avoiding
+//    "tall-skinny QR" (TSQR) algorithm.
+//
+// Arguments:
+//    A        (m x n) Matrix.
+//    nthreads the maximum number of threads; see ThreadCount.
+//    R        (n x n) upper triangular Matrix, on exit, with R'R = A'A.
+//
+// Notes:
+// o  The rows of A are split into blocks of TSQR_BLOCK_ROWS rows. Each
+//    block is reduced to its own (n x n) factor by Householder reflections,
+//    independently and in parallel. The factors are then merged in pairs,
+//    by reducing each stacked (2n x n) pair, until one factor remains.
+//
+// o  The diagonal of R may have either sign.
+//
+// o  To solve a least squares problem, factor the augmented Matrix [A,B];
+//    see TsqrSolve.
+//
+// References:
+// o  Demmel, J., Grigori, L., Hoemmen, M., and Langou, J., 2012,
+//    Communication-optimal parallel and sequential QR and LU
+//    factorizations, SIAM Journal on Scientific Computing, 34(1),
+//    A206-A239.
+//=============================================================================
+void TsqrFactor( const Matrix& A, int nthreads, Matrix& R )
+{
+   const int M = A.nRows();
+   const int N = A.nCols();
+
+   const int block_rows = std::max(TSQR_BLOCK_ROWS, N);
+   const int nblocks = std::max(1, (M + block_rows - 1) / block_rows);
+
+   // Reduce each block of rows.
+   std::vector<Matrix> factors(nblocks);
+
+   ParallelFor(0, nblocks, nthreads, [&](int b) {
+      const int first = b * block_rows;
+      const int count = std::min(M, first + block_rows) - first;
+
+      Matrix block(count, N, A.Base(first,0));
+      Triangularize(block, factors[b]);
+   });
+
+   // Merge the factors in pairs.
+   for (int stride = 1; stride < nblocks; stride *= 2) {
+      ParallelFor(0, (nblocks + 2*stride - 1) / (2*stride), nthreads, [&](int p) {
+         const int b = 2*p*stride;
+         if (b + stride >= nblocks) return;
+
+         Matrix stack(2*N, N);
+         std::copy(factors[b].begin(), factors[b].end(), stack.Base(0,0));
+         std::copy(factors[b+stride].begin(), factors[b+stride].end(), stack.Base(N,0));
+         Triangularize(stack, factors[b]);
+      });
+   }
+
+   R = factors[0];
+}
+
+//=============================================================================
+// TsqrSolve
+//
+// Purpose:
+//    As LeastSquaresSolve, compute the least-squares solution to the
+//    overdetermined system A X = B, using TsqrFactor.
+//
+// Arguments:
+//    A        (m x n) coefficient Matrix.
+//    B        (m x p) right-hand-side column Matrix.
+//    X        (n x p) solution column Matrix.
+//    nthreads the maximum number of threads; see ThreadCount.
+//
+// Return:
+//    true     if the solution is computed, and false otherwise.
+//
+// Notes:
+// o  As in LeastSquaresSolve, the augmented Matrix [A,B] is factored,
+//
+//       [A,B]  =  Q [R,Z]
+//                   [0,P]
+//
+//    and X is computed by back-substitution on R X = Z.
+//=============================================================================
+bool TsqrSolve( const Matrix& A, const Matrix& B, Matrix& X, int nthreads )
+{
+   assert(A.nRows() == B.nRows());
+
+   const int M = A.nRows();
+   const int N = A.nCols();
+   const int P = B.nCols();
+
+   Matrix AB(M, N+P);
+   for (int i = 0; i < M; ++i) {
+      std::copy(A.Base(i,0), A.Base(i,0) + N, AB.Base(i,0));
+      std::copy(B.Base(i,0), B.Base(i,0) + P, AB.Base(i,N));
+   }
+
+   Matrix R;
+   TsqrFactor(AB, nthreads, R);
+
+   X.Resize(N,P);
+   for (int i = N-1; i >= 0; --i) {
+      if (fabs(R(i,i)) < MIN_DIVISOR) return false;
+
+      for (int p = 0; p < P; ++p) {
+         double Sum = R(i,N+p);
+         for (int j = i+1; j < N; ++j)
+            Sum -= R(i,j) * X(j,p);
+         X(i,p) = Sum / R(i,i);
+      }
+   }
+   return true;
+}
+
+
 //=============================================================================
 // AffineTransformation
 //
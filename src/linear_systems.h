@@ -19,12 +19,22 @@
 //
 //=============================================================================
 bool CholeskyDecomposition( const Matrix& A, Matrix& L );
+bool CholeskyFactor( Matrix& A, int nthreads );
+void TriangularSolve( const Matrix& L, Matrix& B, bool transpose, int nthreads );
 void CholeskySolve( const Matrix& L, const Matrix& b, Matrix& x );
 void CholeskyInverse( const Matrix& L, Matrix& Ainv );
 
+void CholeskyUpdate( Matrix& L, const Matrix& x );
+bool CholeskyDowndate( Matrix& L, const Matrix& x );
+void CholeskyUpdateBatch( Matrix& L, const Matrix& X );
+bool CholeskyDowndateBatch( Matrix& L, const Matrix& X );
+
 bool RSPDInv( const Matrix& A, Matrix& Ainv );
 bool LeastSquaresSolve( const Matrix& A, const Matrix& B, Matrix& X );
 
+void TsqrFactor( const Matrix& A, int nthreads, Matrix& R );
+bool TsqrSolve( const Matrix& A, const Matrix& B, Matrix& X, int nthreads );
+
 void AffineTransformation( const Matrix& A, const Matrix& B, const Matrix& C, Matrix& D );
 
 
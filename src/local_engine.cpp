@@ -0,0 +1,216 @@
+//=============================================================================
+// local_engine.cpp
+//
+//    A version of the Engine that fits the quadratic model at one or more
+//    origins using only the observations in a search window around each.
+//
+// notes:
+// o  The windows are gathered with a k-d tree over the observation
+//    locations.
+//
+// o  One set of normal equations is kept for every (k,h) cell, about a
+//    fixed center. When the window moves from one origin to the next, only
+//    the observations that leave or enter the window are removed from, or
+//    added to, the sums; the sums are then translated to the new origin
+//    (see NormalEquations::Translate) before they are solved. Consecutive
+//    origins that are close together therefore cost little more than the
+//    change in their windows.
+//
+// o  The sums are rebuilt from scratch, about the current origin, whenever
+//    the updates since the last rebuild, including this one, would reach
+//    the number of observations in the window. This both picks the cheaper
+//    of the two and keeps the round-off from the removals bounded.
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#include <algorithm>
+#include <iterator>
+#include <math.h>
+#include <sstream>
+
+#include "kdtree.h"
+#include "local_engine.h"
+#include "normal_equations.h"
+#include "numerical_constants.h"
+#include "preprocess.h"
+
+//=============================================================================
+// LocalEngine
+//
+// Arguments:
+//    origins        the model origins, processed in the given order.
+//    k_alpha, ...   the conductivity and thickness distributions, as in
+//                   Engine.
+//    radius         the well buffer radius.
+//    obs            the observations.
+//    wells          the pumping wells.
+//    window         the search window about each origin.
+//    make_sink      called once per origin, with the origin's id, for the
+//                   sink that receives its results.
+//=============================================================================
+void LocalEngine(
+   const std::vector<OriginRecord>& origins,
+   double k_alpha, double k_beta, int k_count,
+   double h_alpha, double h_beta, int h_count,
+   double radius,
+   const ObsTable& obs,
+   const std::vector<WellRecord>& wells,
+   const SearchWindow& window,
+   const ResultSinkFactory& make_sink) {
+
+   // Manifest constants.
+   const int MINIMUM_COUNT = 10; // At least this many unique observation locations.
+
+   const int M = obs.size();     // number of observations
+   const int N = wells.size();   // number of pumping wells
+
+   const double* obs_x       = obs.x();
+   const double* obs_y       = obs.y();
+   const double* obs_head_ev = obs.head_ev();
+   const double* obs_head_sd = obs.head_sd();
+
+   // Deactivate observations that are too close to a pumping well, and
+   // compute the well potentials at the remaining ones.
+   std::vector<char> is_active(M, 1);
+   std::vector<double> Phi_wells(M, 0.0);
+
+   for (int m = 0; m < M; ++m) {
+      for (int n = 0; n < N; ++n) {
+         double separation_distance = hypot(obs_x[m]-wells[n].x, obs_y[m]-wells[n].y);
+         if (separation_distance < radius) {
+            is_active[m] = 0;
+            std::cout << " --Obs(" << m << ") deactivated due to proximity with Well(" << n << ")" << std::endl;
+         }
+      }
+      if (is_active[m])
+         Phi_wells[m] = WellPotential(obs_x[m], obs_y[m], wells);
+   }
+
+   // Compute the set-points for both k and h.
+   std::vector<double> k = SetPoints(k_alpha, k_beta, k_count);
+   std::vector<double> h = SetPoints(h_alpha, h_beta, h_count);
+
+   // One set of normal equations for each (k,h) cell, about (xc,yc).
+   std::vector<NormalEquations> cells(k_count * h_count);
+   double xc = 0.0;
+   double yc = 0.0;
+
+   auto Fold = [&]( int m, bool add ) {
+      double row[QUADRATIC_TERMS];
+      QuadraticBasis(obs_x[m] - xc, obs_y[m] - yc, row);
+
+      for (int i = 0; i < k_count; ++i) {
+         for (int j = 0; j < h_count; ++j) {
+            double Phi_ev, Phi_sd;
+            DischargePotential(obs_head_ev[m], obs_head_sd[m], k[i], h[j], Phi_ev, Phi_sd);
+            if (add)
+               cells[i*h_count + j].Add(row, 1.0/(Phi_sd*Phi_sd), Phi_ev - Phi_wells[m]);
+            else
+               cells[i*h_count + j].Remove(row, 1.0/(Phi_sd*Phi_sd), Phi_ev - Phi_wells[m]);
+         }
+      }
+   };
+
+   // The tree holds only the active observations, so that the nearest ones
+   // are never lost to the well buffers.
+   std::vector<int> active;
+   std::vector<double> active_x, active_y;
+   for (int m = 0; m < M; ++m) {
+      if (is_active[m]) {
+         active.push_back(m);
+         active_x.push_back(obs_x[m]);
+         active_y.push_back(obs_y[m]);
+      }
+   }
+
+   const double search_radius = (window.search_radius > 0) ? window.search_radius : INF;
+   KdTree tree(active_x.data(), active_y.data(), active.size());
+
+   std::vector<int> current;     // the sorted window now in the sums
+   std::vector<int> next;
+   std::vector<int> found;
+   std::vector<int> entering;
+   std::vector<int> leaving;
+   int updates = 0;              // since the last rebuild
+   bool empty = true;
+
+   std::vector<CellResult> row(h_count);
+
+   for (const OriginRecord& origin : origins) {
+
+      // Gather the observations in the window.
+      if (window.nearest > 0)
+         tree.Nearest(origin.x, origin.y, window.nearest, search_radius, found);
+      else
+         tree.Within(origin.x, origin.y, search_radius, found);
+
+      next.clear();
+      for (int a : found)
+         next.push_back(active[a]);
+      std::sort(next.begin(), next.end());
+
+      int Munique = CountUniqueLocations(obs, next);
+      if (Munique < MINIMUM_COUNT) {
+         std::stringstream message;
+         message << "Too few unique active observation locations at origin " << origin.id << ": "
+                 << Munique << " < " << MINIMUM_COUNT << std::endl;
+         throw TooFewObservations(message.str());
+      }
+
+      // Update the sums, or rebuild them about this origin.
+      entering.clear();
+      leaving.clear();
+      std::set_difference(next.begin(), next.end(), current.begin(), current.end(), std::back_inserter(entering));
+      std::set_difference(current.begin(), current.end(), next.begin(), next.end(), std::back_inserter(leaving));
+
+      const int changes = entering.size() + leaving.size();
+      if (empty || updates + changes >= static_cast<int>(next.size())) {
+         std::fill(cells.begin(), cells.end(), NormalEquations());
+         xc = origin.x;
+         yc = origin.y;
+         for (int m : next)
+            Fold(m, true);
+         updates = 0;
+         empty = false;
+      } else {
+         for (int m : leaving)
+            Fold(m, false);
+         for (int m : entering)
+            Fold(m, true);
+         updates += changes;
+      }
+      current.swap(next);
+
+      std::cout << "Origin " << origin.id << ": " << current.size() << " active observation data records at "
+                << Munique << " unique locations in the window." << std::endl;
+
+      // Solve the translated normal equations for every cell, and emit the
+      // results one row at a time.
+      std::unique_ptr<ResultSink> sink = make_sink(origin.id);
+      sink->Begin(k, h);
+
+      for (int i = 0; i < k_count; ++i) {
+         for (int j = 0; j < h_count; ++j) {
+            NormalEquations local = cells[i*h_count + j];
+            local.Translate(origin.x - xc, origin.y - yc);
+
+            Matrix XtWX, XtWY;
+            local.Assemble(XtWX, XtWY);
+
+            Matrix P_ev, P_cov;
+            std::tie(P_ev, P_cov) = SolveNormalEquations(XtWX, XtWY);
+
+            row[j] = ComputeCellResult(P_ev, P_cov);
+         }
+         sink->Row(i, row);
+      }
+
+      sink->End();
+   }
+}
@@ -0,0 +1,45 @@
+//=============================================================================
+// local_engine.h
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#ifndef LOCAL_ENGINE_H
+#define LOCAL_ENGINE_H
+
+#include <vector>
+
+#include "engine.h"
+#include "obs_table.h"
+#include "read_data.h"
+#include "result_sink.h"
+
+//-----------------------------------------------------------------------------
+// The observations that enter the fit at each origin: the (at most)
+// "nearest" observations closest to the origin, and only those within the
+// "search_radius". Zero means no limit on either.
+//-----------------------------------------------------------------------------
+struct SearchWindow {
+   double search_radius;
+   int    nearest;
+};
+
+//=============================================================================
+void LocalEngine(
+   const std::vector<OriginRecord>& origins,
+   double k_alpha, double k_beta, int k_count,
+   double h_alpha, double h_beta, int h_count,
+   double radius,
+   const ObsTable& obs,
+   const std::vector<WellRecord>& wells,
+   const SearchWindow& window,
+   const ResultSinkFactory& make_sink
+);
+
+//=============================================================================
+#endif  // LOCAL_ENGINE_H
@@ -11,121 +11,318 @@
 // version:
 //    30 June 2017
 //=============================================================================
+#include <cmath>
 #include <cstring>
 #include <ctime>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <sstream>
 
+#include "adaptive_engine.h"
+#include "binary_data.h"
+#include "bootstrap.h"
+#include "correlated_errors.h"
 #include "engine.h"
+#include "leave_one_out.h"
+#include "local_engine.h"
+#include "nested_models.h"
+#include "network_design.h"
 #include "now.h"
 #include "numerical_constants.h"
+#include "options.h"
+#include "polynomial_engine.h"
+#include "preprocess.h"
+#include "qmc_engine.h"
+#include "quadrature.h"
 #include "read_data.h"
+#include "scenario_engine.h"
+#include "snapshot_engine.h"
+#include "streaming_engine.h"
+#include "surrogate.h"
 #include "version.h"
 #include "write_results.h"
 
-
 //-----------------------------------------------------------------------------
-int main(int argc, char* argv[]) {
-   // Check the command line.
-   switch (argc) {
-      case 1: {
-         Usage();
-         return 0;
-      }
-      case 2: {
-         if ( strcmp(argv[1], "--help") == 0 )
-            Help();
-         else if ( strcmp(argv[1], "--version") == 0 )
-            Version();
-         else
+namespace {
+
+   //--------------------------------------------------------------------------
+   // Convert
+   //
+   //    Gimiwan --convert <obs|wells> <csv filename> <binary filename>
+   //
+   //    Read an observation or well .csv file and write it in the binary
+   //    columnar format, which later runs load without parsing.
+   //--------------------------------------------------------------------------
+   int Convert( const char* kind, const char* inpfilename, const char* outfilename ) {
+      try {
+         if ( strcmp(kind, "obs") == 0 ) {
+            std::vector<ObsRecord> obs = read_obs_data( inpfilename );
+            write_obs_binary( outfilename, obs );
+            std::cout << obs.size() << " observation data records converted from <" << inpfilename << "> to <" << outfilename << ">." << std::endl;
+         }
+         else if ( strcmp(kind, "wells") == 0 ) {
+            std::vector<WellRecord> wells = read_well_data( inpfilename );
+            write_well_binary( outfilename, wells );
+            std::cout << wells.size() << " well data records converted from <" << inpfilename << "> to <" << outfilename << ">." << std::endl;
+         }
+         else {
+            std::cerr << "ERROR: conversion kind = " << kind << " is not valid;  use obs or wells." << std::endl;
+            std::cerr << std::endl;
             Usage();
-         return 0;
+            return 2;
+         }
       }
-      case 13: {
-         Banner( std::cout );
-         break;
+      catch (std::runtime_error& e) {
+         std::cerr << e.what() << std::endl;
+         return 3;
       }
-      default: {
+      return 0;
+   }
+
+   //--------------------------------------------------------------------------
+   // Evaluate
+   //
+   //    Gimiwan --evaluate <surrogate filename> <k> <h>
+   //
+   //    Evaluate a surrogate written by --surrogate at (k,h), and write each
+   //    statistic with the surrogate's errors.
+   //--------------------------------------------------------------------------
+   int Evaluate( const char* filename, const char* k_text, const char* h_text ) {
+      double k = atof( k_text );
+      double h = atof( h_text );
+      if ( !(k > 0) || !(h > 0) ) {
+         std::cerr << "ERROR: k = " << k_text << " and h = " << h_text << " are not valid;  0 < k and 0 < h." << std::endl;
+         std::cerr << std::endl;
          Usage();
-         return 1;
+         return 2;
+      }
+
+      try {
+         const Surrogate surrogate = ReadSurrogate( filename );
+         const CellResult cell = surrogate( k, h );
+
+         std::cout.precision(17);
+         std::cout << "statistic,value,rms_error,max_error" << std::endl;
+         for ( int f = 0; f < RESULT_FIELD_COUNT; ++f ) {
+            std::cout << RESULT_FIELDS[f].name << ',' << RESULT_FIELDS[f].scale * (cell.*RESULT_FIELDS[f].value) << ','
+                      << surrogate.rms_error[f] << ',' << surrogate.max_error[f] << std::endl;
+         }
+      }
+      catch (InvalidSurrogateFile& e) {
+         std::cerr << e.what() << std::endl;
+         return 3;
+      }
+      return 0;
+   }
+
+   //--------------------------------------------------------------------------
+   // ScenarioName
+   //
+   //    The name of the scenario read from "filename": the file name without
+   //    its directory or extension.
+   //--------------------------------------------------------------------------
+   std::string ScenarioName( const std::string& filename ) {
+      std::string::size_type slash = filename.find_last_of("/\\");
+      std::string name = (slash == std::string::npos) ? filename : filename.substr(slash+1);
+
+      std::string::size_type dot = name.find_last_of('.');
+      if (dot != std::string::npos && dot > 0)
+         name.erase(dot);
+      return name;
+   }
+
+   //--------------------------------------------------------------------------
+   // WriteCsvFile
+   //
+   //    Open "filename", call write(file) to fill it, and check the result.
+   //--------------------------------------------------------------------------
+   template <typename F>
+   void WriteCsvFile( const std::string& filename, F write ) {
+      std::ofstream outfile( filename );
+      if ( outfile.fail() ) {
+         std::stringstream message;
+         message << "Could not open <" << filename << "> for output.";
+         throw InvalidOutputFile(message.str());
+      }
+
+      write( outfile );
+
+      outfile.close();
+      if ( outfile.fail() ) {
+         std::stringstream message;
+         message << "Writing <" << filename << "> failed.";
+         throw InvalidOutputFile(message.str());
       }
    }
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, char* argv[]) {
+   // Check the command line for the stand-alone commands.
+   if ( argc == 1 ) {
+      Usage();
+      return 0;
+   }
+   if ( argc == 2 && strcmp(argv[1], "--help") == 0 ) {
+      Help();
+      return 0;
+   }
+   if ( argc == 2 && strcmp(argv[1], "--version") == 0 ) {
+      Version();
+      return 0;
+   }
+   if ( strcmp(argv[1], "--convert") == 0 ) {
+      if ( argc == 5 )
+         return Convert( argv[2], argv[3], argv[4] );
+      Usage();
+      return 1;
+   }
+   if ( strcmp(argv[1], "--evaluate") == 0 ) {
+      if ( argc == 5 )
+         return Evaluate( argv[2], argv[3], argv[4] );
+      Usage();
+      return 1;
+   }
+
+   // Separate the options from the positional arguments.
+   Options options;
+   std::vector<std::string> args;
+
+   try {
+      args = ParseOptions( argc, argv, options );
+   }
+   catch (InvalidOption& e) {
+      std::cerr << e.what() << std::endl;
+      std::cerr << std::endl;
+      Usage();
+      return 2;
+   }
+
+   if ( args.size() != 13 ) {
+      Usage();
+      return 1;
+   }
+   Banner( std::cout );
 
    // Gimiwan <xo> <yo> <k alpha> <k beta> <k count> <h alpha> <h beta> <h count> <radius> <obs file> <wells file> <output root>
    // [0]     [1]  [2]  [3]       [4]      [5]       [6]       [7]      [8]       [9]      [10]       [11]         [12]
 
    // Get <xo> and <yo>.
-   double xo = atof( argv[1] );
-   double yo = atof( argv[2] );
+   double xo = atof( args[1].c_str() );
+   double yo = atof( args[2].c_str() );
 
    // Get and check the hydraulic conductivity distribution.
-   double k_alpha = atof( argv[3] );
+   double k_alpha = atof( args[3].c_str() );
 
-   double k_beta  = atof( argv[4] );
+   double k_beta  = atof( args[4].c_str() );
    if ( k_beta <= EPS ) {
-      std::cerr << "ERROR: k_beta = " << argv[4] << " is not valid;  0 < k_beta." << std::endl;
+      std::cerr << "ERROR: k_beta = " << args[4] << " is not valid;  0 < k_beta." << std::endl;
       std::cerr << std::endl;
       Usage();
       return 2;
    }
 
-   int k_count = atoi( argv[5] );
+   int k_count = atoi( args[5].c_str() );
    if ( k_count < 1 ) {
-      std::cerr << "ERROR: k_count = " << argv[5] << " is not valid;  0 < k_count." << std::endl;
+      std::cerr << "ERROR: k_count = " << args[5] << " is not valid;  0 < k_count." << std::endl;
       std::cerr << std::endl;
       Usage();
       return 2;
    }
 
    // Get and check the aquifer thickness distribution.
-   double h_alpha = atof( argv[6] );
+   double h_alpha = atof( args[6].c_str() );
 
-   double h_beta = atof( argv[7] );
+   double h_beta = atof( args[7].c_str() );
    if ( h_beta <= EPS ) {
-      std::cerr << "ERROR: h_beta = " << argv[7] << " is not valid;  0 < h_beta." << std::endl;
+      std::cerr << "ERROR: h_beta = " << args[7] << " is not valid;  0 < h_beta." << std::endl;
       std::cerr << std::endl;
       Usage();
       return 2;
    }
 
-   int h_count = atoi( argv[8] );
+   int h_count = atoi( args[8].c_str() );
    if ( h_count < 1 ) {
-      std::cerr << "ERROR: h_count = " << argv[5] << " is not valid;  0 < h_count." << std::endl;
+      std::cerr << "ERROR: h_count = " << args[8] << " is not valid;  0 < h_count." << std::endl;
       std::cerr << std::endl;
       Usage();
       return 2;
    }
 
    // Get and check the buffer radius.
-   double radius = atof( argv[9] );
+   double radius = atof( args[9].c_str() );
    if ( radius < 0 ) {
-      std::cerr << "ERROR: buffer radius = " << argv[9] << " is not valid;  0 <= buffer radius." << std::endl;
+      std::cerr << "ERROR: buffer radius = " << args[9] << " is not valid;  0 <= buffer radius." << std::endl;
       std::cerr << std::endl;
       Usage();
       return 2;
    }
 
-   // Read in the observation data from the specified <obs file>.
-   std::vector<ObsRecord> obs;
+   // Read in the observation data from the specified <obs file>. In the
+   // streaming mode the observations are read by the engine itself.
+   ObsTable obs;
+   std::vector<Snapshot> snapshots;
 
-   try {
-      obs = read_obs_data( argv[10] );
-      std::cout << obs.size() << " observation data records read from <" << argv[10] << ">." << std::endl;
-   }
-   catch (InvalidObsFile& e) {
-      std::cerr << e.what() << std::endl;
-      return 3;
+   if ( options.snapshots ) {
+      try {
+         std::vector<SnapshotRecord> records = read_snapshot_data( args[10] );
+         snapshots = BuildSnapshots( records );
+         std::cout << records.size() << " observation data records in " << snapshots.size() << " snapshots read from <" << args[10] << ">." << std::endl;
+      }
+      catch (InvalidObsFile& e) {
+         std::cerr << e.what() << std::endl;
+         return 3;
+      }
+      catch (InvalidObsRecord& e) {
+         std::cerr << e.what() << std::endl;
+         return 3;
+      }
    }
-   catch (InvalidObsRecord& e) {
-      std::cerr << e.what() << std::endl;
-      return 3;
+   else if ( !options.stream ) {
+      try {
+         obs = read_obs_table( args[10] );
+         std::cout << obs.size() << " observation data records read from <" << args[10] << ">." << std::endl;
+
+         if ( options.aggregate >= 0 ) {
+            int count = obs.size();
+            obs = AggregateColocated( obs, options.aggregate );
+            std::cout << count << " observation data records aggregated to " << obs.size() << " locations." << std::endl;
+         }
+
+         if ( options.thin > 0 ) {
+            ObsTable dense = obs;
+            obs = AggregateColocated( obs, options.thin );
+
+            double change, bound;
+            CovarianceChange( xo, yo, exp(k_alpha), exp(h_alpha), dense, obs, change, bound );
+
+            std::cout << dense.size() << " observation data records thinned to " << obs.size()
+                      << " (effective number " << EffectiveCount(dense) << " -> " << EffectiveCount(obs) << ")." << std::endl;
+            std::cout << "Relative change in the parameter covariance at the median (k,h): "
+                      << change << " (bound " << bound << ")." << std::endl;
+         }
+      }
+      catch (InvalidObsFile& e) {
+         std::cerr << e.what() << std::endl;
+         return 3;
+      }
+      catch (InvalidObsRecord& e) {
+         std::cerr << e.what() << std::endl;
+         return 3;
+      }
+      catch (CholeskyDecompositionFailed& e) {
+         std::cerr << "Too few observations remain after thinning. " << e.what() << std::endl;
+         return 4;
+      }
    }
 
    // Read in the well data from the specified <well file>.
    std::vector<WellRecord> wells;
 
    try {
-      wells = read_well_data( argv[11] );
-      std::cout << wells.size() << " well data records read from <" << argv[11] << ">." << std::endl;
+      wells = read_well_data( args[11] );
+      std::cout << wells.size() << " well data records read from <" << args[11] << ">." << std::endl;
    }
    catch (InvalidWellFile& e) {
       std::cerr << e.what() << std::endl;
@@ -136,11 +333,209 @@ int main(int argc, char* argv[]) {
       return 3;
    }
 
-   // Execute all of the computations.
-   Results results;
+   // Read in the wells of the additional pumping scenarios, if any. The
+   // <well file> is the base scenario.
+   std::vector<Scenario> scenarios;
+
+   if ( !options.scenarios.empty() ) {
+      scenarios.push_back( Scenario{"", wells} );
+
+      for ( const std::string& filename : options.scenarios ) {
+         try {
+            scenarios.push_back( Scenario{ScenarioName(filename), read_well_data(filename)} );
+            std::cout << scenarios.back().wells.size() << " well data records read from <" << filename << ">." << std::endl;
+         }
+         catch (InvalidWellFile& e) {
+            std::cerr << e.what() << std::endl;
+            return 3;
+         }
+         catch (InvalidWellRecord& e) {
+            std::cerr << e.what() << std::endl;
+            return 3;
+         }
+      }
+   }
+
+   // Read in the shared error factors from the specified <factor file>, if
+   // any.
+   ErrorFactors factors;
+
+   if ( !options.factors.empty() ) {
+      try {
+         std::vector<FactorRecord> records = read_factor_data( options.factors );
+         factors = BuildErrorFactors( obs, records );
+         std::cout << records.size() << " factor data records read from <" << options.factors << ">." << std::endl;
+      }
+      catch (InvalidFactorFile& e) {
+         std::cerr << e.what() << std::endl;
+         return 3;
+      }
+      catch (InvalidFactorRecord& e) {
+         std::cerr << e.what() << std::endl;
+         return 3;
+      }
+   }
+
+   // Read in the model origins from the specified <origin file>, if any.
+   std::vector<OriginRecord> origins;
+
+   if ( !options.origins.empty() ) {
+      try {
+         origins = read_origin_data( options.origins );
+         std::cout << origins.size() << " origin data records read from <" << options.origins << ">." << std::endl;
+      }
+      catch (InvalidOriginFile& e) {
+         std::cerr << e.what() << std::endl;
+         return 3;
+      }
+      catch (InvalidOriginRecord& e) {
+         std::cerr << e.what() << std::endl;
+         return 3;
+      }
+   }
+
+   // Read in the candidate observation sites from the specified <candidate
+   // file>, if any.
+   std::vector<CandidateRecord> candidates;
+
+   if ( !options.design.empty() ) {
+      try {
+         candidates = read_candidate_data( options.design );
+         std::cout << candidates.size() << " candidate data records read from <" << options.design << ">." << std::endl;
+      }
+      catch (InvalidCandidateFile& e) {
+         std::cerr << e.what() << std::endl;
+         return 3;
+      }
+      catch (InvalidCandidateRecord& e) {
+         std::cerr << e.what() << std::endl;
+         return 3;
+      }
+   }
+
+   // Execute all of the computations. The results are handed to the output
+   // sink row by row, as they are computed, and written on a background
+   // thread while the computation continues.
+   ResultSinkFactory make_sink = [&options]( const std::string& root ) {
+      std::unique_ptr<ResultSink> output;
+      if ( options.format == "npz" )
+         output.reset( new NpzResultSink( root, options.fit ) );
+      else
+         output.reset( new CsvResultSink( root, options.precision, options.fit, options.threads ) );
+      return std::unique_ptr<ResultSink>( new AsyncResultSink( std::move(output), 64 ) );
+   };
 
    try {
-       results = Engine(xo, yo, k_alpha, k_beta, k_count, h_alpha, h_beta, h_count, radius, obs, wells);
+      if ( options.IsLocal() ) {
+         // Each origin from an origin file gets its own output files,
+         // named <out fileroot>_<origin id>.
+         const bool named = !options.origins.empty();
+         if ( !named )
+            origins.push_back( OriginRecord{"(xo,yo)", xo, yo} );
+
+         ResultSinkFactory make_origin_sink = [&]( const std::string& id ) {
+            return make_sink( named ? args[12] + "_" + id : args[12] );
+         };
+
+         SearchWindow window = { options.search, options.nearest };
+         LocalEngine(origins, k_alpha, k_beta, k_count, h_alpha, h_beta, h_count, radius, obs, wells, window, make_origin_sink);
+      }
+      else if ( options.snapshots ) {
+         // Each snapshot gets its own output files, named
+         // <out fileroot>_<snapshot ID>.
+         ResultSinkFactory make_snapshot_sink = [&]( const std::string& name ) {
+            return make_sink( args[12] + "_" + name );
+         };
+
+         SnapshotEngine(xo, yo, k_alpha, k_beta, k_count, h_alpha, h_beta, h_count, radius, snapshots, wells, options.threads, make_snapshot_sink);
+      }
+      else if ( !scenarios.empty() ) {
+         // Each additional scenario gets its own output files, named
+         // <out fileroot>_<scenario name>.
+         ResultSinkFactory make_scenario_sink = [&]( const std::string& name ) {
+            return make_sink( name.empty() ? args[12] : args[12] + "_" + name );
+         };
+
+         ScenarioEngine(xo, yo, k_alpha, k_beta, k_count, h_alpha, h_beta, h_count, radius, obs, scenarios, options.threads, make_scenario_sink);
+      }
+      else if ( options.qmc > 0 ) {
+         // The samples replace the (k,h) grid.
+         WriteCsvFile( args[12] + "_qmc.csv", [&]( std::ostream& samples_out ) {
+            WriteCsvFile( args[12] + "_qmc_summary.csv", [&]( std::ostream& summary_out ) {
+               QmcEngine(xo, yo, k_alpha, k_beta, h_alpha, h_beta, radius, options.rsd, obs, wells,
+                  options.qsd, options.qmc, options.target, options.seed, options.threads, samples_out, summary_out);
+            });
+         });
+      }
+      else if ( options.surrogate > 0 ) {
+         // The surrogate replaces the (k,h) grid.
+         const Surrogate surrogate = FitSurrogate(xo, yo, k_alpha, k_beta, h_alpha, h_beta, options.surrogate, radius, obs, wells, options.threads);
+         WriteCsvFile( args[12] + "_surrogate.csv", [&]( std::ostream& out ) {
+            WriteSurrogate( out, surrogate );
+         });
+      }
+      else {
+         std::unique_ptr<ResultSink> sink = make_sink( args[12] );
+
+         if ( options.order != 2 )
+            PolynomialEngine(options.order, xo, yo, k_alpha, k_beta, k_count, h_alpha, h_beta, h_count, radius, obs, wells, options.threads, *sink);
+         else if ( !options.factors.empty() )
+            CorrelatedEngine(xo, yo, k_alpha, k_beta, k_count, h_alpha, h_beta, h_count, radius, obs, wells, factors, options.threads, *sink);
+         else if ( options.stream )
+            StreamingEngine(xo, yo, k_alpha, k_beta, k_count, h_alpha, h_beta, h_count, radius, args[10], wells, options.chunk_size, *sink);
+         else if ( options.quadrature ) {
+            // The grid is at the Gauss-Hermite nodes, and the integrals
+            // over the grid are accumulated as the rows go by.
+            std::vector<double> k, k_weights, h, h_weights;
+            QuadraturePoints(k_alpha, k_beta, k_count, k, k_weights);
+            QuadraturePoints(h_alpha, h_beta, h_count, h, h_weights);
+
+            QuadratureResultSink quadrature( *sink, k_weights, h_weights );
+            Engine(xo, yo, k, h, radius, obs, wells, options.qr ? FIT_QR : FIT_NORMAL_EQUATIONS, options.threads, quadrature);
+
+            const std::string quadfilename = args[12] + "_quadrature.csv";
+            WriteCsvFile( quadfilename, [&]( std::ostream& out ) {
+               WriteQuadratureSummaries( out, quadrature.Summaries() );
+            });
+            std::cout << "Output file <" << quadfilename << "> created. " << std::endl;
+         }
+         else if ( options.adaptive >= 0 ) {
+            const std::string adaptivefilename = args[12] + "_adaptive.csv";
+            WriteCsvFile( adaptivefilename, [&]( std::ostream& out ) {
+               AdaptiveEngine(xo, yo, k_alpha, k_beta, k_count, h_alpha, h_beta, h_count, radius, obs, wells,
+                  options.coarse, options.adaptive, options.threads, *sink, out);
+            });
+            std::cout << "Output file <" << adaptivefilename << "> created. " << std::endl;
+         }
+         else
+            Engine(xo, yo, k_alpha, k_beta, k_count, h_alpha, h_beta, h_count, radius, obs, wells,
+               options.qr ? FIT_QR : FIT_NORMAL_EQUATIONS, options.threads, *sink);
+      }
+
+      if ( !options.origins.empty() )
+         std::cout << "Output files for " << origins.size() << " origins with root name <" << args[12] << "> created. " << std::endl;
+      else if ( options.snapshots )
+         std::cout << "Output files for " << snapshots.size() << " snapshots with root name <" << args[12] << "> created. " << std::endl;
+      else if ( !scenarios.empty() )
+         std::cout << "Output files for " << scenarios.size() << " scenarios with root name <" << args[12] << "> created. " << std::endl;
+      else if ( options.qmc > 0 )
+         std::cout << "Output files <" << args[12] << "_qmc.csv> and <" << args[12] << "_qmc_summary.csv> created. " << std::endl;
+      else if ( options.surrogate > 0 )
+         std::cout << "Output file <" << args[12] << "_surrogate.csv> created. " << std::endl;
+      else if ( options.format == "npz" )
+         std::cout << "Output file <" << args[12] << ".npz> created. " << std::endl;
+      else if ( options.fit )
+         std::cout << "Nine output files with root name <" << args[12] << "> created. " << std::endl;
+      else
+         std::cout << "Six output files with root name <" << args[12] << "> created. " << std::endl;
+   }
+   catch (InvalidObsFile& e) {
+      std::cerr << e.what() << std::endl;
+      return 3;
+   }
+   catch (InvalidObsRecord& e) {
+      std::cerr << e.what() << std::endl;
+      return 3;
    }
    catch (TooFewObservations& e) {
       std::cerr << e.what() << std::endl;
@@ -150,15 +545,62 @@ int main(int argc, char* argv[]) {
       std::cerr << e.what() << std::endl;
       return 4;
    }
+   catch (QRFactorizationFailed& e) {
+      std::cerr << e.what() << std::endl;
+      return 4;
+   }
+   catch (InvalidOutputFile& e) {
+      std::cerr << e.what() << std::endl;
+      return 4;
+   }
    catch (...) {
       std::cerr << "The Gimiwan Engine failed for an unknown reason." << std::endl;
       throw;
    }
 
-   // Write out the results to the specified output data file.
+   // Compute and write the leave-one-out diagnostics, the nested model
+   // comparison, the bootstrap distributions, and the network design.
    try {
-      write_results( argv[12], results );
-      std::cout << "Six output files with root name <" << argv[12] << "> created. " << std::endl;
+      if ( options.loo ) {
+         const std::string loofilename = args[12] + "_loo.csv";
+         WriteCsvFile( loofilename, [&]( std::ostream& out ) {
+            LeaveOneOutEngine(xo, yo, k_alpha, k_beta, k_count, h_alpha, h_beta, h_count, radius, obs, wells, options.threads, out);
+         });
+         std::cout << "Output file <" << loofilename << "> created. " << std::endl;
+      }
+
+      if ( options.nested ) {
+         const std::string nestedfilename = args[12] + "_nested.csv";
+         WriteCsvFile( nestedfilename, [&]( std::ostream& out ) {
+            NestedModelEngine(xo, yo, k_alpha, k_beta, k_count, h_alpha, h_beta, h_count, radius, obs, wells, options.threads, out);
+         });
+         std::cout << "Output file <" << nestedfilename << "> created. " << std::endl;
+      }
+
+      if ( options.bootstrap > 0 ) {
+         const std::string bootfilename = args[12] + "_bootstrap.csv";
+         WriteCsvFile( bootfilename, [&]( std::ostream& out ) {
+            BootstrapEngine(xo, yo, k_alpha, k_beta, k_count, h_alpha, h_beta, h_count, radius, obs, wells,
+               options.bootstrap, options.seed, options.threads, out);
+         });
+         std::cout << "Output file <" << bootfilename << "> created. " << std::endl;
+      }
+
+      if ( !options.design.empty() ) {
+         const std::string addfilename = args[12] + "_design.csv";
+         const std::string retirefilename = args[12] + "_retire.csv";
+         WriteCsvFile( addfilename, [&]( std::ostream& add_out ) {
+            WriteCsvFile( retirefilename, [&]( std::ostream& retire_out ) {
+               NetworkDesignEngine(xo, yo, k_alpha, k_beta, k_count, h_alpha, h_beta, h_count, radius, obs, wells,
+                  candidates, options.select, options.threads, add_out, retire_out);
+            });
+         });
+         std::cout << "Output files <" << addfilename << "> and <" << retirefilename << "> created. " << std::endl;
+      }
+   }
+   catch (CholeskyDecompositionFailed& e) {
+      std::cerr << e.what() << std::endl;
+      return 4;
    }
    catch (InvalidOutputFile& e) {
       std::cerr << e.what() << std::endl;
@@ -0,0 +1,255 @@
+//=============================================================================
+// nested_models.cpp
+//
+//    Compare the linear, quadratic, and cubic discharge potential models in
+//    every (k,h) cell, from one accumulation and one factorization.
+//
+// notes:
+// o  The cubic basis is used in ascending order, the reverse of the
+//    PolynomialModel order, so that the linear and quadratic bases are its
+//    leading 3 and 6 terms. The normal equations of each smaller model are
+//    then the leading principal sub-blocks of the cubic X'WX and X'Wy, and
+//    the Cholesky factor of each sub-block is the leading sub-block of the
+//    cubic factor L.
+//
+// o  With z = inv(L) X'Wy, computed once, the model with p terms has
+//
+//       P_ev = inv(L_p') z_p,   P_cov = inv(L_p L_p'),   WRSS = y'Wy - z_p'z_p,
+//
+//    where L_p and z_p are the leading p x p and p x 1 blocks. Each smaller
+//    model costs only its own back substitution.
+//
+// o  The observation variances are known, so the log likelihood of the
+//    heads, as in SetGoodnessOfFit, is
+//
+//       -2 log L = WRSS + M log(2 pi) + 2 sum( log(head_sd) ),
+//
+//    and AIC = -2 log L + 2p, BIC = -2 log L + p log(M). The constant does
+//    not depend on (k,h), so the criteria are comparable between cells as
+//    well as between models.
+//
+// o  WRSS is the difference of two nearly equal sums when the fit is good,
+//    and so carries an absolute error of a few units in the last place of
+//    y'Wy. It is bounded below by zero.
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+#include "engine.h"
+#include "linear_systems.h"
+#include "nested_models.h"
+#include "numerical_constants.h"
+#include "parallel_for-inl.h"
+#include "preprocess.h"
+
+//-----------------------------------------------------------------------------
+namespace {
+
+   //--------------------------------------------------------------------------
+   // A copy of the leading nrows x ncols block of A.
+   //--------------------------------------------------------------------------
+   Matrix LeadingBlock( const Matrix& A, int nrows, int ncols ) {
+      Matrix B(nrows, ncols);
+      for (int i = 0; i < nrows; ++i)
+         for (int j = 0; j < ncols; ++j)
+            B(i,j) = A(i,j);
+      return B;
+   }
+}
+
+//=============================================================================
+// NestedBasis
+//
+//    Fill row[0..NESTED_TERMS-1] with the cubic basis in ascending order.
+//=============================================================================
+void NestedBasis( double dx, double dy, double* row ) {
+   double descending[NESTED_TERMS];
+   PolynomialModel<MAXIMUM_ORDER>::Basis(dx, dy, descending);
+   std::reverse_copy(descending, descending + NESTED_TERMS, row);
+}
+
+//=============================================================================
+// FitNestedModels
+//
+// Arguments:
+//    rows           the M basis rows, NESTED_TERMS values each, from
+//                   NestedBasis.
+//    w, y           the M inverse variances and right-hand-side values.
+//    log_head_sd    the sum of log(head_sd) over the M observations; see
+//                   HeadLogSdSum.
+//
+// Returns:
+//    The fits of the models of order MINIMUM_ORDER and up, in ascending
+//    order. If the cubic normal equations are singular, only the smaller
+//    models that can be fit are returned.
+//
+// Notes:
+// o  Throws CholeskyDecompositionFailed if even the linear model cannot be
+//    fit.
+//=============================================================================
+std::vector<NestedFit> FitNestedModels(
+   const std::vector<double>& rows,
+   const std::vector<double>& w,
+   const std::vector<double>& y,
+   double log_head_sd) {
+
+   const int M = w.size();
+   const int N = NESTED_TERMS;
+
+   PolynomialEquations<MAXIMUM_ORDER> equations;
+   double yWy = 0.0;
+   for (int m = 0; m < M; ++m) {
+      equations.Add(&rows[m*N], w[m], y[m]);
+      yWy += w[m] * y[m] * y[m];
+   }
+
+   Matrix XtWX, XtWY;
+   equations.Assemble(XtWX, XtWY);
+
+   // Factor the largest leading block that is positive definite.
+   int largest = MAXIMUM_ORDER;
+   Matrix L;
+   while (largest >= MINIMUM_ORDER) {
+      const int p = PolynomialTerms(largest);
+      if (CholeskyDecomposition(LeadingBlock(XtWX, p, p), L))
+         break;
+      --largest;
+   }
+   if (largest < MINIMUM_ORDER) {
+      std::stringstream message;
+      message << "Cholesky Decomposition failed." << std::endl;
+      throw CholeskyDecompositionFailed(message.str());
+   }
+
+   // z = inv(L) X'Wy; the leading p entries belong to the model with p terms.
+   Matrix z = LeadingBlock(XtWY, L.nRows(), 1);
+   TriangularSolve(L, z, false, 1);
+
+   const double constant = M*std::log(TWO_PI) + 2.0*log_head_sd;
+
+   std::vector<NestedFit> fits;
+   double zz = 0.0;
+   int previous = 0;
+
+   for (int order = MINIMUM_ORDER; order <= largest; ++order) {
+      const int p = PolynomialTerms(order);
+      for (int t = previous; t < p; ++t)
+         zz += z(t,0) * z(t,0);
+      previous = p;
+
+      Matrix Lp = LeadingBlock(L, p, p);
+      Matrix P = LeadingBlock(z, p, 1);
+      TriangularSolve(Lp, P, true, 1);
+
+      Matrix C;
+      CholeskyInverse(Lp, C);
+
+      // Return to the descending PolynomialModel order.
+      Matrix P_ev(p, 1);
+      Matrix P_cov(p, p);
+      for (int a = 0; a < p; ++a) {
+         P_ev(a,0) = P(p-1-a, 0);
+         for (int b = 0; b < p; ++b)
+            P_cov(a,b) = C(p-1-a, p-1-b);
+      }
+
+      NestedFit fit;
+      fit.order = order;
+      fit.terms = p;
+      fit.wrss  = std::max(yWy - zz, 0.0);
+      fit.aic   = fit.wrss + constant + 2.0*p;
+      fit.bic   = fit.wrss + constant + p*std::log(static_cast<double>(M));
+      fit.cell  = ComputePolynomialCellResult(order, P_ev, P_cov);
+      fits.push_back(fit);
+   }
+
+   return fits;
+}
+
+//=============================================================================
+// NestedModelEngine
+//
+//    Fit the nested models in every (k,h) cell and write one line per cell
+//    and model.
+//
+// Arguments:
+//    xo, yo         the model origin.
+//    k_alpha, ...   the conductivity and thickness distributions, as in
+//                   Engine.
+//    radius         the well buffer radius.
+//    obs            the observations.
+//    wells          the pumping wells.
+//    nthreads       the maximum number of threads; see ThreadCount.
+//    out            the output stream.
+//=============================================================================
+void NestedModelEngine(
+   double xo, double yo,
+   double k_alpha, double k_beta, int k_count,
+   double h_alpha, double h_beta, int h_count,
+   double radius,
+   const ObsTable& obs,
+   const std::vector<WellRecord>& wells,
+   int nthreads,
+   std::ostream& out) {
+
+   const std::vector<int> active = ActiveIndices(obs, wells, radius, false);
+   const int M = active.size();
+   const int N = NESTED_TERMS;
+   const double log_head_sd = HeadLogSdSum(obs, active);
+
+   // The basis rows and the well potentials do not depend on k or h.
+   std::vector<double> rows(M*N);
+   std::vector<double> Phi_wells(M);
+   for (int m = 0; m < M; ++m) {
+      NestedBasis(obs.x()[active[m]] - xo, obs.y()[active[m]] - yo, &rows[m*N]);
+      Phi_wells[m] = WellPotential(obs.x()[active[m]], obs.y()[active[m]], wells);
+   }
+
+   std::vector<double> k = SetPoints(k_alpha, k_beta, k_count);
+   std::vector<double> h = SetPoints(h_alpha, h_beta, h_count);
+
+   std::vector<std::vector<NestedFit>> fits(k_count*h_count);
+
+   ParallelFor(0, k_count*h_count, nthreads, [&](int c) {
+      const int i = c / h_count;
+      const int j = c % h_count;
+
+      std::vector<double> w(M);
+      std::vector<double> y(M);
+      for (int m = 0; m < M; ++m) {
+         double Phi_ev, Phi_sd;
+         DischargePotential(obs.head_ev()[active[m]], obs.head_sd()[active[m]], k[i], h[j], Phi_ev, Phi_sd);
+         w[m] = 1.0/(Phi_sd*Phi_sd);
+         y[m] = Phi_ev - Phi_wells[m];
+      }
+
+      fits[c] = FitNestedModels(rows, w, y, log_head_sd);
+   });
+
+   out << "k,h,order,terms,wrss,aic,bic";
+   for (int f = 0; f < RESULT_FIELD_COUNT; ++f)
+      out << ',' << RESULT_FIELDS[f].name;
+   out << '\n';
+   out.precision(17);
+
+   for (int i = 0; i < k_count; ++i) {
+      for (int j = 0; j < h_count; ++j) {
+         for (const NestedFit& fit : fits[i*h_count + j]) {
+            out << k[i] << ',' << h[j] << ',' << fit.order << ',' << fit.terms << ','
+                << fit.wrss << ',' << fit.aic << ',' << fit.bic;
+            for (int f = 0; f < RESULT_FIELD_COUNT; ++f)
+               out << ',' << RESULT_FIELDS[f].scale * (fit.cell.*RESULT_FIELDS[f].value);
+            out << '\n';
+         }
+      }
+   }
+}
@@ -0,0 +1,63 @@
+//=============================================================================
+// nested_models.h
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#ifndef NESTED_MODELS_H
+#define NESTED_MODELS_H
+
+#include <ostream>
+#include <vector>
+
+#include "obs_table.h"
+#include "polynomial_engine.h"
+#include "polynomial_model-inl.h"
+#include "read_data.h"
+#include "result_sink.h"
+
+//-----------------------------------------------------------------------------
+// The number of terms in the largest of the nested models.
+//-----------------------------------------------------------------------------
+const int NESTED_TERMS = PolynomialModel<MAXIMUM_ORDER>::TERMS;
+
+//-----------------------------------------------------------------------------
+// The fit of one of the nested models in one (k,h) cell.
+//-----------------------------------------------------------------------------
+struct NestedFit {
+   int    order;
+   int    terms;
+   double wrss;            // the weighted residual sum of squares, y'Wy - z'z
+   double aic;             // -2 log likelihood + 2 terms
+   double bic;             // -2 log likelihood + terms log(M)
+   CellResult cell;
+};
+
+//-----------------------------------------------------------------------------
+void NestedBasis( double dx, double dy, double* row );
+
+std::vector<NestedFit> FitNestedModels(
+   const std::vector<double>& rows,
+   const std::vector<double>& w,
+   const std::vector<double>& y,
+   double log_head_sd
+);
+
+void NestedModelEngine(
+   double xo, double yo,
+   double k_alpha, double k_beta, int k_count,
+   double h_alpha, double h_beta, int h_count,
+   double radius,
+   const ObsTable& obs,
+   const std::vector<WellRecord>& wells,
+   int nthreads,
+   std::ostream& out
+);
+
+//=============================================================================
+#endif  // NESTED_MODELS_H
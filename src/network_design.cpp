@@ -0,0 +1,448 @@
+//=============================================================================
+// network_design.cpp
+//
+//    Monitoring network design: rank candidate new observation sites by how
+//    much they would reduce the uncertainty in the hydrogeologic descriptors
+//    at the origin, and rank the existing observations by how little would
+//    be lost if they were retired.
+//
+// notes:
+// o  The standard deviations of the recharge, magnitude, and direction are
+//    linearized about the fitted parameters, so each variance is a quadratic
+//    form g'inv(A)g in the information matrix A = X'WX, with a fixed
+//    gradient g. Adding an observation (basis row x, weight w) is the
+//    rank-one update A + w xx'. With A = LL', z = inv(L)x, and G = inv(L)g,
+//
+//       var(+x) = G'G - w (G'z)^2 / (1 + w z'z)
+//       var(-x) = G'G + w (G'z)^2 / (1 - w z'z)
+//
+//    so scoring a site costs one 6 x 6 forward substitution, and the 6 x 6
+//    system is never refactored.
+//
+// o  The sites are added greedily: after each selection the Cholesky factor
+//    is updated in place, with CholeskyUpdate, and the remaining candidates
+//    are scored again.
+//
+// o  The weight of a candidate depends on the head that would be measured
+//    there. The anticipated head is the one implied by the fitted discharge
+//    potential at the candidate.
+//
+// o  The score of a site is the sum over the three descriptors of the
+//    relative change in variance, so no one descriptor's units dominate.
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <math.h>
+#include <sstream>
+
+#include "engine.h"
+#include "linear_systems.h"
+#include "network_design.h"
+#include "normal_equations.h"
+#include "numerical_constants.h"
+#include "parallel_for-inl.h"
+
+//-----------------------------------------------------------------------------
+namespace {
+
+   const int DESCRIPTORS = 3;       // recharge, magnitude, direction
+   const int BLOCK_SIZE  = 4096;    // candidates scored per parallel task
+
+   // An observation whose leverage is within MIN_COMPLEMENT of one alone
+   // determines some combination of the parameters, up to roundoff.
+   const double MIN_COMPLEMENT = 1e-10;
+
+   typedef double Gradients[DESCRIPTORS][QUADRATIC_TERMS];
+
+   //--------------------------------------------------------------------------
+   // The gradients of the recharge, magnitude, and direction with respect to
+   // {A, B, C, D, E, F}, at P_ev, as linearized in
+   // ComputeGeohydrologyStatistics. The signs do not matter.
+   //--------------------------------------------------------------------------
+   void DescriptorGradients( const Matrix& P_ev, Gradients g ) {
+      const double Qx = -P_ev(3,0);
+      const double Qy = -P_ev(4,0);
+      const double S = Qx*Qx + Qy*Qy;
+      const double T = sqrt(S);
+
+      for (int d = 0; d < DESCRIPTORS; ++d)
+         std::fill(g[d], g[d] + QUADRATIC_TERMS, 0.0);
+
+      g[0][0] = 2.0;
+      g[0][1] = 2.0;
+
+      g[1][3] = Qx / T;
+      g[1][4] = Qy / T;
+
+      g[2][3] = -Qy / S;
+      g[2][4] =  Qx / S;
+   }
+
+   //--------------------------------------------------------------------------
+   // Solve L z = x for z, with L lower triangular.
+   //--------------------------------------------------------------------------
+   void ForwardSolve( const Matrix& L, const double* x, double* z ) {
+      for (int i = 0; i < QUADRATIC_TERMS; ++i) {
+         double sum = x[i];
+         for (int j = 0; j < i; ++j)
+            sum -= L(i,j) * z[j];
+         z[i] = sum / L(i,i);
+      }
+   }
+
+   //--------------------------------------------------------------------------
+   // The transformed gradients G = inv(L)g, and the current variances G'G.
+   //--------------------------------------------------------------------------
+   void TransformGradients( const Matrix& L, const Gradients g, Gradients G, double* var ) {
+      for (int d = 0; d < DESCRIPTORS; ++d) {
+         ForwardSolve(L, g[d], G[d]);
+         var[d] = 0.0;
+         for (int i = 0; i < QUADRATIC_TERMS; ++i)
+            var[d] += G[d][i] * G[d][i];
+      }
+   }
+
+   //--------------------------------------------------------------------------
+   // The descriptor variances after adding (sign = +1) or removing (sign =
+   // -1) an observation with basis row x and weight w. Returns false if the
+   // removal would leave the information matrix singular.
+   //--------------------------------------------------------------------------
+   bool ChangedVariances(
+      const Matrix& L, const Gradients G, const double* var,
+      const double* x, double w, double sign, double* changed ) {
+
+      double z[QUADRATIC_TERMS];
+      ForwardSolve(L, x, z);
+
+      double q = 0.0;
+      for (int i = 0; i < QUADRATIC_TERMS; ++i)
+         q += z[i] * z[i];
+
+      const double denominator = 1.0 + sign*w*q;
+      if (!(denominator > MIN_COMPLEMENT))
+         return false;
+
+      for (int d = 0; d < DESCRIPTORS; ++d) {
+         double c = 0.0;
+         for (int i = 0; i < QUADRATIC_TERMS; ++i)
+            c += G[d][i] * z[i];
+         changed[d] = var[d] - sign*w*c*c/denominator;
+      }
+      return true;
+   }
+
+   //--------------------------------------------------------------------------
+   DesignRecord MakeRecord( int index, const double* var, const double* changed ) {
+      double score = 0.0;
+      for (int d = 0; d < DESCRIPTORS; ++d)
+         score += std::fabs(changed[d] - var[d]) / var[d];
+
+      DesignRecord record;
+      record.index = index;
+      record.score = score;
+      record.r_sd  = std::sqrt( std::max(changed[0], EPS) );
+      record.m_sd  = std::sqrt( std::max(changed[1], EPS) );
+      record.d_sd  = std::sqrt( std::max(changed[2], EPS) );
+      return record;
+   }
+
+   //--------------------------------------------------------------------------
+   void Factor( const Matrix& XtWX, Matrix& L ) {
+      if (!CholeskyDecomposition(XtWX, L)) {
+         std::stringstream message;
+         message << "Cholesky Decomposition failed." << std::endl;
+         throw CholeskyDecompositionFailed(message.str());
+      }
+   }
+
+   //--------------------------------------------------------------------------
+   // The head that would give the discharge potential Phi; the inverse of
+   // DischargePotential with the expected value of the squared head.
+   // Returns 0 if there is no positive head.
+   //--------------------------------------------------------------------------
+   double AnticipatedHead( double Phi, double head_sd, double conductivity, double thickness ) {
+      if (Phi >= 0.5*conductivity*thickness*thickness)
+         return Phi/(conductivity*thickness) + 0.5*thickness;
+
+      double square = 2.0*Phi/conductivity - head_sd*head_sd;
+      return (square > 0) ? std::sqrt(square) : 0.0;
+   }
+}
+
+//=============================================================================
+// SelectSites
+//
+//    Greedily select up to "count" sites, each time taking the one that most
+//    reduces the descriptor variances given the sites already selected.
+//
+// Arguments:
+//    P_ev           the fitted parameters, which fix the gradients.
+//    XtWX           the information matrix of the existing observations.
+//    rows           the N candidate basis rows, QUADRATIC_TERMS values each.
+//    w              the N candidate weights; a site with w <= 0 is never
+//                   selected.
+//    count          the maximum number of sites to select.
+//    nthreads       the maximum number of threads; see ThreadCount.
+//
+// Returns:
+//    The selected sites, in the order of selection. Fewer than "count" are
+//    returned if the candidates run out.
+//=============================================================================
+std::vector<DesignRecord> SelectSites(
+   const Matrix& P_ev,
+   const Matrix& XtWX,
+   const std::vector<double>& rows,
+   const std::vector<double>& w,
+   int count,
+   int nthreads) {
+
+   const int N = w.size();
+   const int nblocks = (N + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+   Matrix L;
+   Factor(XtWX, L);
+
+   Gradients g;
+   DescriptorGradients(P_ev, g);
+
+   std::vector<char> selected(N, 0);
+   std::vector<DesignRecord> records;
+
+   for (int step = 0; step < count; ++step) {
+      Gradients G;
+      double var[DESCRIPTORS];
+      TransformGradients(L, g, G, var);
+
+      // The best candidate in each block, then the best over the blocks.
+      // Ties go to the lowest index, so the choice does not depend on the
+      // number of threads.
+      std::vector<DesignRecord> best(nblocks, DesignRecord{-1, 0.0, 0.0, 0.0, 0.0});
+
+      ParallelFor(0, nblocks, nthreads, [&](int b) {
+         const int end = std::min(N, (b+1)*BLOCK_SIZE);
+         for (int c = b*BLOCK_SIZE; c < end; ++c) {
+            if (selected[c] || !(w[c] > 0))
+               continue;
+
+            double changed[DESCRIPTORS];
+            ChangedVariances(L, G, var, &rows[c*QUADRATIC_TERMS], w[c], +1.0, changed);
+
+            DesignRecord record = MakeRecord(c, var, changed);
+            if (record.score > best[b].score)
+               best[b] = record;
+         }
+      });
+
+      DesignRecord choice = {-1, 0.0, 0.0, 0.0, 0.0};
+      for (const DesignRecord& record : best) {
+         if (record.score > choice.score)
+            choice = record;
+      }
+      if (choice.index < 0)
+         break;
+
+      records.push_back(choice);
+      selected[choice.index] = 1;
+
+      Matrix v(QUADRATIC_TERMS, 1);
+      const double root = std::sqrt(w[choice.index]);
+      for (int i = 0; i < QUADRATIC_TERMS; ++i)
+         v(i,0) = root * rows[choice.index*QUADRATIC_TERMS + i];
+      CholeskyUpdate(L, v);
+   }
+
+   return records;
+}
+
+//=============================================================================
+// RankRetirements
+//
+//    Score the removal of each existing observation, one at a time.
+//
+// Arguments:
+//    P_ev, XtWX     as in SelectSites.
+//    rows, w        the M basis rows and weights of the active observations.
+//    nthreads       the maximum number of threads; see ThreadCount.
+//
+// Returns:
+//    The M observations, from the least to the most loss. An observation
+//    that cannot be removed without leaving the system singular has an
+//    infinite score and standard deviations.
+//=============================================================================
+std::vector<DesignRecord> RankRetirements(
+   const Matrix& P_ev,
+   const Matrix& XtWX,
+   const std::vector<double>& rows,
+   const std::vector<double>& w,
+   int nthreads) {
+
+   const int M = w.size();
+
+   Matrix L;
+   Factor(XtWX, L);
+
+   Gradients g, G;
+   double var[DESCRIPTORS];
+   DescriptorGradients(P_ev, g);
+   TransformGradients(L, g, G, var);
+
+   std::vector<DesignRecord> records(M);
+
+   ParallelFor(0, M, nthreads, [&](int m) {
+      double changed[DESCRIPTORS];
+      if (ChangedVariances(L, G, var, &rows[m*QUADRATIC_TERMS], w[m], -1.0, changed)) {
+         records[m] = MakeRecord(m, var, changed);
+      }
+      else {
+         const double inf = std::numeric_limits<double>::infinity();
+         records[m] = DesignRecord{m, inf, inf, inf, inf};
+      }
+   });
+
+   std::stable_sort(records.begin(), records.end(),
+      [](const DesignRecord& a, const DesignRecord& b) { return a.score < b.score; });
+
+   return records;
+}
+
+//=============================================================================
+// NetworkDesignEngine
+//
+//    For every (k,h) cell, select up to "count" of the candidate sites and
+//    rank the retirement of the active observations. The selections are
+//    written to "add_out", and the retirements to "retire_out", as .csv
+//    lines
+//
+//       k, h, rank, id, x, y, score, recharge_sd, magnitude_sd, direction_sd
+//
+//    after a header line. The directions are in degrees.
+//
+// Arguments:
+//    xo, yo         the model origin.
+//    k_alpha, ...   the conductivity and thickness distributions, as in
+//                   Engine.
+//    radius         the well buffer radius; candidates within the buffer
+//                   are never selected.
+//    obs            the observations.
+//    wells          the pumping wells.
+//    candidates     the candidate sites.
+//    count          the maximum number of sites to select in each cell.
+//    nthreads       the maximum number of threads; see ThreadCount.
+//    add_out        the output stream for the selections.
+//    retire_out     the output stream for the retirements.
+//=============================================================================
+void NetworkDesignEngine(
+   double xo, double yo,
+   double k_alpha, double k_beta, int k_count,
+   double h_alpha, double h_beta, int h_count,
+   double radius,
+   const ObsTable& obs,
+   const std::vector<WellRecord>& wells,
+   const std::vector<CandidateRecord>& candidates,
+   int count,
+   int nthreads,
+   std::ostream& add_out,
+   std::ostream& retire_out) {
+
+   const std::vector<int> active = ActiveIndices(obs, wells, radius, false);
+   const int M = active.size();
+   const int N = candidates.size();
+   const int n = QUADRATIC_TERMS;
+
+   // The basis rows and the well potentials do not depend on k or h.
+   std::vector<double> rows(M*n);
+   std::vector<double> Phi_wells(M);
+   for (int m = 0; m < M; ++m) {
+      QuadraticBasis(obs.x()[active[m]] - xo, obs.y()[active[m]] - yo, &rows[m*n]);
+      Phi_wells[m] = WellPotential(obs.x()[active[m]], obs.y()[active[m]], wells);
+   }
+
+   std::vector<double> c_rows(N*n);
+   std::vector<double> c_Phi_wells(N);
+   std::vector<char> buffered(N, 0);
+   for (int c = 0; c < N; ++c) {
+      QuadraticBasis(candidates[c].x - xo, candidates[c].y - yo, &c_rows[c*n]);
+      c_Phi_wells[c] = WellPotential(candidates[c].x, candidates[c].y, wells);
+      for (const WellRecord& well : wells) {
+         if (hypot(candidates[c].x - well.x, candidates[c].y - well.y) < radius)
+            buffered[c] = 1;
+      }
+   }
+
+   std::vector<double> k = SetPoints(k_alpha, k_beta, k_count);
+   std::vector<double> h = SetPoints(h_alpha, h_beta, h_count);
+
+   std::vector<double> w(M);
+   std::vector<double> c_w(N);
+
+   const char* header = "k,h,rank,id,x,y,score,recharge_sd,magnitude_sd,direction_sd\n";
+   add_out << header;
+   retire_out << header;
+   add_out.precision(17);
+   retire_out.precision(17);
+
+   for (int i = 0; i < k_count; ++i) {
+      for (int j = 0; j < h_count; ++j) {
+         NormalEquations equations;
+         for (int m = 0; m < M; ++m) {
+            double Phi_ev, Phi_sd;
+            DischargePotential(obs.head_ev()[active[m]], obs.head_sd()[active[m]], k[i], h[j], Phi_ev, Phi_sd);
+            w[m] = 1.0/(Phi_sd*Phi_sd);
+            equations.Add(&rows[m*n], w[m], Phi_ev - Phi_wells[m]);
+         }
+
+         Matrix XtWX, XtWY;
+         equations.Assemble(XtWX, XtWY);
+
+         Matrix P_ev, P_cov;
+         std::tie(P_ev, P_cov) = SolveNormalEquations(XtWX, XtWY);
+
+         // The candidate weights, at the anticipated heads.
+         ParallelFor(0, (N + BLOCK_SIZE - 1) / BLOCK_SIZE, nthreads, [&](int b) {
+            const int end = std::min(N, (b+1)*BLOCK_SIZE);
+            for (int c = b*BLOCK_SIZE; c < end; ++c) {
+               c_w[c] = 0.0;
+               if (buffered[c])
+                  continue;
+
+               double Phi = c_Phi_wells[c];
+               for (int t = 0; t < n; ++t)
+                  Phi += c_rows[c*n + t] * P_ev(t,0);
+
+               double head = AnticipatedHead(Phi, candidates[c].head_sd, k[i], h[j]);
+               double Phi_ev, Phi_sd;
+               DischargePotential(head, candidates[c].head_sd, k[i], h[j], Phi_ev, Phi_sd);
+               if (Phi_sd > 0)
+                  c_w[c] = 1.0/(Phi_sd*Phi_sd);
+            }
+         });
+
+         std::vector<DesignRecord> added = SelectSites(P_ev, XtWX, c_rows, c_w, count, nthreads);
+         for (int r = 0; r < static_cast<int>(added.size()); ++r) {
+            const DesignRecord& a = added[r];
+            const CandidateRecord& site = candidates[a.index];
+            add_out << k[i] << ',' << h[j] << ',' << r+1 << ',' << site.id << ','
+                    << site.x << ',' << site.y << ',' << a.score << ','
+                    << a.r_sd << ',' << a.m_sd << ',' << RAD_TO_DEG*a.d_sd << '\n';
+         }
+
+         std::vector<DesignRecord> retired = RankRetirements(P_ev, XtWX, rows, w, nthreads);
+         for (int r = 0; r < M; ++r) {
+            const DesignRecord& a = retired[r];
+            const int m = active[a.index];
+            retire_out << k[i] << ',' << h[j] << ',' << r+1 << ',' << obs.id(m) << ','
+                       << obs.x()[m] << ',' << obs.y()[m] << ',' << a.score << ','
+                       << a.r_sd << ',' << a.m_sd << ',' << RAD_TO_DEG*a.d_sd << '\n';
+         }
+      }
+   }
+}
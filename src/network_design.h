@@ -0,0 +1,69 @@
+//=============================================================================
+// network_design.h
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#ifndef NETWORK_DESIGN_H
+#define NETWORK_DESIGN_H
+
+#include <ostream>
+#include <vector>
+
+#include "matrix.h"
+#include "obs_table.h"
+#include "read_data.h"
+
+//-----------------------------------------------------------------------------
+// One added or retired site. The score is the relative change in the
+// variances of the recharge, magnitude, and direction, summed over the
+// three; the standard deviations are those after the change.
+//-----------------------------------------------------------------------------
+struct DesignRecord {
+   int    index;           // into the candidates, or the active observations
+   double score;
+
+   double r_sd;
+   double m_sd;
+   double d_sd;            // [radians]
+};
+
+//-----------------------------------------------------------------------------
+std::vector<DesignRecord> SelectSites(
+   const Matrix& P_ev,
+   const Matrix& XtWX,
+   const std::vector<double>& rows,
+   const std::vector<double>& w,
+   int count,
+   int nthreads
+);
+
+std::vector<DesignRecord> RankRetirements(
+   const Matrix& P_ev,
+   const Matrix& XtWX,
+   const std::vector<double>& rows,
+   const std::vector<double>& w,
+   int nthreads
+);
+
+void NetworkDesignEngine(
+   double xo, double yo,
+   double k_alpha, double k_beta, int k_count,
+   double h_alpha, double h_beta, int h_count,
+   double radius,
+   const ObsTable& obs,
+   const std::vector<WellRecord>& wells,
+   const std::vector<CandidateRecord>& candidates,
+   int count,
+   int nthreads,
+   std::ostream& add_out,
+   std::ostream& retire_out
+);
+
+//=============================================================================
+#endif  // NETWORK_DESIGN_H
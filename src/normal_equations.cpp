@@ -0,0 +1,158 @@
+//=============================================================================
+// normal_equations.cpp
+//
+//    Accumulate the weighted least squares normal equations for the
+//    quadratic discharge potential model one observation at a time.
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#include "normal_equations.h"
+
+//-----------------------------------------------------------------------------
+NormalEquations::NormalEquations()
+:  m_XtWX(),
+   m_XtWY(),
+   m_yWy( 0.0 ),
+   m_Count( 0 ) {
+}
+
+//-----------------------------------------------------------------------------
+// Add one observation with basis row "row", weight "w" (the inverse of the
+// observation variance), and right-hand side "y".
+//-----------------------------------------------------------------------------
+void NormalEquations::Add( const double* row, double w, double y ) {
+   Accumulate(row, w, y);
+   ++m_Count;
+}
+
+//-----------------------------------------------------------------------------
+// Remove an observation previously added with the same arguments.
+//-----------------------------------------------------------------------------
+void NormalEquations::Remove( const double* row, double w, double y ) {
+   Accumulate(row, -w, y);
+   --m_Count;
+}
+
+//-----------------------------------------------------------------------------
+void NormalEquations::Accumulate( const double* row, double w, double y ) {
+   double* a = m_XtWX;
+   for (int i = 0; i < QUADRATIC_TERMS; ++i) {
+      double wr = w * row[i];
+      for (int j = 0; j <= i; ++j)
+         *a++ += wr * row[j];
+      m_XtWY[i] += wr * y;
+   }
+   m_yWy += w * y * y;
+}
+
+//-----------------------------------------------------------------------------
+void NormalEquations::Merge( const NormalEquations& other ) {
+   for (int i = 0; i < QUADRATIC_TERMS*(QUADRATIC_TERMS+1)/2; ++i)
+      m_XtWX[i] += other.m_XtWX[i];
+   for (int i = 0; i < QUADRATIC_TERMS; ++i)
+      m_XtWY[i] += other.m_XtWY[i];
+   m_yWy   += other.m_yWy;
+   m_Count += other.m_Count;
+}
+
+//-----------------------------------------------------------------------------
+int NormalEquations::Count() const {
+   return m_Count;
+}
+
+double NormalEquations::yWy() const {
+   return m_yWy;
+}
+
+//-----------------------------------------------------------------------------
+// Expand the packed sums into the full symmetric (6x6) X'WX and the (6x1)
+// X'Wy.
+//-----------------------------------------------------------------------------
+void NormalEquations::Assemble( Matrix& XtWX, Matrix& XtWY ) const {
+   XtWX.Resize(QUADRATIC_TERMS, QUADRATIC_TERMS);
+   XtWY.Resize(QUADRATIC_TERMS, 1);
+
+   const double* a = m_XtWX;
+   for (int i = 0; i < QUADRATIC_TERMS; ++i) {
+      for (int j = 0; j <= i; ++j) {
+         XtWX(i,j) = *a;
+         XtWX(j,i) = *a++;
+      }
+      XtWY(i,0) = m_XtWY[i];
+   }
+}
+
+//-----------------------------------------------------------------------------
+// Move the origin of the basis by (a,b): after the call the sums are those
+// that would have been accumulated with rows QuadraticBasis(dx-a, dy-b, row)
+// in place of QuadraticBasis(dx, dy, row).
+//
+// The shifted basis is a fixed linear transformation of the original one,
+// phi' = T phi, with
+//
+//        | 1  0  0  -2a   0   a^2 |
+//        | 0  1  0   0  -2b   b^2 |
+//    T = | 0  0  1  -b   -a   ab  |
+//        | 0  0  0   1    0   -a  |
+//        | 0  0  0   0    1   -b  |
+//        | 0  0  0   0    0    1  |
+//
+// so X'WX becomes T (X'WX) T' and X'Wy becomes T (X'Wy).
+//-----------------------------------------------------------------------------
+void NormalEquations::Translate( double a, double b ) {
+   const int n = QUADRATIC_TERMS;
+
+   const double T[QUADRATIC_TERMS][QUADRATIC_TERMS] = {
+      {1, 0, 0, -2*a,    0,  a*a},
+      {0, 1, 0,    0, -2*b,  b*b},
+      {0, 0, 1,   -b,   -a,  a*b},
+      {0, 0, 0,    1,    0,   -a},
+      {0, 0, 0,    0,    1,   -b},
+      {0, 0, 0,    0,    0,    1}
+   };
+
+   // Unpack the symmetric X'WX.
+   double A[QUADRATIC_TERMS][QUADRATIC_TERMS];
+   const double* p = m_XtWX;
+   for (int i = 0; i < n; ++i)
+      for (int j = 0; j <= i; ++j)
+         A[i][j] = A[j][i] = *p++;
+
+   // TA = T A.
+   double TA[QUADRATIC_TERMS][QUADRATIC_TERMS];
+   for (int i = 0; i < n; ++i) {
+      for (int j = 0; j < n; ++j) {
+         double sum = 0.0;
+         for (int k = i; k < n; ++k)         // T is upper triangular
+            sum += T[i][k] * A[k][j];
+         TA[i][j] = sum;
+      }
+   }
+
+   // The lower triangle of T A T'.
+   double* q = m_XtWX;
+   for (int i = 0; i < n; ++i) {
+      for (int j = 0; j <= i; ++j) {
+         double sum = 0.0;
+         for (int k = j; k < n; ++k)
+            sum += TA[i][k] * T[j][k];
+         *q++ = sum;
+      }
+   }
+
+   double Y[QUADRATIC_TERMS];
+   for (int i = 0; i < n; ++i) {
+      double sum = 0.0;
+      for (int k = i; k < n; ++k)
+         sum += T[i][k] * m_XtWY[k];
+      Y[i] = sum;
+   }
+   for (int i = 0; i < n; ++i)
+      m_XtWY[i] = Y[i];
+}
@@ -0,0 +1,66 @@
+//=============================================================================
+// normal_equations.h
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#ifndef NORMAL_EQUATIONS_H
+#define NORMAL_EQUATIONS_H
+
+#include "matrix.h"
+#include "polynomial_model-inl.h"
+
+//-----------------------------------------------------------------------------
+// The number of parameters in the quadratic discharge potential model,
+// {A, B, C, D, E, F}.
+//-----------------------------------------------------------------------------
+const int QUADRATIC_TERMS = PolynomialModel<2>::TERMS;
+
+//-----------------------------------------------------------------------------
+// Fill row[0..5] with the quadratic basis {dx^2, dy^2, dx*dy, dx, dy, 1}.
+//-----------------------------------------------------------------------------
+inline void QuadraticBasis( double dx, double dy, double* row ) {
+   PolynomialModel<2>::Basis(dx, dy, row);
+}
+
+//=============================================================================
+// NormalEquations
+//
+//    Running sums of the weighted least squares normal equations for the
+//    quadratic model, X'WX and X'Wy, together with y'Wy and the number of
+//    observations. Only the lower triangle of X'WX is accumulated.
+//
+//    Observations can be folded in one at a time, so the M x 6 X, the M x M
+//    inverse variance matrix and the M x 1 Y never have to be built.
+//=============================================================================
+class NormalEquations {
+   public:
+      NormalEquations();
+
+      void Add( const double* row, double w, double y );
+      void Remove( const double* row, double w, double y );
+      void Merge( const NormalEquations& other );
+
+      void Translate( double a, double b );
+
+      int Count() const;
+      double yWy() const;
+
+      void Assemble( Matrix& XtWX, Matrix& XtWY ) const;
+
+   private:
+      void Accumulate( const double* row, double w, double y );
+
+      double m_XtWX[QUADRATIC_TERMS*(QUADRATIC_TERMS+1)/2];
+      double m_XtWY[QUADRATIC_TERMS];
+      double m_yWy;
+      int    m_Count;
+};
+
+//=============================================================================
+#endif  // NORMAL_EQUATIONS_H
@@ -0,0 +1,156 @@
+//=============================================================================
+// obs_table.cpp
+//
+//    The structure-of-arrays observation store used by the engine.
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#include <cstdint>
+
+#include "obs_table.h"
+
+//-----------------------------------------------------------------------------
+namespace {
+   const int ALIGNMENT = 64;                             // bytes
+   const int DOUBLES_PER_LINE = ALIGNMENT/sizeof(double);
+
+   //--------------------------------------------------------------------------
+   // Round the column length up to a whole number of cache lines, so that
+   // every column starts on a 64-byte boundary.
+   //--------------------------------------------------------------------------
+   int Stride( int count ) {
+      return (count + DOUBLES_PER_LINE - 1) / DOUBLES_PER_LINE * DOUBLES_PER_LINE;
+   }
+
+   //--------------------------------------------------------------------------
+   const double* Align( const double* p ) {
+      uintptr_t address = reinterpret_cast<uintptr_t>(p);
+      uintptr_t aligned = (address + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+      return p + (aligned - address)/sizeof(double);
+   }
+}
+
+//-----------------------------------------------------------------------------
+ObsTable::ObsTable()
+:  m_Count( 0 ),
+   m_x( nullptr ),
+   m_y( nullptr ),
+   m_head_ev( nullptr ),
+   m_head_sd( nullptr ),
+   m_Storage(),
+   m_Ids(),
+   m_File() {
+}
+
+//-----------------------------------------------------------------------------
+// Build an owning table from records. The four columns share one allocation,
+// over-allocated by one cache line so the first column can be aligned.
+//-----------------------------------------------------------------------------
+ObsTable::ObsTable( const std::vector<ObsRecord>& obs )
+:  m_Count( static_cast<int>(obs.size()) ),
+   m_x( nullptr ),
+   m_y( nullptr ),
+   m_head_ev( nullptr ),
+   m_head_sd( nullptr ),
+   m_Storage(),
+   m_Ids(),
+   m_File() {
+
+   const int stride = Stride(m_Count);
+
+   auto storage = std::make_shared<std::vector<double>>(4*stride + DOUBLES_PER_LINE);
+   auto ids     = std::make_shared<std::vector<std::string>>(m_Count);
+
+   double* base = const_cast<double*>( Align(storage->data()) );
+   double* x       = base;
+   double* y       = base + stride;
+   double* head_ev = base + 2*stride;
+   double* head_sd = base + 3*stride;
+
+   for (int m = 0; m < m_Count; ++m) {
+      x[m]       = obs[m].x;
+      y[m]       = obs[m].y;
+      head_ev[m] = obs[m].head_ev;
+      head_sd[m] = obs[m].head_sd;
+      (*ids)[m]  = obs[m].id;
+   }
+
+   m_x       = x;
+   m_y       = y;
+   m_head_ev = head_ev;
+   m_head_sd = head_sd;
+   m_Storage = storage;
+   m_Ids     = ids;
+}
+
+//-----------------------------------------------------------------------------
+// View a memory-mapped binary observation file in place; nothing is copied.
+//-----------------------------------------------------------------------------
+ObsTable::ObsTable( std::shared_ptr<const ColumnarFile> file )
+:  m_Count( file->Count() ),
+   m_x( file->Column(0) ),
+   m_y( file->Column(1) ),
+   m_head_ev( file->Column(2) ),
+   m_head_sd( file->Column(3) ),
+   m_Storage(),
+   m_Ids(),
+   m_File( file ) {
+}
+
+//-----------------------------------------------------------------------------
+int ObsTable::size() const {
+   return m_Count;
+}
+
+const double* ObsTable::x() const {
+   return m_x;
+}
+
+const double* ObsTable::y() const {
+   return m_y;
+}
+
+const double* ObsTable::head_ev() const {
+   return m_head_ev;
+}
+
+const double* ObsTable::head_sd() const {
+   return m_head_sd;
+}
+
+//-----------------------------------------------------------------------------
+std::string ObsTable::id( int m ) const {
+   if (m_File)
+      return m_File->Id(m);
+   return (*m_Ids)[m];
+}
+
+ObsRecord ObsTable::record( int m ) const {
+   return ObsRecord{ id(m), m_x[m], m_y[m], m_head_ev[m], m_head_sd[m] };
+}
+
+//-----------------------------------------------------------------------------
+std::vector<int> AllIndices( const ObsTable& obs ) {
+   std::vector<int> indices(obs.size());
+   for (int m = 0; m < obs.size(); ++m)
+      indices[m] = m;
+   return indices;
+}
+
+//-----------------------------------------------------------------------------
+ObsTable read_obs_table( const std::string& obsfilename ) {
+   if (is_binary_file(obsfilename)) {
+      try {
+         return ObsTable( std::make_shared<const ColumnarFile>(obsfilename, BINARY_OBSERVATIONS) );
+      } catch (InvalidBinaryFile& e) {
+         throw InvalidObsFile(e.what());
+      }
+   }
+   return ObsTable( read_obs_data(obsfilename) );
+}
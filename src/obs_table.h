@@ -0,0 +1,73 @@
+//=============================================================================
+// obs_table.h
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#ifndef OBS_TABLE_H
+#define OBS_TABLE_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "binary_data.h"
+#include "read_data.h"
+
+//=============================================================================
+// ObsTable
+//
+//    A structure-of-arrays observation store. The four numeric columns are
+//    contiguous and 64-byte aligned; the id strings are kept off to the side
+//    so the numerical loops never touch them.
+//
+//    An ObsTable is immutable once constructed, and copies share the same
+//    column storage, so passing one around is cheap.
+//=============================================================================
+class ObsTable {
+   public:
+      ObsTable();
+      explicit ObsTable( const std::vector<ObsRecord>& obs );
+      explicit ObsTable( std::shared_ptr<const ColumnarFile> file );
+
+      int size() const;
+
+      const double* x() const;
+      const double* y() const;
+      const double* head_ev() const;
+      const double* head_sd() const;
+
+      std::string id( int m ) const;
+      ObsRecord record( int m ) const;
+
+   private:
+      int m_Count;
+
+      const double* m_x;
+      const double* m_y;
+      const double* m_head_ev;
+      const double* m_head_sd;
+
+      std::shared_ptr<const std::vector<double>> m_Storage;
+      std::shared_ptr<const std::vector<std::string>> m_Ids;
+      std::shared_ptr<const ColumnarFile> m_File;
+};
+
+//-----------------------------------------------------------------------------
+// An index view selecting every observation in the table.
+//-----------------------------------------------------------------------------
+std::vector<int> AllIndices( const ObsTable& obs );
+
+//-----------------------------------------------------------------------------
+// Read an observation file, either .csv or binary. A binary file is mapped
+// into memory and viewed in place.
+//-----------------------------------------------------------------------------
+ObsTable read_obs_table( const std::string& inpfilename );
+
+//=============================================================================
+#endif  // OBS_TABLE_H
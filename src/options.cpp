@@ -0,0 +1,322 @@
+//=============================================================================
+// options.cpp
+//
+//    Parse the optional command line settings.
+//
+// notes:
+// o  An option is any argument that starts with "--". Options may appear
+//    anywhere after the program name, and in any order.
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#include <cstdlib>
+#include <sstream>
+
+#include "options.h"
+
+//-----------------------------------------------------------------------------
+namespace {
+
+   //--------------------------------------------------------------------------
+   int ParseInt( const std::string& name, const std::string& value, int minimum ) {
+      char* end = nullptr;
+      long v = strtol(value.c_str(), &end, 10);
+      if (value.empty() || *end != '\0' || v < minimum) {
+         std::stringstream message;
+         message << "ERROR: --" << name << "=" << value << " is not valid;  " << minimum << " <= " << name << ".";
+         throw InvalidOption(message.str());
+      }
+      return static_cast<int>(v);
+   }
+
+   //--------------------------------------------------------------------------
+   int ParseInt( const std::string& name, const std::string& value, int minimum, int maximum ) {
+      int v = ParseInt(name, value, minimum);
+      if (v > maximum) {
+         std::stringstream message;
+         message << "ERROR: --" << name << "=" << value << " is not valid;  " << name << " <= " << maximum << ".";
+         throw InvalidOption(message.str());
+      }
+      return v;
+   }
+
+   //--------------------------------------------------------------------------
+   double ParseDouble( const std::string& name, const std::string& value, double minimum ) {
+      char* end = nullptr;
+      double v = strtod(value.c_str(), &end);
+      if (value.empty() || *end != '\0' || !(v >= minimum)) {
+         std::stringstream message;
+         message << "ERROR: --" << name << "=" << value << " is not valid;  " << minimum << " <= " << name << ".";
+         throw InvalidOption(message.str());
+      }
+      return v;
+   }
+
+   //--------------------------------------------------------------------------
+   void RequireNoValue( const std::string& name, bool has_value ) {
+      if (has_value) {
+         std::stringstream message;
+         message << "ERROR: --" << name << " does not take a value.";
+         throw InvalidOption(message.str());
+      }
+   }
+}
+
+//-----------------------------------------------------------------------------
+Options::Options()
+:  stream( false ),
+   chunk_size( 65536 ),
+   format( "csv" ),
+   precision( 0 ),
+   fit( false ),
+   threads( 0 ),
+   qr( false ),
+   order( 2 ),
+   quadrature( false ),
+   adaptive( -1.0 ),
+   coarse( 5 ),
+   aggregate( -1.0 ),
+   thin( 0.0 ),
+   factors(),
+   scenarios(),
+   snapshots( false ),
+   search( 0.0 ),
+   nearest( 0 ),
+   origins(),
+   loo( false ),
+   nested( false ),
+   bootstrap( 0 ),
+   seed( 1 ),
+   qmc( 0 ),
+   target( 0.01 ),
+   qsd( 0.0 ),
+   rsd( 0.0 ),
+   surrogate( 0 ),
+   design(),
+   select( 10 ) {
+}
+
+//-----------------------------------------------------------------------------
+std::vector<std::string> ParseOptions( int argc, char* argv[], Options& options ) {
+   std::vector<std::string> positional;
+
+   for (int a = 0; a < argc; ++a) {
+      std::string arg(argv[a]);
+
+      if (a == 0 || arg.compare(0, 2, "--") != 0) {
+         positional.push_back(arg);
+         continue;
+      }
+
+      std::string::size_type equals = arg.find('=');
+      bool has_value = (equals != std::string::npos);
+      std::string name  = arg.substr(2, has_value ? equals-2 : std::string::npos);
+      std::string value = has_value ? arg.substr(equals+1) : std::string();
+
+      if (name == "stream") {
+         RequireNoValue(name, has_value);
+         options.stream = true;
+      }
+      else if (name == "chunk") {
+         options.chunk_size = ParseInt(name, value, 1);
+      }
+      else if (name == "format") {
+         if (value != "csv" && value != "npz") {
+            std::stringstream message;
+            message << "ERROR: --format=" << value << " is not valid;  use csv or npz.";
+            throw InvalidOption(message.str());
+         }
+         options.format = value;
+      }
+      else if (name == "precision") {
+         options.precision = ParseInt(name, value, 0, 17);
+      }
+      else if (name == "fit") {
+         RequireNoValue(name, has_value);
+         options.fit = true;
+      }
+      else if (name == "threads") {
+         options.threads = ParseInt(name, value, 0);
+      }
+      else if (name == "qr") {
+         RequireNoValue(name, has_value);
+         options.qr = true;
+      }
+      else if (name == "order") {
+         options.order = ParseInt(name, value, 1, 3);
+      }
+      else if (name == "quadrature") {
+         RequireNoValue(name, has_value);
+         options.quadrature = true;
+      }
+      else if (name == "adaptive") {
+         options.adaptive = ParseDouble(name, value, 0.0);
+      }
+      else if (name == "coarse") {
+         options.coarse = ParseInt(name, value, 2);
+      }
+      else if (name == "aggregate") {
+         options.aggregate = has_value ? ParseDouble(name, value, 0.0) : 0.0;
+      }
+      else if (name == "thin") {
+         options.thin = ParseDouble(name, value, 0.0);
+      }
+      else if (name == "factors") {
+         if (value.empty())
+            throw InvalidOption("ERROR: --factors requires a filename.");
+         options.factors = value;
+      }
+      else if (name == "scenario") {
+         if (value.empty())
+            throw InvalidOption("ERROR: --scenario requires a filename.");
+         options.scenarios.push_back(value);
+      }
+      else if (name == "snapshots") {
+         RequireNoValue(name, has_value);
+         options.snapshots = true;
+      }
+      else if (name == "search") {
+         options.search = ParseDouble(name, value, 0.0);
+      }
+      else if (name == "nearest") {
+         // Fewer than 10 can never pass the engines' MINIMUM_COUNT test.
+         options.nearest = ParseInt(name, value, 10);
+      }
+      else if (name == "loo") {
+         RequireNoValue(name, has_value);
+         options.loo = true;
+      }
+      else if (name == "nested") {
+         RequireNoValue(name, has_value);
+         options.nested = true;
+      }
+      else if (name == "bootstrap") {
+         options.bootstrap = ParseInt(name, value, 0);
+      }
+      else if (name == "seed") {
+         options.seed = ParseInt(name, value, 0);
+      }
+      else if (name == "qmc") {
+         options.qmc = ParseInt(name, value, 0);
+      }
+      else if (name == "target") {
+         options.target = ParseDouble(name, value, 0.0);
+      }
+      else if (name == "qsd") {
+         options.qsd = ParseDouble(name, value, 0.0);
+      }
+      else if (name == "rsd") {
+         options.rsd = ParseDouble(name, value, 0.0);
+      }
+      else if (name == "surrogate") {
+         options.surrogate = ParseInt(name, value, 0, 40);
+      }
+      else if (name == "design") {
+         if (value.empty())
+            throw InvalidOption("ERROR: --design requires a filename.");
+         options.design = value;
+      }
+      else if (name == "select") {
+         options.select = ParseInt(name, value, 1);
+      }
+      else if (name == "origins") {
+         if (value.empty())
+            throw InvalidOption("ERROR: --origins requires a filename.");
+         options.origins = value;
+      }
+      else {
+         std::stringstream message;
+         message << "ERROR: unknown option " << arg << ".";
+         throw InvalidOption(message.str());
+      }
+   }
+
+   // The pre-passes need the whole observation set in memory.
+   if (options.stream && options.aggregate >= 0) {
+      throw InvalidOption("ERROR: --aggregate cannot be combined with --stream.");
+   }
+   if (options.stream && options.thin > 0) {
+      throw InvalidOption("ERROR: --thin cannot be combined with --stream.");
+   }
+   if (options.stream && options.IsLocal()) {
+      throw InvalidOption("ERROR: --search, --nearest, and --origins cannot be combined with --stream.");
+   }
+   if (options.qr && (options.stream || options.IsLocal())) {
+      throw InvalidOption("ERROR: --qr cannot be combined with --stream, --search, --nearest, or --origins.");
+   }
+   if (options.order != 2 && (options.stream || options.IsLocal() || options.qr || !options.factors.empty() || !options.scenarios.empty() || options.snapshots)) {
+      throw InvalidOption("ERROR: --order=1 and --order=3 cannot be combined with --stream, --qr, --factors, --scenario, --snapshots, --search, --nearest, or --origins.");
+   }
+   if (options.order != 2 && (options.loo || options.bootstrap > 0 || !options.design.empty())) {
+      throw InvalidOption("ERROR: --order=1 and --order=3 cannot be combined with --loo, --bootstrap, or --design, which use the quadratic model.");
+   }
+   if (!options.factors.empty() && (options.stream || options.IsLocal() || options.qr)) {
+      throw InvalidOption("ERROR: --factors cannot be combined with --stream, --qr, --search, --nearest, or --origins.");
+   }
+   if (!options.factors.empty() && (options.loo || options.nested || options.bootstrap > 0 || !options.design.empty())) {
+      throw InvalidOption("ERROR: --factors cannot be combined with --loo, --nested, --bootstrap, or --design, which assume independent errors.");
+   }
+   if (!options.factors.empty() && (options.aggregate >= 0 || options.thin > 0)) {
+      throw InvalidOption("ERROR: --factors cannot be combined with --aggregate or --thin, which merge the observations named in the factor file.");
+   }
+   if (!options.scenarios.empty() && (options.stream || options.IsLocal() || options.qr || !options.factors.empty())) {
+      throw InvalidOption("ERROR: --scenario cannot be combined with --stream, --qr, --factors, --search, --nearest, or --origins.");
+   }
+   if (options.snapshots && (options.stream || options.IsLocal() || options.qr || !options.factors.empty() || !options.scenarios.empty())) {
+      throw InvalidOption("ERROR: --snapshots cannot be combined with --stream, --qr, --factors, --scenario, --search, --nearest, or --origins.");
+   }
+   if (options.snapshots && (options.aggregate >= 0 || options.thin > 0 || options.loo || options.nested || options.bootstrap > 0 || !options.design.empty())) {
+      throw InvalidOption("ERROR: --snapshots cannot be combined with --aggregate, --thin, --loo, --nested, --bootstrap, or --design.");
+   }
+   if (options.fit && (options.IsLocal() || !options.factors.empty())) {
+      throw InvalidOption("ERROR: --fit cannot be combined with --factors, --search, --nearest, or --origins.");
+   }
+   if (options.quadrature && (options.stream || options.IsLocal() || options.order != 2 || !options.factors.empty() || !options.scenarios.empty() || options.snapshots)) {
+      throw InvalidOption("ERROR: --quadrature cannot be combined with --stream, --order, --factors, --scenario, --snapshots, --search, --nearest, or --origins.");
+   }
+   if (options.quadrature && (options.loo || options.nested || options.bootstrap > 0 || !options.design.empty())) {
+      throw InvalidOption("ERROR: --quadrature cannot be combined with --loo, --nested, --bootstrap, or --design, which use the equal-probability set points.");
+   }
+   if (options.adaptive >= 0 && (options.stream || options.IsLocal() || options.qr || options.order != 2 || !options.factors.empty() || !options.scenarios.empty() || options.snapshots || options.quadrature)) {
+      throw InvalidOption("ERROR: --adaptive cannot be combined with --stream, --qr, --order, --factors, --scenario, --snapshots, --quadrature, --search, --nearest, or --origins.");
+   }
+   if (options.loo && (options.stream || options.IsLocal())) {
+      throw InvalidOption("ERROR: --loo cannot be combined with --stream, --search, --nearest, or --origins.");
+   }
+   if (options.nested && (options.stream || options.IsLocal())) {
+      throw InvalidOption("ERROR: --nested cannot be combined with --stream, --search, --nearest, or --origins.");
+   }
+   if (options.bootstrap > 0 && (options.stream || options.IsLocal())) {
+      throw InvalidOption("ERROR: --bootstrap cannot be combined with --stream, --search, --nearest, or --origins.");
+   }
+   if (!options.design.empty() && (options.stream || options.IsLocal())) {
+      throw InvalidOption("ERROR: --design cannot be combined with --stream, --search, --nearest, or --origins.");
+   }
+   if (options.surrogate > 0 && (options.stream || options.IsLocal() || options.order != 2 || !options.factors.empty() || !options.scenarios.empty() || options.snapshots)) {
+      throw InvalidOption("ERROR: --surrogate cannot be combined with --stream, --order, --factors, --scenario, --snapshots, --search, --nearest, or --origins.");
+   }
+   if (options.qmc > 0 && (options.stream || options.IsLocal() || options.order != 2 || !options.factors.empty() || !options.scenarios.empty() || options.snapshots)) {
+      throw InvalidOption("ERROR: --qmc cannot be combined with --stream, --order, --factors, --scenario, --snapshots, --search, --nearest, or --origins.");
+   }
+   if (options.surrogate > 0 && (options.qr || options.quadrature || options.adaptive >= 0 || options.fit || options.format != "csv" || options.qmc > 0)) {
+      throw InvalidOption("ERROR: --surrogate cannot be combined with --qr, --quadrature, --adaptive, --fit, --format, or --qmc, which apply to the (k,h) grid it replaces.");
+   }
+   if (options.qmc > 0 && (options.qr || options.quadrature || options.adaptive >= 0 || options.fit || options.format != "csv")) {
+      throw InvalidOption("ERROR: --qmc cannot be combined with --qr, --quadrature, --adaptive, --fit, or --format, which apply to the (k,h) grid it replaces.");
+   }
+
+   return positional;
+}
+
+//-----------------------------------------------------------------------------
+// True if the fit uses a search window, or several origins.
+//-----------------------------------------------------------------------------
+bool Options::IsLocal() const {
+   return search > 0 || nearest > 0 || !origins.empty();
+}
@@ -0,0 +1,90 @@
+//=============================================================================
+// options.h
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+class InvalidOption : public std::runtime_error {
+   public :
+      InvalidOption( const std::string& message ) : std::runtime_error(message) {
+      }
+};
+
+//-----------------------------------------------------------------------------
+// The optional "--name" and "--name=value" command line settings. The
+// default values reproduce the original behavior.
+//-----------------------------------------------------------------------------
+struct Options {
+   bool stream;         // --stream
+   int  chunk_size;     // --chunk=<count>
+
+   std::string format;  // --format=<csv|npz>
+   int  precision;      // --precision=<digits>, 0 = shortest round-trip
+   bool fit;            // --fit
+
+   int  threads;        // --threads=<count>, 0 = all hardware threads
+
+   bool qr;             // --qr
+
+   int  order;          // --order=<1|2|3>
+
+   bool quadrature;     // --quadrature
+
+   double adaptive;     // --adaptive=<tolerance>, < 0 = off
+   int    coarse;       // --coarse=<count>
+
+   double aggregate;    // --aggregate[=<tolerance>], < 0 = off
+   double thin;         // --thin=<cell size>, 0 = off
+
+   std::string factors; // --factors=<filename>, empty = independent errors
+
+   std::vector<std::string> scenarios;  // --scenario=<filename>, repeatable
+
+   bool snapshots;      // --snapshots
+
+   double search;       // --search=<radius>, 0 = no limit
+   int    nearest;      // --nearest=<count>, 0 = no limit
+   std::string origins; // --origins=<filename>, empty = (xo,yo) only
+
+   bool loo;            // --loo
+
+   bool nested;         // --nested
+
+   int  bootstrap;      // --bootstrap=<replicates>, 0 = off
+   int  seed;           // --seed=<stream>
+
+   int    qmc;          // --qmc=<samples>, 0 = off
+   double target;       // --target=<fraction>
+   double qsd;          // --qsd=<fraction>, 0 = fixed discharges
+   double rsd;          // --rsd=<log sd>, 0 = fixed radius
+
+   int  surrogate;      // --surrogate=<degree>, 0 = off
+
+   std::string design;  // --design=<filename>, empty = off
+   int  select;         // --select=<count>
+
+   Options();
+   bool IsLocal() const;
+};
+
+//-----------------------------------------------------------------------------
+// Separate the options from the positional arguments. The positional
+// arguments are returned in order, starting with the program name.
+//-----------------------------------------------------------------------------
+std::vector<std::string> ParseOptions( int argc, char* argv[], Options& options );
+
+//=============================================================================
+#endif  // OPTIONS_H
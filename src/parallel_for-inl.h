@@ -0,0 +1,90 @@
+//=============================================================================
+// parallel_for-inl.h
+//
+//    A minimal fork-join loop over an integer range.
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#ifndef PARALLEL_FOR_H
+#define PARALLEL_FOR_H
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// The number of threads to use when the caller asks for "nthreads". A
+// request of zero (or less) means one thread per hardware thread.
+//-----------------------------------------------------------------------------
+inline int ThreadCount( int nthreads )
+{
+   if (nthreads > 0)
+      return nthreads;
+   return std::max( 1, static_cast<int>(std::thread::hardware_concurrency()) );
+}
+
+//-----------------------------------------------------------------------------
+// Call f(i) for every i in [begin, end) using up to "nthreads" threads.
+// The indices are handed out dynamically, one at a time, so uneven work is
+// balanced. The first exception thrown by any f(i) is rethrown in the
+// calling thread after all of the threads have finished.
+//
+// Arguments:
+//
+//    begin    the first index.
+//    end      one past the last index.
+//    nthreads the maximum number of threads; see ThreadCount.
+//    f        the loop body, callable as f(int).
+//-----------------------------------------------------------------------------
+template <typename F>
+void ParallelFor( int begin, int end, int nthreads, F f )
+{
+   const int count = end - begin;
+   if (count <= 0)
+      return;
+
+   const int nworkers = std::min( ThreadCount(nthreads), count );
+   if (nworkers == 1) {
+      for (int i = begin; i < end; ++i)
+         f(i);
+      return;
+   }
+
+   std::atomic<int> next(begin);
+   std::atomic<bool> failed(false);
+   std::exception_ptr error;
+
+   auto worker = [&]() {
+      for (int i = next++; i < end && !failed; i = next++) {
+         try {
+            f(i);
+         }
+         catch (...) {
+            if (!failed.exchange(true))
+               error = std::current_exception();
+         }
+      }
+   };
+
+   std::vector<std::thread> threads;
+   for (int t = 1; t < nworkers; ++t)
+      threads.emplace_back(worker);
+   worker();
+
+   for (std::thread& thread : threads)
+      thread.join();
+
+   if (error)
+      std::rethrow_exception(error);
+}
+
+//=============================================================================
+#endif  // PARALLEL_FOR_H
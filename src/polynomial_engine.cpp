@@ -0,0 +1,187 @@
+//=============================================================================
+// polynomial_engine.cpp
+//
+//    A version of the Engine for the linear, quadratic, or cubic discharge
+//    potential model.
+//
+// notes:
+// o  The engine is a template on the polynomial order, so each order is
+//    compiled with its own fixed-size basis and normal equations (see
+//    polynomial_model-inl.h). The order is dispatched once, on entry.
+//
+// o  The statistics are computed at the origin, where only the first and
+//    second degree terms contribute to the flow and the recharge. The
+//    higher degree terms of the cubic model absorb curvature away from the
+//    origin; the linear model assumes there is none, and reports zero
+//    recharge.
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include "engine.h"
+#include "linear_systems.h"
+#include "parallel_for-inl.h"
+#include "polynomial_engine.h"
+#include "polynomial_model-inl.h"
+#include "preprocess.h"
+
+//-----------------------------------------------------------------------------
+namespace {
+
+   //--------------------------------------------------------------------------
+   template <int ORDER>
+   CellResult PolynomialCellResult( const Matrix& P_ev, const Matrix& P_cov ) {
+      typedef PolynomialModel<ORDER> Model;
+
+      CellResult cell;
+      std::tie(cell.r_ev, cell.r_sd, cell.m_ev, cell.m_sd, cell.d_ev, cell.d_sd) =
+         ComputeGeohydrologyStatistics(P_ev, P_cov, Model::XX, Model::YY, Model::X, Model::Y);
+      return cell;
+   }
+
+   //--------------------------------------------------------------------------
+   // The engine for one order; see PolynomialEngine.
+   //--------------------------------------------------------------------------
+   template <int ORDER>
+   void RunPolynomialEngine(
+      double xo, double yo,
+      double k_alpha, double k_beta, int k_count,
+      double h_alpha, double h_beta, int h_count,
+      double radius,
+      const ObsTable& obs,
+      const std::vector<WellRecord>& wells,
+      int nthreads,
+      ResultSink& sink) {
+
+      typedef PolynomialModel<ORDER> Model;
+      const int n = Model::TERMS;
+
+      // Manifest constants.
+      const int MINIMUM_COUNT = std::max(10, n);   // At least this many unique observation locations.
+
+      const std::vector<int> active = ActiveIndices(obs, wells, radius, true);
+
+      int Mactive = active.size();
+      int Munique = CountUniqueLocations(obs, active);
+      if (Munique < MINIMUM_COUNT) {
+         std::stringstream message;
+         message << "Too few unique active observation locations: " << Munique << " < " << MINIMUM_COUNT << std::endl;
+         throw TooFewObservations(message.str());
+      }
+      std::cout << Mactive << " active observation data records at " << Munique << " unique locations." << std::endl;
+
+      const int M = Mactive;
+
+      // The basis rows and the well potentials do not depend on k or h.
+      std::vector<double> rows(M*n);
+      std::vector<double> Phi_wells(M);
+      for (int m = 0; m < M; ++m) {
+         Model::Basis(obs.x()[active[m]] - xo, obs.y()[active[m]] - yo, &rows[m*n]);
+         Phi_wells[m] = WellPotential(obs.x()[active[m]], obs.y()[active[m]], wells);
+      }
+
+      std::vector<double> k = SetPoints(k_alpha, k_beta, k_count);
+      std::vector<double> h = SetPoints(h_alpha, h_beta, h_count);
+
+      const double log_head_sd = HeadLogSdSum(obs, active);
+
+      sink.Begin(k, h);
+
+      std::vector<CellResult> row(h_count);
+
+      for (int i = 0; i < k_count; ++i) {
+         ParallelFor(0, h_count, nthreads, [&](int j) {
+            PolynomialEquations<ORDER> equations;
+            for (int m = 0; m < M; ++m) {
+               double Phi_ev, Phi_sd;
+               DischargePotential(obs.head_ev()[active[m]], obs.head_sd()[active[m]], k[i], h[j], Phi_ev, Phi_sd);
+               equations.Add(&rows[m*n], 1.0/(Phi_sd*Phi_sd), Phi_ev - Phi_wells[m]);
+            }
+
+            Matrix XtWX, XtWY;
+            equations.Assemble(XtWX, XtWY);
+
+            Matrix P_ev, P_cov;
+            std::tie(P_ev, P_cov) = SolveNormalEquations(XtWX, XtWY);
+
+            row[j] = PolynomialCellResult<ORDER>(P_ev, P_cov);
+            SetGoodnessOfFit(row[j], WeightedResidualSumOfSquares(equations.yWy(), XtWY, P_ev), M, n, log_head_sd);
+         });
+         sink.Row(i, row);
+      }
+
+      sink.End();
+   }
+}
+
+//=============================================================================
+// ComputePolynomialCellResult
+//
+//    As ComputeCellResult, for the model of the given order.
+//=============================================================================
+CellResult ComputePolynomialCellResult( int order, const Matrix& P_ev, const Matrix& P_cov ) {
+   switch (order) {
+      case 1:  return PolynomialCellResult<1>(P_ev, P_cov);
+      case 2:  return PolynomialCellResult<2>(P_ev, P_cov);
+      case 3:  return PolynomialCellResult<3>(P_ev, P_cov);
+   }
+
+   std::stringstream message;
+   message << "Polynomial order " << order << " is not supported.";
+   throw std::invalid_argument(message.str());
+}
+
+//=============================================================================
+// PolynomialEngine
+//
+//    As Engine, with the discharge potential model of the given order.
+//
+// Arguments:
+//    order          the polynomial order, MINIMUM_ORDER to MAXIMUM_ORDER.
+//    xo, yo         the model origin.
+//    k_alpha, ...   the conductivity and thickness distributions, as in
+//                   Engine.
+//    radius         the well buffer radius.
+//    obs            the observations.
+//    wells          the pumping wells.
+//    nthreads       the maximum number of threads; see ThreadCount. The
+//                   cells of each row are fit in parallel.
+//    sink           receives each row of results as soon as it is complete.
+//=============================================================================
+void PolynomialEngine(
+   int order,
+   double xo, double yo,
+   double k_alpha, double k_beta, int k_count,
+   double h_alpha, double h_beta, int h_count,
+   double radius,
+   const ObsTable& obs,
+   const std::vector<WellRecord>& wells,
+   int nthreads,
+   ResultSink& sink) {
+
+   switch (order) {
+      case 1:
+         RunPolynomialEngine<1>(xo, yo, k_alpha, k_beta, k_count, h_alpha, h_beta, h_count, radius, obs, wells, nthreads, sink);
+         return;
+      case 2:
+         RunPolynomialEngine<2>(xo, yo, k_alpha, k_beta, k_count, h_alpha, h_beta, h_count, radius, obs, wells, nthreads, sink);
+         return;
+      case 3:
+         RunPolynomialEngine<3>(xo, yo, k_alpha, k_beta, k_count, h_alpha, h_beta, h_count, radius, obs, wells, nthreads, sink);
+         return;
+   }
+
+   std::stringstream message;
+   message << "Polynomial order " << order << " is not supported.";
+   throw std::invalid_argument(message.str());
+}
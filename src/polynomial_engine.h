@@ -0,0 +1,48 @@
+//=============================================================================
+// polynomial_engine.h
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#ifndef POLYNOMIAL_ENGINE_H
+#define POLYNOMIAL_ENGINE_H
+
+#include <vector>
+
+#include "matrix.h"
+#include "obs_table.h"
+#include "read_data.h"
+#include "result_sink.h"
+
+//-----------------------------------------------------------------------------
+// The polynomial orders for which the engine is compiled.
+//-----------------------------------------------------------------------------
+const int MINIMUM_ORDER = 1;
+const int MAXIMUM_ORDER = 3;
+
+//=============================================================================
+CellResult ComputePolynomialCellResult(
+   int order,
+   const Matrix& P_ev,
+   const Matrix& P_cov
+);
+
+void PolynomialEngine(
+   int order,
+   double xo, double yo,
+   double k_alpha, double k_beta, int k_count,
+   double h_alpha, double h_beta, int h_count,
+   double radius,
+   const ObsTable& obs,
+   const std::vector<WellRecord>& wells,
+   int nthreads,
+   ResultSink& sink
+);
+
+//=============================================================================
+#endif  // POLYNOMIAL_ENGINE_H
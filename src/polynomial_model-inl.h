@@ -0,0 +1,176 @@
+//=============================================================================
+// polynomial_model-inl.h
+//
+//    The polynomial discharge potential models, of any order, with their
+//    bases and normal equations fixed at compile time.
+//
+// notes:
+// o  The terms are listed by descending degree. Within degree d they are
+//    dx^d, dy^d, and then the mixed terms dx^(d-1) dy, ..., dx dy^(d-1).
+//    For ORDER = 2 this is the original quadratic basis,
+//
+//       {dx^2, dy^2, dx*dy, dx, dy, 1},
+//
+//    and the values are computed by the same products.
+//
+// o  Every loop bound is a compile-time constant, so the compiler can fully
+//    unroll the basis and the accumulation for each order.
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#ifndef POLYNOMIAL_MODEL_H
+#define POLYNOMIAL_MODEL_H
+
+#include <array>
+
+#include "matrix.h"
+
+//-----------------------------------------------------------------------------
+// One term of the basis, dx^px dy^py.
+//-----------------------------------------------------------------------------
+struct Monomial {
+   int px;
+   int py;
+};
+
+//-----------------------------------------------------------------------------
+// The number of terms in the complete polynomial of the given order.
+//-----------------------------------------------------------------------------
+constexpr int PolynomialTerms( int order )
+{
+   return (order+1)*(order+2)/2;
+}
+
+//-----------------------------------------------------------------------------
+// The terms of the complete polynomial of order ORDER, in basis order.
+//-----------------------------------------------------------------------------
+template <int ORDER>
+constexpr std::array<Monomial, PolynomialTerms(ORDER)> PolynomialMonomials()
+{
+   std::array<Monomial, PolynomialTerms(ORDER)> terms{};
+   int t = 0;
+   for (int d = ORDER; d >= 0; --d) {
+      terms[t++] = Monomial{d, 0};
+      if (d > 0) {
+         terms[t++] = Monomial{0, d};
+         for (int j = 1; j < d; ++j)
+            terms[t++] = Monomial{d-j, j};
+      }
+   }
+   return terms;
+}
+
+//-----------------------------------------------------------------------------
+// The position of dx^px dy^py in the basis, or -1 if it is not a term.
+//-----------------------------------------------------------------------------
+template <int ORDER>
+constexpr int PolynomialIndex( int px, int py )
+{
+   constexpr std::array<Monomial, PolynomialTerms(ORDER)> terms = PolynomialMonomials<ORDER>();
+   for (int t = 0; t < PolynomialTerms(ORDER); ++t) {
+      if (terms[t].px == px && terms[t].py == py)
+         return t;
+   }
+   return -1;
+}
+
+//=============================================================================
+// PolynomialModel
+//
+//    The basis of the discharge potential model of order ORDER, and the
+//    positions of the terms that the geohydrologic statistics need. The
+//    linear model has no second degree terms; XX and YY are then -1.
+//=============================================================================
+template <int ORDER>
+struct PolynomialModel {
+   static_assert(ORDER >= 1, "The polynomial model must be at least linear.");
+
+   static constexpr int TERMS = PolynomialTerms(ORDER);
+
+   static constexpr int XX = PolynomialIndex<ORDER>(2, 0);
+   static constexpr int YY = PolynomialIndex<ORDER>(0, 2);
+   static constexpr int X  = PolynomialIndex<ORDER>(1, 0);
+   static constexpr int Y  = PolynomialIndex<ORDER>(0, 1);
+
+   //--------------------------------------------------------------------------
+   // Fill row[0..TERMS-1] with the basis evaluated at (dx, dy).
+   //--------------------------------------------------------------------------
+   static void Basis( double dx, double dy, double* row )
+   {
+      constexpr std::array<Monomial, TERMS> terms = PolynomialMonomials<ORDER>();
+
+      double powx[ORDER+1];
+      double powy[ORDER+1];
+      powx[0] = 1;
+      powy[0] = 1;
+      for (int d = 1; d <= ORDER; ++d) {
+         powx[d] = powx[d-1] * dx;
+         powy[d] = powy[d-1] * dy;
+      }
+
+      for (int t = 0; t < TERMS; ++t)
+         row[t] = powx[terms[t].px] * powy[terms[t].py];
+   }
+};
+
+//=============================================================================
+// PolynomialEquations
+//
+//    Running sums of the weighted least squares normal equations, X'WX and
+//    X'Wy, and of y'Wy, for the model of order ORDER, in fixed-size arrays.
+//    Only the lower triangle of X'WX is accumulated.
+//=============================================================================
+template <int ORDER>
+class PolynomialEquations {
+   public:
+      static constexpr int TERMS = PolynomialModel<ORDER>::TERMS;
+
+      PolynomialEquations()
+      :  m_XtWX(),
+         m_XtWY(),
+         m_yWy( 0.0 ) {
+      }
+
+      void Add( const double* row, double w, double y )
+      {
+         for (int a = 0; a < TERMS; ++a) {
+            const double wx = w * row[a];
+            for (int b = 0; b <= a; ++b)
+               m_XtWX[a][b] += wx * row[b];
+            m_XtWY[a] += wx * y;
+         }
+         m_yWy += w * y * y;
+      }
+
+      void Assemble( Matrix& XtWX, Matrix& XtWY ) const
+      {
+         XtWX = Matrix(TERMS, TERMS);
+         XtWY = Matrix(TERMS, 1);
+         for (int a = 0; a < TERMS; ++a) {
+            for (int b = 0; b <= a; ++b) {
+               XtWX(a,b) = m_XtWX[a][b];
+               XtWX(b,a) = m_XtWX[a][b];
+            }
+            XtWY(a,0) = m_XtWY[a];
+         }
+      }
+
+      double yWy() const
+      {
+         return m_yWy;
+      }
+
+   private:
+      double m_XtWX[TERMS][TERMS];
+      double m_XtWY[TERMS];
+      double m_yWy;
+};
+
+//=============================================================================
+#endif  // POLYNOMIAL_MODEL_H
@@ -0,0 +1,257 @@
+//=============================================================================
+// preprocess.cpp
+//
+//    Optional reductions of the observation set, applied before the fit.
+//
+// notes:
+// o  Co-located observations are combined by inverse-variance weighting of
+//    the heads:
+//
+//       w_i     = 1/sd_i^2
+//       head_ev = sum(w_i head_i) / sum(w_i)
+//       head_sd = 1/sqrt(sum(w_i))
+//
+//    which is the minimum variance unbiased combination of independent
+//    readings of the same head. The combined location is the weighted mean
+//    of the locations, and the combined id is the id of the first reading.
+//
+// o  The same combination over larger grid cells thins a dense data set.
+//    The total weight is preserved, but the information matrix X'WX is not:
+//    the spread of the locations within each cell is lost. CovarianceChange
+//    measures the consequence for P_cov, and bounds it using
+//
+//       inv(A) - inv(B) = inv(A) (B - A) inv(B)
+//
+//    so that ||inv(A) - inv(B)|| / ||inv(A)|| <= ||B - A|| ||inv(B)||. Both
+//    are evaluated after a symmetric diagonal scaling of A and B.
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "engine.h"
+#include "normal_equations.h"
+#include "preprocess.h"
+
+//-----------------------------------------------------------------------------
+namespace {
+
+   //--------------------------------------------------------------------------
+   // A hashable, quantized (x,y) location.
+   //--------------------------------------------------------------------------
+   struct LocationKey {
+      int64_t ix;
+      int64_t iy;
+
+      bool operator==( const LocationKey& other ) const {
+         return ix == other.ix && iy == other.iy;
+      }
+   };
+
+   struct LocationKeyHash {
+      std::size_t operator()( const LocationKey& key ) const {
+         uint64_t h = static_cast<uint64_t>(key.ix) * 0x9E3779B97F4A7C15u;
+         h ^= static_cast<uint64_t>(key.iy) + 0x7F4A7C159E3779B9u + (h << 6) + (h >> 2);
+         return static_cast<std::size_t>(h);
+      }
+   };
+
+   //--------------------------------------------------------------------------
+   // With a zero tolerance the key is the bit pattern of the coordinate
+   // (with -0 folded onto +0), so only identical coordinates collide.
+   //--------------------------------------------------------------------------
+   int64_t Quantize( double v, double tolerance ) {
+      if (tolerance > 0)
+         return static_cast<int64_t>( std::floor(v/tolerance) );
+
+      if (v == 0.0)
+         v = 0.0;
+      int64_t bits;
+      memcpy(&bits, &v, sizeof(bits));
+      return bits;
+   }
+
+   LocationKey MakeKey( double x, double y, double tolerance ) {
+      return LocationKey{ Quantize(x, tolerance), Quantize(y, tolerance) };
+   }
+
+   //--------------------------------------------------------------------------
+   // The information matrix X'WX of all of the observations in the table.
+   //--------------------------------------------------------------------------
+   Matrix Information( double xo, double yo, double conductivity, double thickness, const ObsTable& obs ) {
+      NormalEquations equations;
+      double row[QUADRATIC_TERMS];
+
+      for (int m = 0; m < obs.size(); ++m) {
+         double Phi_ev, Phi_sd;
+         DischargePotential(obs.head_ev()[m], obs.head_sd()[m], conductivity, thickness, Phi_ev, Phi_sd);
+         QuadraticBasis(obs.x()[m] - xo, obs.y()[m] - yo, row);
+         equations.Add(row, 1.0/(Phi_sd*Phi_sd), 0.0);
+      }
+
+      Matrix XtWX, XtWY;
+      equations.Assemble(XtWX, XtWY);
+      return XtWX;
+   }
+}
+
+//=============================================================================
+// AggregateColocated
+//
+// Arguments:
+//    obs         the observations.
+//    tolerance   the side of the square cells; zero for exact matching.
+//
+// Returns:
+//    One observation per occupied location, in the order in which the
+//    locations first appear in "obs".
+//=============================================================================
+ObsTable AggregateColocated( const ObsTable& obs, double tolerance ) {
+   const int M = obs.size();
+
+   const double* obs_x       = obs.x();
+   const double* obs_y       = obs.y();
+   const double* obs_head_ev = obs.head_ev();
+   const double* obs_head_sd = obs.head_sd();
+
+   // The running weighted sums for each location.
+   struct Sums {
+      int    first;
+      int    count;
+      double w;
+      double wx;
+      double wy;
+      double wh;
+   };
+
+   std::unordered_map<LocationKey, int, LocationKeyHash> groups;
+   groups.reserve(M);
+   std::vector<Sums> sums;
+
+   for (int m = 0; m < M; ++m) {
+      LocationKey key = MakeKey(obs_x[m], obs_y[m], tolerance);
+      auto inserted = groups.emplace(key, static_cast<int>(sums.size()));
+      if (inserted.second)
+         sums.push_back( Sums{m, 0, 0.0, 0.0, 0.0, 0.0} );
+
+      Sums& s = sums[inserted.first->second];
+      double w = 1.0/(obs_head_sd[m]*obs_head_sd[m]);
+      s.count += 1;
+      s.w  += w;
+      s.wx += w*obs_x[m];
+      s.wy += w*obs_y[m];
+      s.wh += w*obs_head_ev[m];
+   }
+
+   // A location with a single reading is copied exactly.
+   std::vector<ObsRecord> records;
+   records.reserve(sums.size());
+
+   for (const Sums& s : sums) {
+      ObsRecord record = obs.record(s.first);
+      if (s.count > 1) {
+         record.x       = s.wx / s.w;
+         record.y       = s.wy / s.w;
+         record.head_ev = s.wh / s.w;
+         record.head_sd = 1.0/std::sqrt(s.w);
+      }
+      records.push_back(record);
+   }
+
+   return ObsTable(records);
+}
+
+//=============================================================================
+// CountUniqueLocations
+//=============================================================================
+int CountUniqueLocations( const ObsTable& obs, const std::vector<int>& active ) {
+   std::unordered_set<LocationKey, LocationKeyHash> locations;
+   locations.reserve(active.size());
+
+   for (int m : active)
+      locations.insert( MakeKey(obs.x()[m], obs.y()[m], 0.0) );
+
+   return locations.size();
+}
+
+//=============================================================================
+// EffectiveCount
+//=============================================================================
+double EffectiveCount( const ObsTable& obs ) {
+   double sum_w  = 0.0;
+   double sum_w2 = 0.0;
+
+   for (int m = 0; m < obs.size(); ++m) {
+      double w = 1.0/(obs.head_sd()[m]*obs.head_sd()[m]);
+      sum_w  += w;
+      sum_w2 += w*w;
+   }
+   return (sum_w2 > 0) ? sum_w*sum_w/sum_w2 : 0.0;
+}
+
+//=============================================================================
+// CovarianceChange
+//
+// Arguments:
+//    xo, yo         the model origin.
+//    conductivity   the aquifer conductivity and thickness at which the
+//    thickness      weights are evaluated.
+//    before         the full observation set.
+//    after          the reduced observation set.
+//    change         returned: ||P_after - P_before|| / ||P_before||.
+//    bound          returned: ||A_after - A_before|| ||inv(A_after)||, an
+//                   upper bound on "change", where A = X'WX.
+//
+//    All of the norms are Frobenius norms of the scaled matrices.
+//
+// Notes:
+// o  Throws CholeskyDecompositionFailed if either set of observations is
+//    too sparse to determine the quadratic model.
+//=============================================================================
+void CovarianceChange(
+   double xo, double yo,
+   double conductivity, double thickness,
+   const ObsTable& before,
+   const ObsTable& after,
+   double& change,
+   double& bound) {
+
+   Matrix A_before = Information(xo, yo, conductivity, thickness, before);
+   Matrix A_after  = Information(xo, yo, conductivity, thickness, after);
+
+   // The columns of X differ in scale by many orders of magnitude, so both
+   // information matrices are scaled by D = diag(A_before)^(-1/2); both the
+   // change and the bound are then independent of the units.
+   std::vector<double> d(QUADRATIC_TERMS);
+   for (int i = 0; i < QUADRATIC_TERMS; ++i)
+      d[i] = 1.0/std::sqrt( A_before(i,i) );
+
+   for (int i = 0; i < QUADRATIC_TERMS; ++i) {
+      for (int j = 0; j < QUADRATIC_TERMS; ++j) {
+         A_before(i,j) *= d[i]*d[j];
+         A_after(i,j)  *= d[i]*d[j];
+      }
+   }
+
+   Matrix zero(QUADRATIC_TERMS, 1, 0.0);
+   Matrix P_ev, P_before, P_after;
+   std::tie(P_ev, P_before) = SolveNormalEquations(A_before, zero);
+   std::tie(P_ev, P_after)  = SolveNormalEquations(A_after, zero);
+
+   Matrix dP, dA;
+   Subtract_MM(P_after, P_before, dP);
+   Subtract_MM(A_after, A_before, dA);
+
+   change = FNorm(dP) / FNorm(P_before);
+   bound  = FNorm(dA) * FNorm(P_after);
+}
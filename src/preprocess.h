@@ -0,0 +1,55 @@
+//=============================================================================
+// preprocess.h
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#ifndef PREPROCESS_H
+#define PREPROCESS_H
+
+#include <vector>
+
+#include "obs_table.h"
+
+//-----------------------------------------------------------------------------
+// Collapse co-located observations into one inverse-variance weighted
+// record. Two observations are co-located when their coordinates fall in the
+// same square cell of side "tolerance"; a tolerance of zero requires the
+// coordinates to be identical.
+//-----------------------------------------------------------------------------
+ObsTable AggregateColocated( const ObsTable& obs, double tolerance );
+
+//-----------------------------------------------------------------------------
+// The Kish effective number of observations, (sum w)^2 / sum(w^2), with the
+// inverse-variance weights w = 1/head_sd^2.
+//-----------------------------------------------------------------------------
+double EffectiveCount( const ObsTable& obs );
+
+//-----------------------------------------------------------------------------
+// The relative change, in the Frobenius norm, of the model parameter
+// covariance P_cov = inv(X'WX) at the given conductivity and thickness when
+// the observations "before" are replaced by "after", and an upper bound on
+// that change computed from the two information matrices alone.
+//-----------------------------------------------------------------------------
+void CovarianceChange(
+   double xo, double yo,
+   double conductivity, double thickness,
+   const ObsTable& before,
+   const ObsTable& after,
+   double& change,
+   double& bound
+);
+
+//-----------------------------------------------------------------------------
+// The number of distinct (x,y) locations among the observations selected by
+// the index view "active".
+//-----------------------------------------------------------------------------
+int CountUniqueLocations( const ObsTable& obs, const std::vector<int>& active );
+
+//=============================================================================
+#endif  // PREPROCESS_H
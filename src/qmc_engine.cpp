@@ -0,0 +1,494 @@
+//=============================================================================
+// qmc_engine.cpp
+//
+//    Randomized quasi-Monte Carlo distributions of the recharge, magnitude,
+//    and direction over the uncertain conductivity and thickness, and,
+//    optionally, the uncertain well discharges and well buffer radius.
+//
+// notes:
+// o  A tensor grid of set points needs count^d fits for d uncertain
+//    inputs. A low-discrepancy sequence covers the d-dimensional space with
+//    an error that falls almost as 1/S for S samples, for any d, compared
+//    with 1/sqrt(S) for plain Monte Carlo.
+//
+// o  The uncertain inputs are mapped from the sequence's uniform
+//    coordinates u by the standard normal quantile, z = GaussianCDFInv(u):
+//
+//       k      = exp(k_alpha + k_beta z)
+//       h      = exp(h_alpha + h_beta z)
+//       q_n    = q_n (1 + q_sd z)           for each well, if q_sd > 0
+//       radius = radius exp(radius_sd z)    if radius_sd > 0
+//
+//    so k, h, and the radius are lognormal, and each discharge is normal
+//    about its listed value with a relative standard deviation of q_sd.
+//
+// o  The error of a quasi-Monte Carlo mean cannot be estimated from the
+//    scatter of the samples. Instead, QMC_REPLICATES independently
+//    scrambled copies of the sequence are run side by side; their means
+//    are independent and unbiased, and the standard error of the overall
+//    mean is the standard deviation of the replicate means over
+//    sqrt(QMC_REPLICATES).
+//
+// o  The samples are evaluated in batches of QMC_BATCH per replicate, in
+//    parallel. After each batch the standard errors are updated, and the
+//    sampling stops early once the standard error of every mean is at most
+//    "target" times that statistic's total standard deviation. The last
+//    batch is cut short, as evenly as possible over the replicates, so that
+//    no more than max_samples are drawn.
+//
+// o  The well potential is linear in the discharges, so the per-unit-
+//    discharge potential of each well at each observation is computed once.
+//    Each sample then costs one pass over the observations that lie
+//    outside its buffer radius.
+//
+// o  A sample whose model cannot be fit, or whose buffer radius leaves
+//    fewer than MINIMUM_COUNT unique observation locations, is written with
+//    NaN results and left out of the summaries, as in the bootstrap. The
+//    directions are summarized relative to the direction at the median
+//    inputs.
+//
+// references:
+// o  Owen, A.B., 1998, Latin supercube sampling for very high-dimensional
+//    simulations, ACM Transactions on Modeling and Computer Simulation,
+//    8(1), 71-102.
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+
+#include "counter_rng-inl.h"
+#include "engine.h"
+#include "normal_equations.h"
+#include "numerical_constants.h"
+#include "parallel_for-inl.h"
+#include "preprocess.h"
+#include "qmc_engine.h"
+#include "special_functions.h"
+
+//-----------------------------------------------------------------------------
+namespace {
+
+   // The number of independently scrambled replicates of the sequence.
+   const int QMC_REPLICATES = 8;
+
+   // The number of samples per replicate in each batch.
+   const int QMC_BATCH = 32;
+
+   //--------------------------------------------------------------------------
+   // The first "count" primes.
+   //--------------------------------------------------------------------------
+   std::vector<int> Primes( int count ) {
+      std::vector<int> primes;
+      for (int p = 2; static_cast<int>(primes.size()) < count; ++p) {
+         bool is_prime = true;
+         for (int q : primes) {
+            if (q*q > p)
+               break;
+            if (p % q == 0) {
+               is_prime = false;
+               break;
+            }
+         }
+         if (is_prime)
+            primes.push_back(p);
+      }
+      return primes;
+   }
+
+   //--------------------------------------------------------------------------
+   // One evaluated sample.
+   //--------------------------------------------------------------------------
+   struct Sample {
+      double              k;
+      double              h;
+      double              radius;
+      std::vector<double> q;
+      CellResult          cell;
+      bool                ok;
+   };
+
+   //--------------------------------------------------------------------------
+   // The running sums of one statistic over one replicate; see
+   // QuadratureResultSink::Row.
+   //--------------------------------------------------------------------------
+   struct Accumulator {
+      int    count;
+      double mean;
+      double scatter;
+      double variance;
+   };
+
+   //--------------------------------------------------------------------------
+   // The statistics that are summarized.
+   //--------------------------------------------------------------------------
+   struct Statistic {
+      const char*         name;
+      double CellResult::*ev;
+      double CellResult::*sd;
+      double              scale;
+   };
+
+   const Statistic STATISTICS[] = {
+      {"recharge",  &CellResult::r_ev, &CellResult::r_sd, 1.0},
+      {"magnitude", &CellResult::m_ev, &CellResult::m_sd, 1.0},
+      {"direction", &CellResult::d_ev, &CellResult::d_sd, RAD_TO_DEG}
+   };
+
+   const int STATISTIC_COUNT = sizeof(STATISTICS)/sizeof(STATISTICS[0]);
+   const int DIRECTION = 2;
+
+   //--------------------------------------------------------------------------
+   // Combine the replicates of statistic s into one summary, unscaled.
+   //--------------------------------------------------------------------------
+   QmcSummary Summarize( const std::vector<Accumulator>& sums, int s, int& count ) {
+      count = 0;
+      double total = 0.0;
+      for (int r = 0; r < QMC_REPLICATES; ++r) {
+         const Accumulator& sum = sums[r*STATISTIC_COUNT + s];
+         count += sum.count;
+         total += sum.count * sum.mean;
+      }
+
+      QmcSummary summary = {NAN, NAN, NAN, NAN, NAN};
+      if (count == 0)
+         return summary;
+      summary.mean = total / count;
+
+      // The pooled within- and between-sample variances, and the scatter of
+      // the replicate means.
+      double scatter = 0.0, variance = 0.0;
+      double replicate_sum = 0.0, replicate_sum2 = 0.0;
+      int replicates = 0;
+      for (int r = 0; r < QMC_REPLICATES; ++r) {
+         const Accumulator& sum = sums[r*STATISTIC_COUNT + s];
+         if (sum.count == 0)
+            continue;
+         const double delta = sum.mean - summary.mean;
+         scatter  += sum.scatter + sum.count*delta*delta;
+         variance += sum.variance;
+         replicate_sum  += delta;
+         replicate_sum2 += delta*delta;
+         ++replicates;
+      }
+
+      const double between = scatter / count;
+      const double within  = variance / count;
+      summary.within_sd  = std::sqrt(within);
+      summary.between_sd = std::sqrt(between);
+      summary.sd         = std::sqrt(within + between);
+
+      if (replicates > 1) {
+         const double spread = (replicate_sum2 - replicate_sum*replicate_sum/replicates) / (replicates - 1);
+         summary.standard_error = std::sqrt(std::max(spread, 0.0) / replicates);
+      }
+      return summary;
+   }
+}
+
+//=============================================================================
+// ScrambledHalton
+//
+// notes:
+// o  Each dimension uses enough digit positions to resolve 2^-52. Since
+//    every position, including those beyond the last nonzero digit of the
+//    index, is permuted, the points are uniform rather than confined to a
+//    grid, and never exactly 0 or 1.
+//=============================================================================
+ScrambledHalton::ScrambledHalton( int dimensions, uint64_t key )
+:  m_Bases( Primes(dimensions) ),
+   m_Digits( dimensions ),
+   m_Permutations( dimensions ) {
+
+   uint64_t draw = 0;
+   for (int d = 0; d < dimensions; ++d) {
+      const int b = m_Bases[d];
+      m_Digits[d] = static_cast<int>( std::floor(52.0*LN_TWO / std::log(double(b))) );
+
+      std::vector<int>& permutation = m_Permutations[d];
+      permutation.resize(m_Digits[d] * b);
+      for (int p = 0; p < m_Digits[d]; ++p) {
+         int* digits = &permutation[p*b];
+         for (int j = 0; j < b; ++j)
+            digits[j] = j;
+
+         // Fisher-Yates.
+         for (int j = b-1; j > 0; --j) {
+            int i = static_cast<int>( CounterUniform(key, draw++) * (j+1) );
+            std::swap(digits[j], digits[std::min(i, j)]);
+         }
+      }
+   }
+}
+
+//-----------------------------------------------------------------------------
+double ScrambledHalton::operator()( uint64_t index, int dimension ) const {
+   const int b = m_Bases[dimension];
+   const int* permutation = m_Permutations[dimension].data();
+
+   double x = 0.0;
+   double scale = 1.0/b;
+   for (int p = 0; p < m_Digits[dimension]; ++p) {
+      x += permutation[p*b + static_cast<int>(index % b)] * scale;
+      index /= b;
+      scale /= b;
+   }
+
+   const double resolution = scale * b;
+   return std::min(std::max(x, 0.5*resolution), 1.0 - 0.5*resolution);
+}
+
+//=============================================================================
+// QmcEngine
+//
+//    Sample the uncertain inputs by randomized quasi-Monte Carlo, fit the
+//    quadratic model for each sample, and write
+//
+//    o  to "samples_out", one .csv line for each sample,
+//
+//          replicate, index, k, h, radius, q_<well id> ...,
+//          recharge_ev, ..., direction_sd
+//
+//       after a header line, and
+//
+//    o  to "summary_out", one .csv line for each of the recharge, magnitude,
+//       and direction,
+//
+//          statistic, samples, mean, standard_error, sd, within_sd,
+//          between_sd
+//
+//       after a header line, where sd is the total standard deviation, by
+//       the law of total variance, of the statistic over the samples.
+//
+//    The directions are in degrees.
+//
+// Arguments:
+//    xo, yo         the model origin.
+//    k_alpha, ...   the lognormal conductivity and thickness distributions.
+//    radius         the median well buffer radius.
+//    radius_sd      the log-standard deviation of the radius; 0 = fixed.
+//    obs            the observations.
+//    wells          the pumping wells.
+//    q_sd           the relative standard deviation of the discharges;
+//                   0 = fixed.
+//    max_samples    the largest number of samples, over all replicates.
+//    target         the largest standard error of a mean, as a fraction of
+//                   that statistic's standard deviation, that stops the
+//                   sampling early.
+//    seed           the random number stream for the scrambling.
+//    nthreads       the maximum number of threads; see ThreadCount.
+//    samples_out    the output stream for the samples.
+//    summary_out    the output stream for the summaries.
+//=============================================================================
+void QmcEngine(
+   double xo, double yo,
+   double k_alpha, double k_beta,
+   double h_alpha, double h_beta,
+   double radius, double radius_sd,
+   const ObsTable& obs,
+   const std::vector<WellRecord>& wells,
+   double q_sd,
+   int max_samples,
+   double target,
+   uint64_t seed,
+   int nthreads,
+   std::ostream& samples_out,
+   std::ostream& summary_out) {
+
+   // Manifest constants.
+   const int MINIMUM_COUNT = 10; // At least this many unique observation locations.
+
+   const int M = obs.size();
+   const int N = wells.size();
+   const int n = QUADRATIC_TERMS;
+
+   const bool vary_q = (q_sd > 0);
+   const bool vary_radius = (radius_sd > 0);
+   const int dimensions = 2 + (vary_q ? N : 0) + (vary_radius ? 1 : 0);
+
+   const std::vector<int> nominal = ActiveIndices(obs, wells, radius, false);
+   const int Munique = CountUniqueLocations(obs, nominal);
+   if (Munique < MINIMUM_COUNT) {
+      std::stringstream message;
+      message << "Too few unique active observation locations: " << Munique << " < " << MINIMUM_COUNT << std::endl;
+      throw TooFewObservations(message.str());
+   }
+
+   // The basis rows, the well potentials per unit discharge, and the
+   // distance to the nearest well, of every observation.
+   std::vector<double> rows(M*n);
+   std::vector<double> G(M*N);
+   std::vector<double> nearest(M, INF);
+   for (int m = 0; m < M; ++m) {
+      QuadraticBasis(obs.x()[m] - xo, obs.y()[m] - yo, &rows[m*n]);
+      for (int w = 0; w < N; ++w) {
+         const double distance = hypot(obs.x()[m] - wells[w].x, obs.y()[m] - wells[w].y);
+         G[m*N + w] = std::log(std::max(distance, wells[w].r)) / TWO_PI;
+         nearest[m] = std::min(nearest[m], distance);
+      }
+   }
+
+   const CellResult NO_RESULT = CellResult{NAN, NAN, NAN, NAN, NAN, NAN};
+
+   // Map the standard normal coordinates z to the inputs, and fit.
+   auto Evaluate = [&]( const std::vector<double>& z, Sample& sample ) {
+      int d = 2;
+      sample.k = exp(k_alpha + k_beta*z[0]);
+      sample.h = exp(h_alpha + h_beta*z[1]);
+      sample.q.resize(N);
+      for (int w = 0; w < N; ++w)
+         sample.q[w] = vary_q ? wells[w].q * (1.0 + q_sd*z[d++]) : wells[w].q;
+      sample.radius = vary_radius ? radius * exp(radius_sd*z[d++]) : radius;
+
+      std::vector<int> active;
+      for (int m = 0; m < M; ++m)
+         if (nearest[m] >= sample.radius)
+            active.push_back(m);
+
+      // Only a radius other than the nominal one can change the active set.
+      if (vary_radius && CountUniqueLocations(obs, active) < MINIMUM_COUNT) {
+         sample.ok = false;
+         sample.cell = NO_RESULT;
+         return;
+      }
+
+      NormalEquations equations;
+      for (int m : active) {
+         double Phi_ev, Phi_sd;
+         DischargePotential(obs.head_ev()[m], obs.head_sd()[m], sample.k, sample.h, Phi_ev, Phi_sd);
+
+         double Phi_wells = 0.0;
+         for (int w = 0; w < N; ++w)
+            Phi_wells += sample.q[w] * G[m*N + w];
+
+         equations.Add(&rows[m*n], 1.0/(Phi_sd*Phi_sd), Phi_ev - Phi_wells);
+      }
+
+      Matrix XtWX, XtWY;
+      equations.Assemble(XtWX, XtWY);
+
+      Matrix P_ev, P_cov;
+      std::tie(P_ev, P_cov) = SolveNormalEquations(XtWX, XtWY);
+      sample.cell = ComputeCellResult(P_ev, P_cov);
+      sample.ok = true;
+   };
+
+   // The direction at the median inputs, the reference for the directions.
+   Sample median;
+   Evaluate(std::vector<double>(dimensions, 0.0), median);
+   const double d0 = median.cell.d_ev;
+
+   std::vector<ScrambledHalton> sequences;
+   for (int r = 0; r < QMC_REPLICATES; ++r)
+      sequences.emplace_back(dimensions, CounterRandom(seed, r));
+
+   samples_out << "replicate,index,k,h,radius";
+   for (const WellRecord& well : wells)
+      samples_out << ",q_" << well.id;
+   for (int f = 0; f < RESULT_FIELD_COUNT; ++f)
+      samples_out << ',' << RESULT_FIELDS[f].name;
+   samples_out << '\n';
+   samples_out.precision(17);
+
+   const int per_batch = QMC_REPLICATES * QMC_BATCH;
+
+   std::vector<Accumulator> sums(QMC_REPLICATES * STATISTIC_COUNT, Accumulator{0, 0.0, 0.0, 0.0});
+   std::vector<QmcSummary> summaries(STATISTIC_COUNT);
+   std::vector<int> counts(STATISTIC_COUNT, 0);
+   bool converged = false;
+   int nsamples = 0;
+
+   for (int batch = 0; nsamples < max_samples && !converged; ++batch) {
+
+      // The slots t = r*QMC_BATCH + j drawn in this batch: j < QMC_BATCH
+      // for every replicate r, except in a last, partial batch.
+      const int remaining = max_samples - nsamples;
+      std::vector<int> slots;
+      for (int r = 0; r < QMC_REPLICATES; ++r) {
+         const int size = std::min(QMC_BATCH, (remaining + QMC_REPLICATES - 1 - r) / QMC_REPLICATES);
+         for (int j = 0; j < size; ++j)
+            slots.push_back(r*QMC_BATCH + j);
+      }
+
+      std::vector<Sample> samples(per_batch);
+
+      ParallelFor(0, static_cast<int>(slots.size()), nthreads, [&](int i) {
+         const int t = slots[i];
+         const int r = t / QMC_BATCH;
+         const uint64_t index = uint64_t(batch)*QMC_BATCH + t % QMC_BATCH;
+
+         std::vector<double> z(dimensions);
+         for (int d = 0; d < dimensions; ++d)
+            z[d] = GaussianCDFInv( sequences[r](index, d) );
+
+         try {
+            Evaluate(z, samples[t]);
+         }
+         catch (CholeskyDecompositionFailed&) {
+            samples[t].ok = false;
+            samples[t].cell = NO_RESULT;
+         }
+      });
+
+      // Write the samples, and fold them into the running sums in order.
+      for (int t : slots) {
+         const int r = t / QMC_BATCH;
+         Sample& sample = samples[t];
+
+         samples_out << r << ',' << uint64_t(batch)*QMC_BATCH + t % QMC_BATCH << ','
+                     << sample.k << ',' << sample.h << ',' << sample.radius;
+         for (double q : sample.q)
+            samples_out << ',' << q;
+         for (int f = 0; f < RESULT_FIELD_COUNT; ++f)
+            samples_out << ',' << RESULT_FIELDS[f].scale * (sample.cell.*RESULT_FIELDS[f].value);
+         samples_out << '\n';
+
+         if (!sample.ok)
+            continue;
+
+         for (int s = 0; s < STATISTIC_COUNT; ++s) {
+            double ev = sample.cell.*STATISTICS[s].ev;
+            const double sd = sample.cell.*STATISTICS[s].sd;
+            if (s == DIRECTION)
+               ev = d0 + std::remainder(ev - d0, TWO_PI);
+
+            Accumulator& sum = sums[r*STATISTIC_COUNT + s];
+            const double delta = ev - sum.mean;
+            sum.count    += 1;
+            sum.mean     += delta / sum.count;
+            sum.scatter  += delta * (ev - sum.mean);
+            sum.variance += sd * sd;
+         }
+      }
+      nsamples += static_cast<int>(slots.size());
+
+      // Stop once every mean is known well enough.
+      converged = true;
+      for (int s = 0; s < STATISTIC_COUNT; ++s) {
+         summaries[s] = Summarize(sums, s, counts[s]);
+         converged &= (summaries[s].standard_error <= target * summaries[s].sd);
+      }
+   }
+
+   std::cout << nsamples << " quasi-Monte Carlo samples in " << QMC_REPLICATES << " replicates of "
+             << dimensions << " dimensions; " << (converged ? "the standard errors reached the target." : "the standard errors did not reach the target.")
+             << std::endl;
+
+   summary_out << "statistic,samples,mean,standard_error,sd,within_sd,between_sd\n";
+   summary_out.precision(17);
+   for (int s = 0; s < STATISTIC_COUNT; ++s) {
+      const double scale = STATISTICS[s].scale;
+      const QmcSummary& summary = summaries[s];
+      summary_out << STATISTICS[s].name << ',' << counts[s] << ',' << scale*summary.mean << ','
+                  << scale*summary.standard_error << ',' << scale*summary.sd << ','
+                  << scale*summary.within_sd << ',' << scale*summary.between_sd << '\n';
+   }
+}
@@ -0,0 +1,74 @@
+//=============================================================================
+// qmc_engine.h
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#ifndef QMC_ENGINE_H
+#define QMC_ENGINE_H
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "obs_table.h"
+#include "read_data.h"
+
+//=============================================================================
+// ScrambledHalton
+//
+//    A randomly scrambled Halton sequence: the index is written in the
+//    prime base of each dimension, and every digit position has its own
+//    random permutation of the digits, drawn from the counter-based stream
+//    "key". Every point is uniform on (0,1)^dimensions, and different keys
+//    give independent randomizations of the same low-discrepancy set.
+//=============================================================================
+class ScrambledHalton {
+   public:
+      ScrambledHalton( int dimensions, uint64_t key );
+
+      double operator()( uint64_t index, int dimension ) const;
+
+   private:
+      std::vector<int>              m_Bases;
+      std::vector<int>              m_Digits;         // digit positions used
+      std::vector<std::vector<int>> m_Permutations;   // [dimension][position*base + digit]
+};
+
+//-----------------------------------------------------------------------------
+// The randomized quasi-Monte Carlo estimate of one statistic: the mean and
+// its standard error, and the total standard deviation with its within-
+// and between-sample parts; see QuadratureSummary.
+//-----------------------------------------------------------------------------
+struct QmcSummary {
+   double mean;
+   double standard_error;
+   double sd;
+   double within_sd;
+   double between_sd;
+};
+
+//=============================================================================
+void QmcEngine(
+   double xo, double yo,
+   double k_alpha, double k_beta,
+   double h_alpha, double h_beta,
+   double radius, double radius_sd,
+   const ObsTable& obs,
+   const std::vector<WellRecord>& wells,
+   double q_sd,
+   int max_samples,
+   double target,
+   uint64_t seed,
+   int nthreads,
+   std::ostream& samples_out,
+   std::ostream& summary_out
+);
+
+//=============================================================================
+#endif  // QMC_ENGINE_H
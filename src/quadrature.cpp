@@ -0,0 +1,186 @@
+//=============================================================================
+// quadrature.cpp
+//
+//    Integrate the statistics over the lognormal conductivity and thickness
+//    distributions by Gauss-Hermite quadrature in ln k and ln h.
+//
+// notes:
+// o  The equal-probability set points of SetPoints form a midpoint rule in
+//    probability, which converges slowly: the tails of the distributions
+//    are represented only by the outermost set points. The Gauss-Hermite
+//    rule with n nodes is exact for statistics that are polynomials of
+//    degree 2n-1 in ln k (or ln h), so a few nodes per axis integrate the
+//    smooth statistics as well as a much larger midpoint grid.
+//
+// o  The integrated mean of a statistic is E[ ev(k,h) ], and its total
+//    variance, by the law of total variance, is
+//
+//       E[ sd(k,h)^2 ] + Var[ ev(k,h) ],
+//
+//    the variance within a cell plus the variance between cells.
+//
+// o  The directions are summarized relative to the first direction, so
+//    that the statistics are not upset by the branch cut at +/-180 degrees,
+//    as in the bootstrap.
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#include <cmath>
+
+#include "numerical_constants.h"
+#include "quadrature.h"
+#include "special_functions.h"
+
+//-----------------------------------------------------------------------------
+namespace {
+
+   //--------------------------------------------------------------------------
+   // The statistics that are integrated, with their output names and scale
+   // factors.
+   //--------------------------------------------------------------------------
+   struct Statistic {
+      const char*         name;
+      double CellResult::*ev;
+      double CellResult::*sd;
+      double              scale;
+   };
+
+   const Statistic STATISTICS[] = {
+      {"recharge",  &CellResult::r_ev, &CellResult::r_sd, 1.0},
+      {"magnitude", &CellResult::m_ev, &CellResult::m_sd, 1.0},
+      {"direction", &CellResult::d_ev, &CellResult::d_sd, RAD_TO_DEG}
+   };
+
+   const int STATISTIC_COUNT = sizeof(STATISTICS)/sizeof(STATISTICS[0]);
+   const int DIRECTION = 2;
+}
+
+//=============================================================================
+// QuadraturePoints
+//
+//    The Gauss-Hermite nodes and weights for a lognormal distribution with
+//    log-mean "alpha" and log-standard deviation "beta": points[i] =
+//    exp(alpha + beta*z[i]), where z and the weights are the standard normal
+//    rule of GaussHermite. The points are in ascending order and the
+//    weights sum to one.
+//=============================================================================
+void QuadraturePoints(
+   double alpha, double beta, int count,
+   std::vector<double>& points,
+   std::vector<double>& weights) {
+
+   std::vector<double> z;
+   GaussHermite(count, z, weights);
+
+   points.resize(count);
+   for (int i = 0; i < count; ++i)
+      points[i] = exp(alpha + beta*z[i]);
+}
+
+//=============================================================================
+// QuadratureResultSink
+//=============================================================================
+QuadratureResultSink::QuadratureResultSink(
+   ResultSink& sink,
+   const std::vector<double>& k_weights,
+   const std::vector<double>& h_weights )
+:  m_Sink( sink ),
+   m_kWeights( k_weights ),
+   m_hWeights( h_weights ),
+   m_Sums( STATISTIC_COUNT, Accumulator{0.0, 0.0, 0.0, 0.0} ),
+   m_HasReference( false ),
+   m_Reference( 0.0 ) {
+}
+
+//-----------------------------------------------------------------------------
+void QuadratureResultSink::Begin( const std::vector<double>& k, const std::vector<double>& h ) {
+   m_Sink.Begin(k, h);
+}
+
+//-----------------------------------------------------------------------------
+// Forward the row, then fold each cell into the running sums with the
+// weighted update of West (1979), which does not lose the between-cell
+// variance to cancellation.
+//
+// references:
+// o  West, D.H.D., 1979, Updating mean and variance estimates: an improved
+//    method, Communications of the ACM, 22(9), 532-535.
+//-----------------------------------------------------------------------------
+void QuadratureResultSink::Row( int i, const std::vector<CellResult>& row ) {
+   m_Sink.Row(i, row);
+
+   for (int j = 0; j < static_cast<int>(row.size()); ++j) {
+      const double w = m_kWeights[i] * m_hWeights[j];
+
+      if (!m_HasReference) {
+         m_Reference = row[j].d_ev;
+         m_HasReference = true;
+      }
+
+      for (int s = 0; s < STATISTIC_COUNT; ++s) {
+         double ev = row[j].*STATISTICS[s].ev;
+         const double sd = row[j].*STATISTICS[s].sd;
+         if (s == DIRECTION)
+            ev = m_Reference + std::remainder(ev - m_Reference, TWO_PI);
+
+         Accumulator& sum = m_Sums[s];
+         const double total = sum.weight + w;
+         const double delta = ev - sum.mean;
+         const double R = delta * w / total;
+         sum.mean     += R;
+         sum.scatter  += sum.weight * delta * R;
+         sum.variance += w * sd * sd;
+         sum.weight    = total;
+      }
+   }
+}
+
+//-----------------------------------------------------------------------------
+void QuadratureResultSink::End() {
+   m_Sink.End();
+}
+
+//-----------------------------------------------------------------------------
+std::vector<QuadratureSummary> QuadratureResultSink::Summaries() const {
+   std::vector<QuadratureSummary> summaries;
+   for (int s = 0; s < STATISTIC_COUNT; ++s) {
+      const Accumulator& sum = m_Sums[s];
+      const double scale = STATISTICS[s].scale;
+
+      const double within  = sum.variance / sum.weight;
+      const double between = sum.scatter / sum.weight;
+
+      QuadratureSummary summary;
+      summary.mean       = scale * sum.mean;
+      summary.sd         = scale * std::sqrt(within + between);
+      summary.within_sd  = scale * std::sqrt(within);
+      summary.between_sd = scale * std::sqrt(between);
+      summaries.push_back(summary);
+   }
+   return summaries;
+}
+
+//=============================================================================
+// WriteQuadratureSummaries
+//
+//    Write one line for each statistic,
+//
+//       statistic, mean, sd, within_sd, between_sd
+//
+//    after a header line. The directions are in degrees.
+//=============================================================================
+void WriteQuadratureSummaries( std::ostream& out, const std::vector<QuadratureSummary>& summaries ) {
+   out << "statistic,mean,sd,within_sd,between_sd\n";
+   out.precision(17);
+   for (int s = 0; s < STATISTIC_COUNT; ++s) {
+      const QuadratureSummary& summary = summaries[s];
+      out << STATISTICS[s].name << ',' << summary.mean << ',' << summary.sd << ','
+          << summary.within_sd << ',' << summary.between_sd << '\n';
+   }
+}
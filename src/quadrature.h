@@ -0,0 +1,84 @@
+//=============================================================================
+// quadrature.h
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#ifndef QUADRATURE_H
+#define QUADRATURE_H
+
+#include <iostream>
+#include <vector>
+
+#include "result_sink.h"
+
+//-----------------------------------------------------------------------------
+// The integral of one statistic over the conductivity and thickness
+// distributions. By the law of total variance,
+//
+//    sd^2 = within_sd^2 + between_sd^2,
+//
+// where within_sd^2 = E[ sd(k,h)^2 ] is the mean of the per-cell variances,
+// and between_sd^2 = Var[ ev(k,h) ] is the variance of the per-cell
+// expected values.
+//-----------------------------------------------------------------------------
+struct QuadratureSummary {
+   double mean;
+   double sd;
+   double within_sd;
+   double between_sd;
+};
+
+//=============================================================================
+// QuadratureResultSink
+//
+//    Forwards the rows to another sink, and accumulates the quadrature of
+//    the recharge, magnitude, and direction over the (k,h) grid with the
+//    given weights as they go by.
+//=============================================================================
+class QuadratureResultSink : public ResultSink {
+   public:
+      QuadratureResultSink( ResultSink& sink, const std::vector<double>& k_weights, const std::vector<double>& h_weights );
+
+      void Begin( const std::vector<double>& k, const std::vector<double>& h );
+      void Row( int i, const std::vector<CellResult>& row );
+      void End();
+
+      // The summaries of the recharge, the magnitude, and the direction.
+      std::vector<QuadratureSummary> Summaries() const;
+
+   private:
+      struct Accumulator {
+         double weight;    // the sum of the weights
+         double mean;      // the weighted mean of ev
+         double scatter;   // the weighted sum of squared deviations of ev
+         double variance;  // the weighted sum of sd^2
+      };
+
+      ResultSink&              m_Sink;
+      std::vector<double>      m_kWeights;
+      std::vector<double>      m_hWeights;
+      std::vector<Accumulator> m_Sums;
+      bool                     m_HasReference;
+      double                   m_Reference;   // the first direction
+};
+
+//=============================================================================
+void QuadraturePoints(
+   double alpha, double beta, int count,
+   std::vector<double>& points,
+   std::vector<double>& weights
+);
+
+void WriteQuadratureSummaries(
+   std::ostream& out,
+   const std::vector<QuadratureSummary>& summaries
+);
+
+//=============================================================================
+#endif  // QUADRATURE_H
@@ -1,9 +1,14 @@
 //=============================================================================
 // read_data.cpp
 //
-//    Read in the observation data from the user-specified file.
+//    Read in the observation, well, and origin data from the user-specified
+//    files.
 //
 // notes:
+// o  Either file may also be in the binary columnar format written by
+//    "Gimiwan --convert"; such files are recognized by their header and
+//    loaded without parsing. See binary_data.cpp.
+//
 // o  This function uses Ben Strasser's "fast-cpp-csv-parser" to read in the
 //    .csv input file. See
 //
@@ -22,54 +27,185 @@
 #include <sstream>
 
 #include "../include/csv.h"
+#include "binary_data.h"
 #include "numerical_constants.h"
 #include "read_data.h"
 
+//-----------------------------------------------------------------------------
+namespace {
+   typedef io::CSVReader<5,
+      io::trim_chars<' ', '\t'>,
+      io::no_quote_escape<','>,
+      io::throw_on_overflow,
+      io::single_and_empty_line_comment<'!','#'>> ObsCSVReader;
+}
+
+//-----------------------------------------------------------------------------
+struct ObsChunkReader::Impl {
+   std::string                   filename;
+   std::unique_ptr<ObsCSVReader> csv;
+   std::unique_ptr<ColumnarFile> file;
+   int                           count;
+};
+
+//-----------------------------------------------------------------------------
+ObsChunkReader::ObsChunkReader( const std::string& obsfilename )
+:  m_Impl( new Impl ) {
+   m_Impl->filename = obsfilename;
+   m_Impl->count = 0;
+
+   if (is_binary_file(obsfilename)) {
+      try {
+         m_Impl->file.reset( new ColumnarFile(obsfilename, BINARY_OBSERVATIONS) );
+      } catch (InvalidBinaryFile& e) {
+         throw InvalidObsFile(e.what());
+      }
+      return;
+   }
+
+   try {
+      m_Impl->csv.reset( new ObsCSVReader(obsfilename) );
+   } catch (...) {
+      std::stringstream message;
+      message << "Could not open <" << obsfilename << "> for input.";
+      throw InvalidObsFile(message.str());
+   }
+}
+
+ObsChunkReader::~ObsChunkReader() {
+}
+
+//-----------------------------------------------------------------------------
+// Replace the contents of "chunk" with the next (at most) "max_count"
+// observation records. Returns false once the file is exhausted.
+//-----------------------------------------------------------------------------
+bool ObsChunkReader::read_chunk( std::vector<ObsRecord>& chunk, int max_count ) {
+   chunk.clear();
+
+   // Binary files are validated when the ColumnarFile is opened; copy the
+   // next run of records.
+   if (m_Impl->file) {
+      const ColumnarFile& file = *m_Impl->file;
+      int last = std::min(file.Count(), m_Impl->count + max_count);
+
+      for (int m = m_Impl->count; m < last; ++m) {
+         chunk.push_back( ObsRecord{ file.Id(m), file.Column(0)[m], file.Column(1)[m],
+                                     file.Column(2)[m], file.Column(3)[m] } );
+      }
+      m_Impl->count = last;
+      return !chunk.empty();
+   }
+
+   try {
+      std::string id;
+      double x, y, head_ev, head_sd;
+
+      while (static_cast<int>(chunk.size()) < max_count && m_Impl->csv->read_row(id, x, y, head_ev, head_sd)) {
+         if (head_ev < EPS) {
+            std::stringstream message;
+            message << "Invalid observation head_ev on line " << m_Impl->count+1 << " of file " << m_Impl->filename << ".";
+            throw InvalidObsRecord(message.str());
+         }
+
+         if (head_sd < EPS) {
+            std::stringstream message;
+            message << "Invalid observation head_sd on line " << m_Impl->count+1 << " of file " << m_Impl->filename << ".";
+            throw InvalidObsRecord(message.str());
+         }
+
+         ObsRecord s = {id, x, y, head_ev, head_sd};
+         chunk.push_back(s);
+         ++m_Impl->count;
+      }
+   } catch (InvalidObsRecord& e) {
+      throw;
+   } catch (...) {
+      std::stringstream message;
+      message << "Reading the observation data failed on line " << m_Impl->count+1 << " of file " << m_Impl->filename << ".";
+      throw InvalidObsRecord(message.str());
+   }
+
+   return !chunk.empty();
+}
+
 //-----------------------------------------------------------------------------
 std::vector<ObsRecord> read_obs_data( const std::string& obsfilename ) {
+   if (is_binary_file(obsfilename)) {
+      try {
+         return read_obs_binary(obsfilename);
+      } catch (InvalidBinaryFile& e) {
+         throw InvalidObsFile(e.what());
+      }
+   }
+
    std::vector<ObsRecord> obs;
+   std::vector<ObsRecord> chunk;
+
+   ObsChunkReader reader(obsfilename);
+   while (reader.read_chunk(chunk, 4096))
+      obs.insert(obs.end(), chunk.begin(), chunk.end());
+
+   return obs;
+}
+
+//-----------------------------------------------------------------------------
+// As read_obs_data, with a leading <snapshot ID> field on every line. Only
+// the .csv format is supported.
+//-----------------------------------------------------------------------------
+std::vector<SnapshotRecord> read_snapshot_data( const std::string& obsfilename ) {
+   std::vector<SnapshotRecord> records;
 
    try {
-      io::CSVReader<5,
+      io::CSVReader<6,
       io::trim_chars<' ', '\t'>,
       io::no_quote_escape<','>,
       io::throw_on_overflow,
       io::single_and_empty_line_comment<'!','#'>> in(obsfilename);
 
-      std::string id;
+      std::string snapshot_id, id;
       double x, y, head_ev, head_sd;
 
-      while (in.read_row(id, x, y, head_ev, head_sd)) {
+      while (in.read_row(snapshot_id, id, x, y, head_ev, head_sd)) {
          if (head_ev < EPS) {
             std::stringstream message;
-            message << "Invalid observation head_ev on line " << obs.size()+1 << " of file " << obsfilename << ".";
+            message << "Invalid observation head_ev on line " << records.size()+1 << " of file " << obsfilename << ".";
             throw InvalidObsRecord(message.str());
          }
 
          if (head_sd < EPS) {
             std::stringstream message;
-            message << "Invalid observation head_sd on line " << obs.size()+1 << " of file " << obsfilename << ".";
+            message << "Invalid observation head_sd on line " << records.size()+1 << " of file " << obsfilename << ".";
             throw InvalidObsRecord(message.str());
          }
 
-         ObsRecord s = {id, x, y, head_ev, head_sd};
-         obs.push_back(s);
+         SnapshotRecord s = {snapshot_id, ObsRecord{id, x, y, head_ev, head_sd}};
+         records.push_back(s);
       }
    } catch (io::error::can_not_open_file& e) {
       std::stringstream message;
       message << "Could not open <" << obsfilename << "> for input.";
       throw InvalidObsFile(message.str());
+   } catch (InvalidObsRecord& e) {
+      throw;
    } catch (...) {
       std::stringstream message;
-      message << "Reading the observation data failed on line " << obs.size()+1 << " of file " << obsfilename << ".";
+      message << "Reading the observation data failed on line " << records.size()+1 << " of file " << obsfilename << ".";
       throw InvalidObsRecord(message.str());
    }
 
-   return obs;
+   return records;
 }
 
 //-----------------------------------------------------------------------------
 std::vector<WellRecord> read_well_data( const std::string& wellfilename ) {
+   if (is_binary_file(wellfilename)) {
+      try {
+         return read_well_binary(wellfilename);
+      } catch (InvalidBinaryFile& e) {
+         throw InvalidWellFile(e.what());
+      }
+   }
+
    std::vector<WellRecord> wells;
 
    try {
@@ -98,3 +234,96 @@ std::vector<WellRecord> read_well_data( const std::string& wellfilename ) {
 
    return wells;
 }
+
+//-----------------------------------------------------------------------------
+std::vector<OriginRecord> read_origin_data( const std::string& originfilename ) {
+   std::vector<OriginRecord> origins;
+
+   try {
+      io::CSVReader<3,
+      io::trim_chars<' ', '\t'>,
+      io::no_quote_escape<','>,
+      io::throw_on_overflow,
+      io::single_and_empty_line_comment<'!','#'>> in(originfilename);
+
+      std::string id;
+      double x, y;
+
+      while (in.read_row(id, x, y)) {
+         OriginRecord o = {id, x, y};
+         origins.push_back(o);
+      }
+   } catch (io::error::can_not_open_file& e) {
+      std::stringstream message;
+      message << "Could not open <" << originfilename << "> for input.";
+      throw InvalidOriginFile(message.str());
+   } catch (...) {
+      std::stringstream message;
+      message << "Reading the origin data failed on line " << origins.size()+1 << " of file " << originfilename << ".";
+      throw InvalidOriginRecord(message.str());
+   }
+
+   return origins;
+}
+
+//-----------------------------------------------------------------------------
+std::vector<CandidateRecord> read_candidate_data( const std::string& candidatefilename ) {
+   std::vector<CandidateRecord> candidates;
+
+   try {
+      io::CSVReader<4,
+      io::trim_chars<' ', '\t'>,
+      io::no_quote_escape<','>,
+      io::throw_on_overflow,
+      io::single_and_empty_line_comment<'!','#'>> in(candidatefilename);
+
+      std::string id;
+      double x, y, head_sd;
+
+      while (in.read_row(id, x, y, head_sd)) {
+         CandidateRecord c = {id, x, y, head_sd};
+         candidates.push_back(c);
+      }
+   } catch (io::error::can_not_open_file& e) {
+      std::stringstream message;
+      message << "Could not open <" << candidatefilename << "> for input.";
+      throw InvalidCandidateFile(message.str());
+   } catch (...) {
+      std::stringstream message;
+      message << "Reading the candidate data failed on line " << candidates.size()+1 << " of file " << candidatefilename << ".";
+      throw InvalidCandidateRecord(message.str());
+   }
+
+   return candidates;
+}
+
+//-----------------------------------------------------------------------------
+std::vector<FactorRecord> read_factor_data( const std::string& factorfilename ) {
+   std::vector<FactorRecord> factors;
+
+   try {
+      io::CSVReader<3,
+      io::trim_chars<' ', '\t'>,
+      io::no_quote_escape<','>,
+      io::throw_on_overflow,
+      io::single_and_empty_line_comment<'!','#'>> in(factorfilename);
+
+      std::string obs_id, factor_id;
+      double head_sd;
+
+      while (in.read_row(obs_id, factor_id, head_sd)) {
+         FactorRecord f = {obs_id, factor_id, head_sd};
+         factors.push_back(f);
+      }
+   } catch (io::error::can_not_open_file& e) {
+      std::stringstream message;
+      message << "Could not open <" << factorfilename << "> for input.";
+      throw InvalidFactorFile(message.str());
+   } catch (...) {
+      std::stringstream message;
+      message << "Reading the factor data failed on line " << factors.size()+1 << " of file " << factorfilename << ".";
+      throw InvalidFactorRecord(message.str());
+   }
+
+   return factors;
+}
@@ -12,6 +12,7 @@
 #ifndef READ_DATA_H
 #define READ_DATA_H
 
+#include <memory>
 #include <stdexcept>
 #include <string>
 #include <tuple>
@@ -42,6 +43,42 @@ class InvalidWellRecord : public std::runtime_error {
       }
 };
 
+class InvalidOriginFile : public std::runtime_error {
+   public :
+      InvalidOriginFile( const std::string& message ) : std::runtime_error(message) {
+      }
+};
+
+class InvalidOriginRecord : public std::runtime_error {
+   public :
+      InvalidOriginRecord( const std::string& message ) : std::runtime_error(message) {
+      }
+};
+
+class InvalidCandidateFile : public std::runtime_error {
+   public :
+      InvalidCandidateFile( const std::string& message ) : std::runtime_error(message) {
+      }
+};
+
+class InvalidCandidateRecord : public std::runtime_error {
+   public :
+      InvalidCandidateRecord( const std::string& message ) : std::runtime_error(message) {
+      }
+};
+
+class InvalidFactorFile : public std::runtime_error {
+   public :
+      InvalidFactorFile( const std::string& message ) : std::runtime_error(message) {
+      }
+};
+
+class InvalidFactorRecord : public std::runtime_error {
+   public :
+      InvalidFactorRecord( const std::string& message ) : std::runtime_error(message) {
+      }
+};
+
 //-----------------------------------------------------------------------------
 struct ObsRecord{
    std::string id;
@@ -53,6 +90,34 @@ struct ObsRecord{
 
 std::vector<ObsRecord> read_obs_data( const std::string& inpfilename );
 
+//-----------------------------------------------------------------------------
+// ObsChunkReader
+//
+//    Read an observation file, either .csv or binary, a bounded number of
+//    records at a time.
+//-----------------------------------------------------------------------------
+class ObsChunkReader {
+   public:
+      explicit ObsChunkReader( const std::string& inpfilename );
+      ~ObsChunkReader();
+
+      bool read_chunk( std::vector<ObsRecord>& chunk, int max_count );
+
+   private:
+      struct Impl;
+      std::unique_ptr<Impl> m_Impl;
+};
+
+//-----------------------------------------------------------------------------
+// An observation taken on one date, or in one synoptic survey, of a series.
+//-----------------------------------------------------------------------------
+struct SnapshotRecord{
+   std::string snapshot_id;
+   ObsRecord obs;
+};
+
+std::vector<SnapshotRecord> read_snapshot_data( const std::string& inpfilename );
+
 //-----------------------------------------------------------------------------
 struct WellRecord{
    std::string id;
@@ -64,5 +129,41 @@ struct WellRecord{
 
 std::vector<WellRecord> read_well_data( const std::string& inpfilename );
 
+//-----------------------------------------------------------------------------
+struct OriginRecord{
+   std::string id;
+   double x;
+   double y;
+};
+
+std::vector<OriginRecord> read_origin_data( const std::string& inpfilename );
+
+//-----------------------------------------------------------------------------
+// A potential new observation site, with the anticipated standard deviation
+// of the head that would be measured there.
+//-----------------------------------------------------------------------------
+struct CandidateRecord{
+   std::string id;
+   double x;
+   double y;
+   double head_sd;
+};
+
+std::vector<CandidateRecord> read_candidate_data( const std::string& inpfilename );
+
+//-----------------------------------------------------------------------------
+// The loading of one observation on one shared error factor, such as a
+// survey datum or a sampling campaign: the standard deviation [L] of the
+// head error that the observation shares with every other observation on
+// the same factor.
+//-----------------------------------------------------------------------------
+struct FactorRecord{
+   std::string obs_id;
+   std::string factor_id;
+   double head_sd;
+};
+
+std::vector<FactorRecord> read_factor_data( const std::string& inpfilename );
+
 //=============================================================================
 #endif  // READ_DATA_H
@@ -0,0 +1,167 @@
+//=============================================================================
+// result_sink.cpp
+//
+//    The interface through which the engines hand over their results, row
+//    by row, as they are computed.
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#include "numerical_constants.h"
+#include "result_sink.h"
+
+//-----------------------------------------------------------------------------
+const ResultField RESULT_FIELDS[] = {
+   {"recharge_ev",  &CellResult::r_ev, 1.0},
+   {"recharge_sd",  &CellResult::r_sd, 1.0},
+   {"magnitude_ev", &CellResult::m_ev, 1.0},
+   {"magnitude_sd", &CellResult::m_sd, 1.0},
+   {"direction_ev", &CellResult::d_ev, RAD_TO_DEG},
+   {"direction_sd", &CellResult::d_sd, RAD_TO_DEG}
+};
+
+const int RESULT_FIELD_COUNT = sizeof(RESULT_FIELDS)/sizeof(RESULT_FIELDS[0]);
+
+const ResultField FIT_FIELDS[] = {
+   {"wrss",          &CellResult::wrss,          1.0},
+   {"reduced_chisq", &CellResult::reduced_chisq, 1.0},
+   {"loglik",        &CellResult::loglik,        1.0}
+};
+
+const int FIT_FIELD_COUNT = sizeof(FIT_FIELDS)/sizeof(FIT_FIELDS[0]);
+
+//-----------------------------------------------------------------------------
+std::vector<ResultField> OutputFields( bool fit ) {
+   std::vector<ResultField> fields(RESULT_FIELDS, RESULT_FIELDS + RESULT_FIELD_COUNT);
+   if (fit)
+      fields.insert(fields.end(), FIT_FIELDS, FIT_FIELDS + FIT_FIELD_COUNT);
+   return fields;
+}
+
+//-----------------------------------------------------------------------------
+ResultSink::~ResultSink() {
+}
+
+//=============================================================================
+// AsyncResultSink
+//=============================================================================
+AsyncResultSink::AsyncResultSink( ResultSink& sink, int capacity )
+:  m_Owned(),
+   m_Sink( sink ),
+   m_Capacity( capacity ),
+   m_Queue(),
+   m_Mutex(),
+   m_Changed(),
+   m_Done( false ),
+   m_Error(),
+   m_Thread() {
+}
+
+//-----------------------------------------------------------------------------
+// As above, but the AsyncResultSink takes ownership of the other sink.
+//-----------------------------------------------------------------------------
+AsyncResultSink::AsyncResultSink( std::unique_ptr<ResultSink> sink, int capacity )
+:  m_Owned( std::move(sink) ),
+   m_Sink( *m_Owned ),
+   m_Capacity( capacity ),
+   m_Queue(),
+   m_Mutex(),
+   m_Changed(),
+   m_Done( false ),
+   m_Error(),
+   m_Thread() {
+}
+
+AsyncResultSink::~AsyncResultSink() {
+   Stop();
+}
+
+//-----------------------------------------------------------------------------
+// Begin is forwarded synchronously, so that errors such as an output file
+// that cannot be opened are reported before any computation is done.
+//-----------------------------------------------------------------------------
+void AsyncResultSink::Begin( const std::vector<double>& k, const std::vector<double>& h ) {
+   m_Sink.Begin(k, h);
+   m_Done = false;
+   m_Thread = std::thread(&AsyncResultSink::Run, this);
+}
+
+//-----------------------------------------------------------------------------
+// Queue a copy of the row, waiting while the queue is full.
+//-----------------------------------------------------------------------------
+void AsyncResultSink::Row( int i, const std::vector<CellResult>& row ) {
+   {
+      std::unique_lock<std::mutex> lock(m_Mutex);
+      m_Changed.wait(lock, [this]{ return static_cast<int>(m_Queue.size()) < m_Capacity || m_Error; });
+      if (!m_Error)
+         m_Queue.emplace_back(i, row);
+   }
+   m_Changed.notify_all();
+   RethrowIfFailed();
+}
+
+//-----------------------------------------------------------------------------
+void AsyncResultSink::End() {
+   Stop();
+   RethrowIfFailed();
+   m_Sink.End();
+}
+
+//-----------------------------------------------------------------------------
+// The background thread: hand each queued row to the other sink.
+//-----------------------------------------------------------------------------
+void AsyncResultSink::Run() {
+   for (;;) {
+      std::pair<int, std::vector<CellResult>> item;
+      {
+         std::unique_lock<std::mutex> lock(m_Mutex);
+         m_Changed.wait(lock, [this]{ return !m_Queue.empty() || m_Done; });
+         if (m_Queue.empty())
+            return;
+         item = std::move(m_Queue.front());
+         m_Queue.pop_front();
+      }
+      m_Changed.notify_all();
+
+      try {
+         m_Sink.Row(item.first, item.second);
+      }
+      catch (...) {
+         std::lock_guard<std::mutex> lock(m_Mutex);
+         m_Error = std::current_exception();
+         m_Queue.clear();
+         m_Done = true;
+         m_Changed.notify_all();
+         return;
+      }
+   }
+}
+
+//-----------------------------------------------------------------------------
+// Drain the queue and join the background thread.
+//-----------------------------------------------------------------------------
+void AsyncResultSink::Stop() {
+   {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      m_Done = true;
+   }
+   m_Changed.notify_all();
+   if (m_Thread.joinable())
+      m_Thread.join();
+}
+
+//-----------------------------------------------------------------------------
+void AsyncResultSink::RethrowIfFailed() {
+   std::exception_ptr error;
+   {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      error = m_Error;
+   }
+   if (error)
+      std::rethrow_exception(error);
+}
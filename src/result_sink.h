@@ -0,0 +1,125 @@
+//=============================================================================
+// result_sink.h
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#ifndef RESULT_SINK_H
+#define RESULT_SINK_H
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// The statistics computed for one (k,h) cell: the recharge, the flow
+// magnitude, and the flow direction, and the goodness of fit of the model.
+// The goodness of fit is NaN unless the engine computes it.
+//-----------------------------------------------------------------------------
+struct CellResult {
+   double r_ev;
+   double r_sd;
+
+   double m_ev;
+   double m_sd;
+
+   double d_ev;
+   double d_sd;
+
+   double wrss          = std::numeric_limits<double>::quiet_NaN();   // weighted residual sum of squares
+   double reduced_chisq = std::numeric_limits<double>::quiet_NaN();   // wrss / (M - p), for M observations, p terms
+   double loglik        = std::numeric_limits<double>::quiet_NaN();   // Gaussian log-likelihood
+};
+
+//-----------------------------------------------------------------------------
+// The output name of each CellResult field, and the scale factor applied on
+// output (the directions are computed in radians, reported in degrees).
+//-----------------------------------------------------------------------------
+struct ResultField {
+   const char*        name;
+   double CellResult::*value;
+   double             scale;
+};
+
+extern const ResultField RESULT_FIELDS[];
+extern const int RESULT_FIELD_COUNT;
+
+extern const ResultField FIT_FIELDS[];
+extern const int FIT_FIELD_COUNT;
+
+//-----------------------------------------------------------------------------
+// The fields written by an output sink: RESULT_FIELDS, followed by
+// FIT_FIELDS if "fit" is true.
+//-----------------------------------------------------------------------------
+std::vector<ResultField> OutputFields( bool fit );
+
+//=============================================================================
+// ResultSink
+//
+//    Receives the results one row (fixed k, every h) at a time, as the
+//    engine completes them. The engine calls Begin once, then Row for
+//    i = 0, 1, ..., k_count-1 in order, then End.
+//=============================================================================
+class ResultSink {
+   public:
+      virtual ~ResultSink();
+
+      virtual void Begin( const std::vector<double>& k, const std::vector<double>& h ) = 0;
+      virtual void Row( int i, const std::vector<CellResult>& row ) = 0;
+      virtual void End() = 0;
+};
+
+//-----------------------------------------------------------------------------
+// Creates a new sink for the results with the given output file root.
+//-----------------------------------------------------------------------------
+typedef std::function<std::unique_ptr<ResultSink>( const std::string& )> ResultSinkFactory;
+
+//=============================================================================
+// AsyncResultSink
+//
+//    Forwards the rows to another sink on a background thread, through a
+//    bounded queue, so that the output I/O overlaps the computation. Any
+//    exception thrown by the other sink is rethrown from the next call to
+//    Row or End.
+//=============================================================================
+class AsyncResultSink : public ResultSink {
+   public:
+      AsyncResultSink( ResultSink& sink, int capacity );
+      AsyncResultSink( std::unique_ptr<ResultSink> sink, int capacity );
+      ~AsyncResultSink();
+
+      void Begin( const std::vector<double>& k, const std::vector<double>& h );
+      void Row( int i, const std::vector<CellResult>& row );
+      void End();
+
+   private:
+      void Run();
+      void Stop();
+      void RethrowIfFailed();
+
+      std::unique_ptr<ResultSink> m_Owned;
+      ResultSink&                 m_Sink;
+      const int                   m_Capacity;
+
+      std::deque<std::pair<int, std::vector<CellResult>>> m_Queue;
+      std::mutex                  m_Mutex;
+      std::condition_variable     m_Changed;
+      bool                        m_Done;
+      std::exception_ptr          m_Error;
+      std::thread                 m_Thread;
+};
+
+//=============================================================================
+#endif  // RESULT_SINK_H
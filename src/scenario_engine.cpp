@@ -0,0 +1,236 @@
+//=============================================================================
+// scenario_engine.cpp
+//
+//    A version of the Engine that evaluates several pumping scenarios, each
+//    with its own set of wells, in one pass over the (k,h) grid.
+//
+// notes:
+// o  The wells enter the model only through the right-hand side,
+//
+//       y = Phi_ev - Phi_wells,
+//
+//    so, for a given (k,h) cell, every scenario shares X and W. X'WX is
+//    accumulated and factored once per cell, and the S scenarios are solved
+//    together as the columns of one (6 x S) right-hand side, X'W [y_1 ...
+//    y_S]. P_cov = inv(X'WX) is the same for every scenario.
+//
+// o  The well buffer radius is applied with the wells of all of the
+//    scenarios together, so that every scenario is fit to the same active
+//    observations. A scenario's results therefore match a single-scenario
+//    run only when the other scenarios' wells deactivate no additional
+//    observations.
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+#include "engine.h"
+#include "linear_systems.h"
+#include "normal_equations.h"
+#include "parallel_for-inl.h"
+#include "preprocess.h"
+#include "scenario_engine.h"
+
+//=============================================================================
+// FitScenarios
+//
+// Arguments:
+//    rows           the M basis rows, QUADRATIC_TERMS values each.
+//    w              the M inverse variances.
+//    Y              the (M x S) right-hand-side values, one column per
+//                   scenario, stored by rows.
+//    nscenarios     the number of scenarios, S.
+//    P_ev           on exit, the (6 x S) expected values, one column per
+//                   scenario.
+//    P_cov          on exit, the (6 x 6) covariance, shared by every
+//                   scenario.
+//=============================================================================
+void FitScenarios(
+   const std::vector<double>& rows,
+   const std::vector<double>& w,
+   const std::vector<double>& Y,
+   int nscenarios,
+   Matrix& P_ev,
+   Matrix& P_cov) {
+   std::vector<double> wrss;
+   FitScenarios(rows, w, Y, nscenarios, P_ev, P_cov, wrss);
+}
+
+//-----------------------------------------------------------------------------
+// As above, and also computes the weighted residual sum of squares of each
+// scenario, wrss[s] = y_s'Wy_s - P_s'X'Wy_s; see WeightedResidualSumOfSquares.
+//-----------------------------------------------------------------------------
+void FitScenarios(
+   const std::vector<double>& rows,
+   const std::vector<double>& w,
+   const std::vector<double>& Y,
+   int nscenarios,
+   Matrix& P_ev,
+   Matrix& P_cov,
+   std::vector<double>& wrss) {
+
+   const int M = w.size();
+   const int n = QUADRATIC_TERMS;
+   const int S = nscenarios;
+
+   // The lower triangle of X'WX, all of X'WY, and the diagonal of Y'WY.
+   Matrix XtWX(n, n, 0.0);
+   Matrix XtWY(n, S, 0.0);
+   std::vector<double> yWy(S, 0.0);
+
+   for (int m = 0; m < M; ++m) {
+      const double* x = &rows[m*n];
+      const double* y = &Y[m*S];
+      for (int a = 0; a < n; ++a) {
+         const double wx = w[m] * x[a];
+         for (int b = 0; b <= a; ++b)
+            XtWX(a,b) += wx * x[b];
+
+         double* f = XtWY.Base(a, 0);
+         for (int s = 0; s < S; ++s)
+            f[s] += wx * y[s];
+      }
+      for (int s = 0; s < S; ++s)
+         yWy[s] += w[m] * y[s] * y[s];
+   }
+   for (int a = 0; a < n; ++a)
+      for (int b = a+1; b < n; ++b)
+         XtWX(a,b) = XtWX(b,a);
+
+   Matrix L;
+   if (!CholeskyDecomposition(XtWX, L)) {
+      std::stringstream message;
+      message << "Cholesky Decomposition failed." << std::endl;
+      throw CholeskyDecompositionFailed(message.str());
+   }
+
+   CholeskySolve(L, XtWY, P_ev);
+   CholeskyInverse(L, P_cov);
+
+   wrss.resize(S);
+   for (int s = 0; s < S; ++s) {
+      double fitted = 0.0;
+      for (int t = 0; t < n; ++t)
+         fitted += P_ev(t,s) * XtWY(t,s);
+      wrss[s] = std::max(yWy[s] - fitted, 0.0);
+   }
+}
+
+//=============================================================================
+// ScenarioEngine
+//
+//    As Engine, for every scenario at once.
+//
+// Arguments:
+//    xo, yo         the model origin.
+//    k_alpha, ...   the conductivity and thickness distributions, as in
+//                   Engine.
+//    radius         the well buffer radius.
+//    obs            the observations.
+//    scenarios      the pumping scenarios.
+//    nthreads       the maximum number of threads; see ThreadCount. The
+//                   cells of each row are fit in parallel.
+//    make_sink      called once per scenario, with the scenario's name, for
+//                   the sink that receives its results.
+//=============================================================================
+void ScenarioEngine(
+   double xo, double yo,
+   double k_alpha, double k_beta, int k_count,
+   double h_alpha, double h_beta, int h_count,
+   double radius,
+   const ObsTable& obs,
+   const std::vector<Scenario>& scenarios,
+   int nthreads,
+   const ResultSinkFactory& make_sink) {
+
+   // Manifest constants.
+   const int MINIMUM_COUNT = 10; // At least this many unique observation locations.
+
+   const int S = scenarios.size();
+
+   // Deactivate the observations that are too close to any scenario's wells.
+   std::vector<WellRecord> all_wells;
+   for (const Scenario& scenario : scenarios)
+      all_wells.insert(all_wells.end(), scenario.wells.begin(), scenario.wells.end());
+
+   const std::vector<int> active = ActiveIndices(obs, all_wells, radius, true);
+
+   int Mactive = active.size();
+   int Munique = CountUniqueLocations(obs, active);
+   if (Munique < MINIMUM_COUNT) {
+      std::stringstream message;
+      message << "Too few unique active observation locations: " << Munique << " < " << MINIMUM_COUNT << std::endl;
+      throw TooFewObservations(message.str());
+   }
+   std::cout << Mactive << " active observation data records at " << Munique << " unique locations." << std::endl;
+   std::cout << S << " pumping scenarios share each factorization." << std::endl;
+
+   const int M = Mactive;
+   const int n = QUADRATIC_TERMS;
+
+   // The basis rows and the well potentials do not depend on k or h.
+   std::vector<double> rows(M*n);
+   std::vector<double> Phi_wells(M*S);
+   for (int m = 0; m < M; ++m) {
+      const double x = obs.x()[active[m]];
+      const double y = obs.y()[active[m]];
+      QuadraticBasis(x - xo, y - yo, &rows[m*n]);
+      for (int s = 0; s < S; ++s)
+         Phi_wells[m*S + s] = WellPotential(x, y, scenarios[s].wells);
+   }
+
+   std::vector<double> k = SetPoints(k_alpha, k_beta, k_count);
+   std::vector<double> h = SetPoints(h_alpha, h_beta, h_count);
+
+   const double log_head_sd = HeadLogSdSum(obs, active);
+
+   std::vector<std::unique_ptr<ResultSink>> sinks;
+   for (const Scenario& scenario : scenarios) {
+      sinks.push_back( make_sink(scenario.name) );
+      sinks.back()->Begin(k, h);
+   }
+
+   // results[s][j] holds the current row of results for scenario s.
+   std::vector<std::vector<CellResult>> results(S, std::vector<CellResult>(h_count));
+
+   for (int i = 0; i < k_count; ++i) {
+      ParallelFor(0, h_count, nthreads, [&](int j) {
+         std::vector<double> w(M);
+         std::vector<double> Y(M*S);
+         for (int m = 0; m < M; ++m) {
+            double Phi_ev, Phi_sd;
+            DischargePotential(obs.head_ev()[active[m]], obs.head_sd()[active[m]], k[i], h[j], Phi_ev, Phi_sd);
+            w[m] = 1.0/(Phi_sd*Phi_sd);
+            for (int s = 0; s < S; ++s)
+               Y[m*S + s] = Phi_ev - Phi_wells[m*S + s];
+         }
+
+         Matrix P_ev, P_cov;
+         std::vector<double> wrss;
+         FitScenarios(rows, w, Y, S, P_ev, P_cov, wrss);
+
+         Matrix P(n, 1);
+         for (int s = 0; s < S; ++s) {
+            for (int t = 0; t < n; ++t)
+               P(t,0) = P_ev(t,s);
+            results[s][j] = ComputeCellResult(P, P_cov);
+            SetGoodnessOfFit(results[s][j], wrss[s], M, n, log_head_sd);
+         }
+      });
+
+      for (int s = 0; s < S; ++s)
+         sinks[s]->Row(i, results[s]);
+   }
+
+   for (std::unique_ptr<ResultSink>& sink : sinks)
+      sink->End();
+}
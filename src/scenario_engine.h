@@ -0,0 +1,64 @@
+//=============================================================================
+// scenario_engine.h
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#ifndef SCENARIO_ENGINE_H
+#define SCENARIO_ENGINE_H
+
+#include <string>
+#include <vector>
+
+#include "matrix.h"
+#include "obs_table.h"
+#include "read_data.h"
+#include "result_sink.h"
+
+//-----------------------------------------------------------------------------
+// One pumping scenario: a set of wells, and the name handed to the sink
+// factory for its results.
+//-----------------------------------------------------------------------------
+struct Scenario {
+   std::string             name;
+   std::vector<WellRecord> wells;
+};
+
+//=============================================================================
+void FitScenarios(
+   const std::vector<double>& rows,
+   const std::vector<double>& w,
+   const std::vector<double>& Y,
+   int nscenarios,
+   Matrix& P_ev,
+   Matrix& P_cov
+);
+
+void FitScenarios(
+   const std::vector<double>& rows,
+   const std::vector<double>& w,
+   const std::vector<double>& Y,
+   int nscenarios,
+   Matrix& P_ev,
+   Matrix& P_cov,
+   std::vector<double>& wrss
+);
+
+void ScenarioEngine(
+   double xo, double yo,
+   double k_alpha, double k_beta, int k_count,
+   double h_alpha, double h_beta, int h_count,
+   double radius,
+   const ObsTable& obs,
+   const std::vector<Scenario>& scenarios,
+   int nthreads,
+   const ResultSinkFactory& make_sink
+);
+
+//=============================================================================
+#endif  // SCENARIO_ENGINE_H
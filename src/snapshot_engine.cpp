@@ -0,0 +1,278 @@
+//=============================================================================
+// snapshot_engine.cpp
+//
+//    A version of the Engine that fits every snapshot (date, or synoptic
+//    survey) of a series of head observations in one run.
+//
+// notes:
+// o  Snapshots whose observations are at the same locations, in the same
+//    order, share a layout: the same active observations, basis rows, and
+//    well potentials.
+//
+// o  Within a layout, at a given (k,h) cell, the snapshots differ only in
+//    their weights and right-hand sides. The weights depend on head_sd
+//    alone at every observation on the confined branch (head_ev >= h), and
+//    on head_ev as well on the unconfined branch. At every cell the
+//    snapshots whose weights coincide exactly are grouped, and each group
+//    is fit with one factorization and a multiple right-hand side solve
+//    (see FitScenarios).
+//
+// o  A layout is processed SNAPSHOT_BATCH snapshots at a time, so that only
+//    that many output sinks are open at once.
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <unordered_map>
+
+#include "engine.h"
+#include "normal_equations.h"
+#include "parallel_for-inl.h"
+#include "preprocess.h"
+#include "scenario_engine.h"
+#include "snapshot_engine.h"
+
+//-----------------------------------------------------------------------------
+namespace {
+
+   // The largest number of snapshots processed, and output sinks open, at
+   // one time.
+   const int SNAPSHOT_BATCH = 64;
+
+   //--------------------------------------------------------------------------
+   // An FNV-1a hash of the observation locations, used to find the
+   // snapshots that share a layout.
+   //--------------------------------------------------------------------------
+   uint64_t LocationHash( const ObsTable& obs ) {
+      uint64_t hash = 14695981039346656037ULL;
+      for (int m = 0; m < obs.size(); ++m) {
+         const double xy[2] = { obs.x()[m], obs.y()[m] };
+         unsigned char bytes[sizeof(xy)];
+         memcpy(bytes, xy, sizeof(xy));
+         for (unsigned char b : bytes) {
+            hash ^= b;
+            hash *= 1099511628211ULL;
+         }
+      }
+      return hash;
+   }
+
+   //--------------------------------------------------------------------------
+   bool SameLocations( const ObsTable& a, const ObsTable& b ) {
+      return a.size() == b.size()
+         && std::equal(a.x(), a.x() + a.size(), b.x())
+         && std::equal(a.y(), a.y() + a.size(), b.y());
+   }
+
+   //--------------------------------------------------------------------------
+   // Group the snapshots into layouts, in order of first appearance.
+   //--------------------------------------------------------------------------
+   std::vector<std::vector<int>> FindLayouts( const std::vector<Snapshot>& snapshots ) {
+      std::vector<std::vector<int>> layouts;
+      std::unordered_multimap<uint64_t, int> index;
+
+      for (int s = 0; s < static_cast<int>(snapshots.size()); ++s) {
+         const uint64_t hash = LocationHash(snapshots[s].obs);
+
+         int found = -1;
+         auto range = index.equal_range(hash);
+         for (auto it = range.first; it != range.second && found < 0; ++it) {
+            if (SameLocations(snapshots[layouts[it->second][0]].obs, snapshots[s].obs))
+               found = it->second;
+         }
+
+         if (found < 0) {
+            found = layouts.size();
+            layouts.push_back( std::vector<int>() );
+            index.insert( std::make_pair(hash, found) );
+         }
+         layouts[found].push_back(s);
+      }
+      return layouts;
+   }
+}
+
+//=============================================================================
+// BuildSnapshots
+//
+//    Split the records into snapshots, in order of first appearance. The
+//    observations of each snapshot keep their order in the file.
+//=============================================================================
+std::vector<Snapshot> BuildSnapshots( const std::vector<SnapshotRecord>& records ) {
+   std::map<std::string, int> index;
+   std::vector<std::string> names;
+   std::vector<std::vector<ObsRecord>> obs;
+
+   for (const SnapshotRecord& record : records) {
+      auto inserted = index.insert(std::make_pair(record.snapshot_id, static_cast<int>(names.size())));
+      if (inserted.second) {
+         names.push_back(record.snapshot_id);
+         obs.push_back( std::vector<ObsRecord>() );
+      }
+      obs[inserted.first->second].push_back(record.obs);
+   }
+
+   std::vector<Snapshot> snapshots;
+   for (size_t s = 0; s < names.size(); ++s)
+      snapshots.push_back( Snapshot{names[s], ObsTable(obs[s])} );
+   return snapshots;
+}
+
+//=============================================================================
+// SnapshotEngine
+//
+//    As Engine, for every snapshot.
+//
+// Arguments:
+//    xo, yo         the model origin.
+//    k_alpha, ...   the conductivity and thickness distributions, as in
+//                   Engine.
+//    radius         the well buffer radius.
+//    snapshots      the snapshots.
+//    wells          the pumping wells.
+//    nthreads       the maximum number of threads; see ThreadCount. The
+//                   cells of each row are fit in parallel.
+//    make_sink      called once per snapshot, with the snapshot's name, for
+//                   the sink that receives its results.
+//=============================================================================
+void SnapshotEngine(
+   double xo, double yo,
+   double k_alpha, double k_beta, int k_count,
+   double h_alpha, double h_beta, int h_count,
+   double radius,
+   const std::vector<Snapshot>& snapshots,
+   const std::vector<WellRecord>& wells,
+   int nthreads,
+   const ResultSinkFactory& make_sink) {
+
+   // Manifest constants.
+   const int MINIMUM_COUNT = 10; // At least this many unique observation locations.
+
+   const int n = QUADRATIC_TERMS;
+
+   std::vector<double> k = SetPoints(k_alpha, k_beta, k_count);
+   std::vector<double> h = SetPoints(h_alpha, h_beta, h_count);
+
+   std::vector<std::vector<int>> layouts = FindLayouts(snapshots);
+   std::cout << snapshots.size() << " snapshots at " << layouts.size() << " distinct sets of locations." << std::endl;
+
+   std::atomic<long> factorizations(0);
+
+   for (const std::vector<int>& layout : layouts) {
+      const ObsTable& first = snapshots[layout[0]].obs;
+
+      const std::vector<int> active = ActiveIndices(first, wells, radius, false);
+
+      int Mactive = active.size();
+      int Munique = CountUniqueLocations(first, active);
+      if (Munique < MINIMUM_COUNT) {
+         std::stringstream message;
+         message << "Too few unique active observation locations in snapshot " << snapshots[layout[0]].name
+                 << ": " << Munique << " < " << MINIMUM_COUNT << std::endl;
+         throw TooFewObservations(message.str());
+      }
+      std::cout << layout.size() << " snapshots with " << Mactive << " active observation data records at "
+                << Munique << " unique locations." << std::endl;
+
+      const int M = Mactive;
+
+      // The basis rows and the well potentials are shared by the layout.
+      std::vector<double> rows(M*n);
+      std::vector<double> Phi_wells(M);
+      for (int m = 0; m < M; ++m) {
+         QuadraticBasis(first.x()[active[m]] - xo, first.y()[active[m]] - yo, &rows[m*n]);
+         Phi_wells[m] = WellPotential(first.x()[active[m]], first.y()[active[m]], wells);
+      }
+
+      for (size_t begin = 0; begin < layout.size(); begin += SNAPSHOT_BATCH) {
+         const int B = std::min(layout.size() - begin, static_cast<size_t>(SNAPSHOT_BATCH));
+
+         std::vector<std::unique_ptr<ResultSink>> sinks;
+         for (int b = 0; b < B; ++b) {
+            sinks.push_back( make_sink(snapshots[layout[begin+b]].name) );
+            sinks.back()->Begin(k, h);
+         }
+
+         std::vector<double> log_head_sd;
+         for (int b = 0; b < B; ++b)
+            log_head_sd.push_back( HeadLogSdSum(snapshots[layout[begin+b]].obs, active) );
+
+         // results[b][j] holds the current row of results for snapshot b.
+         std::vector<std::vector<CellResult>> results(B, std::vector<CellResult>(h_count));
+
+         for (int i = 0; i < k_count; ++i) {
+            ParallelFor(0, h_count, nthreads, [&](int j) {
+               std::vector<double> w(B*M);
+               std::vector<double> Phi_ev(B*M);
+               for (int b = 0; b < B; ++b) {
+                  const ObsTable& obs = snapshots[layout[begin+b]].obs;
+                  for (int m = 0; m < M; ++m) {
+                     double Phi_sd;
+                     DischargePotential(obs.head_ev()[active[m]], obs.head_sd()[active[m]], k[i], h[j], Phi_ev[b*M + m], Phi_sd);
+                     w[b*M + m] = 1.0/(Phi_sd*Phi_sd);
+                  }
+               }
+
+               // Sort the snapshots by their weights, so that those with
+               // identical weights are adjacent.
+               std::vector<int> order(B);
+               std::iota(order.begin(), order.end(), 0);
+               std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+                  return std::lexicographical_compare(&w[a*M], &w[a*M] + M, &w[b*M], &w[b*M] + M);
+               });
+
+               for (int g = 0; g < B; ) {
+                  const double* wg = &w[order[g]*M];
+                  int last = g+1;
+                  while (last < B && std::equal(wg, wg + M, &w[order[last]*M]))
+                     ++last;
+
+                  const int G = last - g;
+                  std::vector<double> Y(M*G);
+                  for (int m = 0; m < M; ++m)
+                     for (int c = 0; c < G; ++c)
+                        Y[m*G + c] = Phi_ev[order[g+c]*M + m] - Phi_wells[m];
+
+                  Matrix P_ev, P_cov;
+                  std::vector<double> wrss;
+                  FitScenarios(rows, std::vector<double>(wg, wg + M), Y, G, P_ev, P_cov, wrss);
+                  ++factorizations;
+
+                  Matrix P(n, 1);
+                  for (int c = 0; c < G; ++c) {
+                     const int b = order[g+c];
+                     for (int t = 0; t < n; ++t)
+                        P(t,0) = P_ev(t,c);
+                     results[b][j] = ComputeCellResult(P, P_cov);
+                     SetGoodnessOfFit(results[b][j], wrss[c], M, n, log_head_sd[b]);
+                  }
+                  g = last;
+               }
+            });
+
+            for (int b = 0; b < B; ++b)
+               sinks[b]->Row(i, results[b]);
+         }
+
+         for (std::unique_ptr<ResultSink>& sink : sinks)
+            sink->End();
+      }
+   }
+
+   std::cout << static_cast<long>(snapshots.size())*k_count*h_count << " snapshot fits from "
+             << factorizations.load() << " factorizations." << std::endl;
+}
@@ -0,0 +1,48 @@
+//=============================================================================
+// snapshot_engine.h
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#ifndef SNAPSHOT_ENGINE_H
+#define SNAPSHOT_ENGINE_H
+
+#include <string>
+#include <vector>
+
+#include "obs_table.h"
+#include "read_data.h"
+#include "result_sink.h"
+
+//-----------------------------------------------------------------------------
+// The observations of one snapshot, and the name handed to the sink factory
+// for its results.
+//-----------------------------------------------------------------------------
+struct Snapshot {
+   std::string name;
+   ObsTable    obs;
+};
+
+//=============================================================================
+std::vector<Snapshot> BuildSnapshots(
+   const std::vector<SnapshotRecord>& records
+);
+
+void SnapshotEngine(
+   double xo, double yo,
+   double k_alpha, double k_beta, int k_count,
+   double h_alpha, double h_beta, int h_count,
+   double radius,
+   const std::vector<Snapshot>& snapshots,
+   const std::vector<WellRecord>& wells,
+   int nthreads,
+   const ResultSinkFactory& make_sink
+);
+
+//=============================================================================
+#endif  // SNAPSHOT_ENGINE_H
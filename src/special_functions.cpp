@@ -15,6 +15,7 @@
 // version:
 //    30 June 2017
 //=============================================================================
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 
@@ -449,3 +450,93 @@ double GaussianCDFInv(double p)
 
    return (p<0.5 ? u : -u);
 }
+
+//-----------------------------------------------------------------------------
+// GaussHermite
+//
+//    Computes the n nodes, in ascending order, and the n weights of the
+//    Gauss-Hermite quadrature rule for the standard normal distribution,
+//
+//       E[f(Z)] ~ sum_i weights[i] f(nodes[i]),
+//
+//    which is exact for polynomials of degree 2n-1 or less. The weights sum
+//    to one.
+//
+// notes:
+// o  The nodes are the roots of the n'th orthonormal (probabilists')
+//    Hermite polynomial, p_n, found by Newton's method with the recurrence
+//
+//       p_{j+1}(z) = ( z p_j(z) - sqrt(j) p_{j-1}(z) ) / sqrt(j+1),
+//
+//    and p_n'(z) = sqrt(n) p_{n-1}(z). The weight of node z is then
+//    1 / (n p_{n-1}(z)^2).
+//
+// o  The initial guesses are those of gauher in Press et al. (2007), scaled
+//    from the physicists' to the probabilists' polynomials.
+//
+// references:
+// o  Press, W.H., Teukolsky, S.A., Vetterling, W.T., and Flannery, B.P.,
+//    2007, Numerical Recipes, The Art of Scientific Computing, 3rd edition,
+//    Cambridge University Press, ISBN 978-0-521-88068-8, section 4.6.
+//-----------------------------------------------------------------------------
+void GaussHermite( int n, std::vector<double>& nodes, std::vector<double>& weights )
+{
+   assert( n > 0 );
+
+   const int MAXIT = 100;
+   const double TOLERANCE = 1e-14;
+
+   nodes.assign(n, 0.0);
+   weights.assign(n, 0.0);
+
+   // The nonnegative roots, largest first.
+   std::vector<double> roots;
+
+   double z = 0.0;
+   for (int i = 0; i < (n+1)/2; ++i) {
+      if (i == 0)
+         z = SQRT_TWO * (sqrt(2.0*n + 1.0) - 1.85575*pow(2.0*n + 1.0, -0.16667));
+      else if (i == 1)
+         z -= 2.28*pow(double(n), 0.426)/z;
+      else if (i == 2)
+         z = 1.86*z - 0.86*roots[0];
+      else if (i == 3)
+         z = 1.91*z - 0.91*roots[1];
+      else
+         z = 2.0*z - roots[i-2];
+
+      double p_n = 0.0, p_n1 = 0.0;
+      for (int it = 0; it < MAXIT; ++it) {
+         p_n  = 1.0;
+         p_n1 = 0.0;
+         for (int j = 0; j < n; ++j) {
+            const double p = (z*p_n - sqrt(double(j))*p_n1) / sqrt(j + 1.0);
+            p_n1 = p_n;
+            p_n  = p;
+         }
+
+         const double dz = p_n / (sqrt(double(n))*p_n1);
+         z -= dz;
+         if (fabs(dz) <= TOLERANCE*std::max(1.0, fabs(z)))
+            break;
+      }
+
+      // The weight, from p_{n-1} at the converged root.
+      p_n  = 1.0;
+      p_n1 = 0.0;
+      for (int j = 0; j < n-1; ++j) {
+         const double p = (z*p_n - sqrt(double(j))*p_n1) / sqrt(j + 1.0);
+         p_n1 = p_n;
+         p_n  = p;
+      }
+
+      if (2*i+1 == n)
+         z = 0.0;            // the middle root of an odd rule, exactly
+      roots.push_back(z);
+
+      nodes[i]       = -z;
+      nodes[n-1-i]   = z;
+      weights[n-1-i] = 1.0/(n*p_n*p_n);
+      weights[i]     = weights[n-1-i];
+   }
+}
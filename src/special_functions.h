@@ -13,6 +13,7 @@
 #define SPECIAL_FUNCTIONS_H
 
 #include <iostream>
+#include <vector>
 
 double Beta( double a, double b );
 double IncompleteBeta( double x, double a, double b );
@@ -25,5 +26,7 @@ double IncompleteGammaInv( double p, double a );
 double GaussianCDF( double x );
 double GaussianCDFInv( double p );
 
+void GaussHermite( int n, std::vector<double>& nodes, std::vector<double>& weights );
+
 //=============================================================================
 #endif  // SPECIAL_FUNCTIONS_H
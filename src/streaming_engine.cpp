@@ -0,0 +1,186 @@
+//=============================================================================
+// streaming_engine.cpp
+//
+//    A single-pass version of the Engine for observation sets that are too
+//    large to hold in memory.
+//
+// notes:
+// o  The observation file is read a chunk at a time. Each chunk is filtered
+//    against the well buffers, corrected for the well potentials, and then
+//    folded directly into one set of normal equations for every (k,h) cell.
+//    The M x 6 X, the M x M Vinv and the M x 1 Y are never built, so the
+//    memory required is proportional to the grid size, not to M.
+//
+// o  Because V is diagonal, X'inv(V)X and X'inv(V)Y are sums of independent
+//    per-observation terms, so the results are the same as the Engine's up
+//    to round-off.
+//
+// o  The sum of log(head_sd) needed for the log-likelihood is accumulated
+//    one chunk at a time.
+//
+// o  As in the Engine, at least MINIMUM_COUNT unique active observation
+//    locations are required. Only the first MINIMUM_COUNT distinct
+//    locations are kept, so the check takes fixed memory, and the number of
+//    unique locations is reported only when it falls short.
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#include <algorithm>
+#include <math.h>
+#include <sstream>
+#include <utility>
+
+#include "normal_equations.h"
+#include "streaming_engine.h"
+
+//=============================================================================
+// StreamingEngine
+//
+// Arguments:
+//    xo, yo         the model origin.
+//    k_alpha, ...   the conductivity and thickness distributions, as in
+//                   Engine.
+//    radius         the well buffer radius.
+//    obsfilename    the observation file, .csv or binary.
+//    wells          the pumping wells.
+//    chunk_size     the maximum number of observations held at one time.
+//    sink           receives each row of results as soon as it is solved.
+//=============================================================================
+void StreamingEngine(
+   double xo, double yo,
+   double k_alpha, double k_beta, int k_count,
+   double h_alpha, double h_beta, int h_count,
+   double radius,
+   const std::string& obsfilename,
+   const std::vector<WellRecord>& wells,
+   int chunk_size,
+   ResultSink& sink) {
+
+   // Manifest constants.
+   const int MINIMUM_COUNT = 10; // At least this many unique observation locations.
+
+   const int N = wells.size();   // number of pumping wells
+
+   // Compute the set-points for both k and h.
+   std::vector<double> k = SetPoints(k_alpha, k_beta, k_count);
+   std::vector<double> h = SetPoints(h_alpha, h_beta, h_count);
+
+   // One set of normal equations for each (k,h) cell.
+   std::vector<NormalEquations> cells(k_count * h_count);
+   double log_head_sd = 0.0;
+
+   // The per-chunk quantities that do not depend on k or h.
+   std::vector<double> rows(chunk_size * QUADRATIC_TERMS);
+   std::vector<double> head_ev(chunk_size);
+   std::vector<double> head_sd(chunk_size);
+   std::vector<double> Phi_wells(chunk_size);
+
+   ObsChunkReader reader(obsfilename);
+   std::vector<ObsRecord> chunk;
+   int M = 0;                    // number of observations read
+   int Mactive = 0;              // number of active observations
+
+   // The first MINIMUM_COUNT distinct active locations.
+   std::vector<std::pair<double,double>> locations;
+
+   while (reader.read_chunk(chunk, chunk_size)) {
+
+      // Deactivate observations that are too close to a pumping well, and
+      // set up everything about the remaining ones that is independent of
+      // the conductivity and thickness.
+      int count = 0;
+      for (const ObsRecord& ob : chunk) {
+         bool is_active = true;
+         for (int n = 0; n < N; ++n) {
+            double separation_distance = hypot(ob.x-wells[n].x, ob.y-wells[n].y);
+            if (separation_distance < radius) {
+               is_active = false;
+               std::cout << " --Obs(" << M << ") deactivated due to proximity with Well(" << n << ")" << std::endl;
+            }
+         }
+         ++M;
+
+         if (is_active) {
+            QuadraticBasis(ob.x - xo, ob.y - yo, &rows[count*QUADRATIC_TERMS]);
+            head_ev[count]   = ob.head_ev;
+            head_sd[count]   = ob.head_sd;
+            log_head_sd     += std::log(ob.head_sd);
+            Phi_wells[count] = WellPotential(ob.x, ob.y, wells);
+            ++count;
+
+            const std::pair<double,double> location(ob.x, ob.y);
+            if (static_cast<int>(locations.size()) < MINIMUM_COUNT && std::find(locations.begin(), locations.end(), location) == locations.end())
+               locations.push_back(location);
+         }
+      }
+      Mactive += count;
+
+      // Fold the chunk into every cell.
+      for (int i = 0; i < k_count; ++i) {
+         for (int j = 0; j < h_count; ++j) {
+            NormalEquations& cell = cells[i*h_count + j];
+
+            for (int m = 0; m < count; ++m) {
+               double Phi_ev, Phi_sd;
+               DischargePotential(head_ev[m], head_sd[m], k[i], h[j], Phi_ev, Phi_sd);
+               cell.Add(&rows[m*QUADRATIC_TERMS], 1.0/(Phi_sd*Phi_sd), Phi_ev - Phi_wells[m]);
+            }
+         }
+      }
+   }
+
+   std::cout << M << " observation data records streamed from <" << obsfilename << ">." << std::endl;
+
+   const int Munique = locations.size();
+   if (Munique < MINIMUM_COUNT) {
+      std::stringstream message;
+      message << "Too few unique active observation locations: " << Munique << " < " << MINIMUM_COUNT << std::endl;
+      throw TooFewObservations(message.str());
+   }
+   std::cout << Mactive << " active observation data records." << std::endl;
+
+   // Solve the normal equations for every cell, and emit the results one
+   // row at a time.
+   sink.Begin(k, h);
+
+   std::vector<CellResult> row(h_count);
+
+   for (int i = 0; i < k_count; ++i) {
+      for (int j = 0; j < h_count; ++j) {
+         const NormalEquations& cell = cells[i*h_count + j];
+
+         Matrix XtWX, XtWY;
+         cell.Assemble(XtWX, XtWY);
+
+         Matrix P_ev, P_cov;
+         std::tie(P_ev, P_cov) = SolveNormalEquations(XtWX, XtWY);
+
+         row[j] = ComputeCellResult(P_ev, P_cov);
+         SetGoodnessOfFit(row[j], WeightedResidualSumOfSquares(cell.yWy(), XtWY, P_ev), Mactive, QUADRATIC_TERMS, log_head_sd);
+      }
+      sink.Row(i, row);
+   }
+
+   sink.End();
+}
+
+//-----------------------------------------------------------------------------
+Results StreamingEngine(
+   double xo, double yo,
+   double k_alpha, double k_beta, int k_count,
+   double h_alpha, double h_beta, int h_count,
+   double radius,
+   const std::string& obsfilename,
+   const std::vector<WellRecord>& wells,
+   int chunk_size) {
+   Results results;
+   MemoryResultSink sink(results);
+   StreamingEngine(xo, yo, k_alpha, k_beta, k_count, h_alpha, h_beta, h_count, radius, obsfilename, wells, chunk_size, sink);
+   return results;
+}
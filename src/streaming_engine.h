@@ -0,0 +1,44 @@
+//=============================================================================
+// streaming_engine.h
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#ifndef STREAMING_ENGINE_H
+#define STREAMING_ENGINE_H
+
+#include <string>
+#include <vector>
+
+#include "engine.h"
+#include "read_data.h"
+
+//=============================================================================
+void StreamingEngine(
+   double xo, double yo,
+   double k_alpha, double k_beta, int k_count,
+   double h_alpha, double h_beta, int h_count,
+   double radius,
+   const std::string& obsfilename,
+   const std::vector<WellRecord>& wells,
+   int chunk_size,
+   ResultSink& sink
+);
+
+Results StreamingEngine(
+   double xo, double yo,
+   double k_alpha, double k_beta, int k_count,
+   double h_alpha, double h_beta, int h_count,
+   double radius,
+   const std::string& obsfilename,
+   const std::vector<WellRecord>& wells,
+   int chunk_size
+);
+
+//=============================================================================
+#endif  // STREAMING_ENGINE_H
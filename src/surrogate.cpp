@@ -0,0 +1,445 @@
+//=============================================================================
+// surrogate.cpp
+//
+//    A polynomial chaos surrogate of the Engine's results over the
+//    uncertain conductivity and thickness, which can be evaluated at any
+//    (k,h) without refitting the model.
+//
+// notes:
+// o  The coefficients are the projections of each quantity onto the
+//    orthonormal Hermite polynomials, computed with the (degree+1) x
+//    (degree+1) Gauss-Hermite product rule (see QuadraturePoints). The rule
+//    is exact for every term when the quantity itself is a polynomial of
+//    degree "degree" in each variable, so the error of the surrogate is
+//    only the truncation of the expansion.
+//
+// o  The discharge potential and its standard deviation are proportional
+//    to k, and hence so are the recharge, the magnitude, and their standard
+//    deviations. The surrogate expands the logarithms of the standard
+//    deviations, which are then linear in ln k, and the recharge and
+//    magnitude as multiples of their standard deviations, which are then
+//    free of k, so that a low degree suffices. The standard deviations of
+//    the surrogate are always positive.
+//
+// o  The directions are unwrapped relative to the direction at the center
+//    node before the projection, and wrapped back on evaluation.
+//
+// o  The approximation error is measured, not estimated: the surrogate is
+//    compared with the Engine at the (degree+1) x (degree+1) equal
+//    probability set points, none of which is a quadrature node, and the
+//    root mean square and largest errors are stored with the coefficients.
+//
+// o  Evaluating the surrogate costs (degree+1)(degree+2)/2 terms, regardless
+//    of the number of observations. Far outside the two distributions it
+//    extrapolates, and the stored errors do not apply.
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+#include "engine.h"
+#include "numerical_constants.h"
+#include "special_functions.h"
+#include "surrogate.h"
+
+//-----------------------------------------------------------------------------
+namespace {
+
+   // The largest degree that a surrogate file may specify.
+   const int MAXIMUM_DEGREE = 40;
+
+   // The number of expanded quantities, one for each of RESULT_FIELDS.
+   const int QUANTITIES = 6;
+
+   // The names of the expanded quantities, in the order of RESULT_FIELDS.
+   const char* const COEFFICIENT_NAMES[] = {
+      "recharge_ratio",  "recharge_ln_sd",
+      "magnitude_ratio", "magnitude_ln_sd",
+      "direction",       "direction_ln_sd"
+   };
+
+   const int DIRECTION = 4;
+
+   //--------------------------------------------------------------------------
+   // The orthonormal probabilists' Hermite polynomials psi_0 ... psi_degree
+   // at x, by the recurrence
+   //
+   //    psi_(n+1) = (x psi_n - sqrt(n) psi_(n-1)) / sqrt(n+1).
+   //--------------------------------------------------------------------------
+   void HermiteBasis( double x, int degree, double* psi ) {
+      psi[0] = 1.0;
+      if (degree > 0)
+         psi[1] = x;
+      for (int n = 1; n < degree; ++n)
+         psi[n+1] = (x*psi[n] - std::sqrt(double(n))*psi[n-1]) / std::sqrt(double(n+1));
+   }
+
+   //--------------------------------------------------------------------------
+   // The expanded quantities of one cell.
+   //--------------------------------------------------------------------------
+   void Transform( const CellResult& cell, double* g ) {
+      g[0] = cell.r_ev / cell.r_sd;
+      g[1] = std::log(cell.r_sd);
+      g[2] = cell.m_ev / cell.m_sd;
+      g[3] = std::log(cell.m_sd);
+      g[4] = cell.d_ev;
+      g[5] = std::log(cell.d_sd);
+   }
+
+   //--------------------------------------------------------------------------
+   // Cell (i,j) of the results.
+   //--------------------------------------------------------------------------
+   CellResult CellAt( const Results& results, int i, int j ) {
+      CellResult cell;
+      cell.r_ev = results.R_ev(i,j);
+      cell.r_sd = results.R_sd(i,j);
+      cell.m_ev = results.M_ev(i,j);
+      cell.m_sd = results.M_sd(i,j);
+      cell.d_ev = results.D_ev(i,j);
+      cell.d_sd = results.D_sd(i,j);
+      return cell;
+   }
+
+   //--------------------------------------------------------------------------
+   // The comma-separated fields of one line.
+   //--------------------------------------------------------------------------
+   std::vector<std::string> Fields( const std::string& line ) {
+      std::vector<std::string> fields;
+      std::istringstream in(line);
+      std::string field;
+      while (std::getline(in, field, ','))
+         fields.push_back(field);
+      return fields;
+   }
+
+   //--------------------------------------------------------------------------
+   // Read the next line of a surrogate file, which must have "count" fields.
+   //--------------------------------------------------------------------------
+   std::vector<std::string> NextLine( std::istream& in, size_t count, int& line, const std::string& filename ) {
+      std::string text;
+      ++line;
+      if (!std::getline(in, text)) {
+         std::stringstream message;
+         message << "Unexpected end of surrogate file " << filename << " at line " << line << ".";
+         throw InvalidSurrogateFile(message.str());
+      }
+      if (!text.empty() && text.back() == '\r')
+         text.pop_back();
+
+      std::vector<std::string> fields = Fields(text);
+      if (fields.size() != count) {
+         std::stringstream message;
+         message << "Expected " << count << " fields on line " << line << " of surrogate file " << filename << ".";
+         throw InvalidSurrogateFile(message.str());
+      }
+      return fields;
+   }
+
+   //--------------------------------------------------------------------------
+   double Number( const std::string& field, int line, const std::string& filename ) {
+      std::istringstream in(field);
+      double value;
+      if (!(in >> value) || !(in >> std::ws).eof()) {
+         std::stringstream message;
+         message << "Invalid number <" << field << "> on line " << line << " of surrogate file " << filename << ".";
+         throw InvalidSurrogateFile(message.str());
+      }
+      return value;
+   }
+
+   //--------------------------------------------------------------------------
+   void ExpectHeader( const std::vector<std::string>& fields, const std::vector<std::string>& header, int line, const std::string& filename ) {
+      if (fields != header) {
+         std::stringstream message;
+         message << "Invalid header on line " << line << " of surrogate file " << filename << ".";
+         throw InvalidSurrogateFile(message.str());
+      }
+   }
+
+   //--------------------------------------------------------------------------
+   std::vector<std::string> CoefficientHeader() {
+      std::vector<std::string> header = {"a", "b"};
+      header.insert(header.end(), COEFFICIENT_NAMES, COEFFICIENT_NAMES + QUANTITIES);
+      return header;
+   }
+}
+
+//=============================================================================
+// Surrogate
+//=============================================================================
+Surrogate::Surrogate()
+:  k_alpha( 0.0 ),
+   k_beta( 1.0 ),
+   h_alpha( 0.0 ),
+   h_beta( 1.0 ),
+   degree( 0 ),
+   coefficients( 1, QUANTITIES, 0.0 ),
+   rms_error( QUANTITIES, NAN ),
+   max_error( QUANTITIES, NAN ) {
+}
+
+//-----------------------------------------------------------------------------
+Surrogate::Surrogate( double k_alpha, double k_beta, double h_alpha, double h_beta, int degree )
+:  k_alpha( k_alpha ),
+   k_beta( k_beta ),
+   h_alpha( h_alpha ),
+   h_beta( h_beta ),
+   degree( degree ),
+   coefficients( (degree+1)*(degree+2)/2, QUANTITIES, 0.0 ),
+   rms_error( QUANTITIES, NAN ),
+   max_error( QUANTITIES, NAN ) {
+}
+
+//-----------------------------------------------------------------------------
+// The number of terms: those of total degree 0, then 1, ..., then degree.
+// Within total degree d the terms are psi_d(xi), psi_(d-1)(xi) psi_1(eta),
+// ..., psi_d(eta).
+//-----------------------------------------------------------------------------
+int Surrogate::Terms() const {
+   return (degree+1)*(degree+2)/2;
+}
+
+//-----------------------------------------------------------------------------
+// The surrogate results at (k,h). The goodness of fit is not modeled, and
+// is NaN.
+//-----------------------------------------------------------------------------
+CellResult Surrogate::operator()( double k, double h ) const {
+   std::vector<double> psi_k(degree+1), psi_h(degree+1);
+   HermiteBasis((std::log(k) - k_alpha)/k_beta, degree, psi_k.data());
+   HermiteBasis((std::log(h) - h_alpha)/h_beta, degree, psi_h.data());
+
+   double g[QUANTITIES] = {0.0};
+   int t = 0;
+   for (int d = 0; d <= degree; ++d) {
+      for (int a = d; a >= 0; --a, ++t) {
+         const double psi = psi_k[a] * psi_h[d-a];
+         for (int s = 0; s < QUANTITIES; ++s)
+            g[s] += coefficients(t,s) * psi;
+      }
+   }
+
+   CellResult cell;
+   cell.r_sd = std::exp(g[1]);
+   cell.r_ev = g[0] * cell.r_sd;
+   cell.m_sd = std::exp(g[3]);
+   cell.m_ev = g[2] * cell.m_sd;
+   cell.d_ev = std::remainder(g[4], TWO_PI);
+   cell.d_sd = std::exp(g[5]);
+   return cell;
+}
+
+//=============================================================================
+// FitSurrogate
+//
+//    Fit the surrogate of the given degree from (degree+1)^2 Engine fits at
+//    the Gauss-Hermite nodes, and measure its errors at (degree+1)^2 more.
+//
+// Arguments:
+//    xo, yo         the model origin.
+//    k_alpha, ...   the lognormal conductivity and thickness distributions.
+//    degree         the largest total degree of the expansion.
+//    radius         the well buffer radius.
+//    obs            the observations.
+//    wells          the pumping wells.
+//    nthreads       the maximum number of threads; see ThreadCount.
+//=============================================================================
+Surrogate FitSurrogate(
+   double xo, double yo,
+   double k_alpha, double k_beta,
+   double h_alpha, double h_beta,
+   int degree,
+   double radius,
+   const ObsTable& obs,
+   const std::vector<WellRecord>& wells,
+   int nthreads) {
+
+   const int n = degree + 1;
+
+   std::vector<double> z, w;
+   GaussHermite(n, z, w);
+
+   std::vector<double> k(n), h(n);
+   for (int i = 0; i < n; ++i) {
+      k[i] = exp(k_alpha + k_beta*z[i]);
+      h[i] = exp(h_alpha + h_beta*z[i]);
+   }
+
+   Results nodes;
+   MemoryResultSink node_sink(nodes);
+   Engine(xo, yo, k, h, radius, obs, wells, FIT_NORMAL_EQUATIONS, nthreads, node_sink);
+
+   // Project onto the basis.
+   Surrogate surrogate(k_alpha, k_beta, h_alpha, h_beta, degree);
+   const double d0 = nodes.D_ev(n/2, n/2);
+
+   std::vector<double> psi(n*n);
+   for (int i = 0; i < n; ++i)
+      HermiteBasis(z[i], degree, &psi[i*n]);
+
+   for (int i = 0; i < n; ++i) {
+      for (int j = 0; j < n; ++j) {
+         double g[QUANTITIES];
+         Transform(CellAt(nodes, i, j), g);
+         g[DIRECTION] = d0 + std::remainder(g[DIRECTION] - d0, TWO_PI);
+
+         int t = 0;
+         for (int d = 0; d <= degree; ++d) {
+            for (int a = d; a >= 0; --a, ++t) {
+               const double weight = w[i] * w[j] * psi[i*n + a] * psi[j*n + d-a];
+               for (int s = 0; s < QUANTITIES; ++s)
+                  surrogate.coefficients(t,s) += weight * g[s];
+            }
+         }
+      }
+   }
+
+   // Measure the errors at the set points.
+   std::vector<double> k_check = SetPoints(k_alpha, k_beta, n);
+   std::vector<double> h_check = SetPoints(h_alpha, h_beta, n);
+
+   Results check;
+   MemoryResultSink check_sink(check);
+   Engine(xo, yo, k_check, h_check, radius, obs, wells, FIT_NORMAL_EQUATIONS, nthreads, check_sink);
+
+   std::vector<double> sum2(QUANTITIES, 0.0);
+   std::vector<double> largest(QUANTITIES, 0.0);
+   for (int i = 0; i < n; ++i) {
+      for (int j = 0; j < n; ++j) {
+         const CellResult exact = CellAt(check, i, j);
+         const CellResult approx = surrogate(k_check[i], h_check[j]);
+         for (int f = 0; f < QUANTITIES; ++f) {
+            double error = approx.*RESULT_FIELDS[f].value - exact.*RESULT_FIELDS[f].value;
+            if (f == DIRECTION)
+               error = std::remainder(error, TWO_PI);
+            error = std::fabs(RESULT_FIELDS[f].scale * error);
+            sum2[f] += error*error;
+            largest[f] = std::max(largest[f], error);
+         }
+      }
+   }
+   for (int f = 0; f < QUANTITIES; ++f) {
+      surrogate.rms_error[f] = std::sqrt(sum2[f] / (n*n));
+      surrogate.max_error[f] = largest[f];
+   }
+
+   std::cout << "Surrogate of degree " << degree << " with " << surrogate.Terms() << " terms from "
+             << n*n << " fits, checked against " << n*n << " more." << std::endl;
+   return surrogate;
+}
+
+//=============================================================================
+// WriteSurrogate
+//
+//    Write the surrogate as three .csv tables, each after its header line:
+//
+//       k_alpha, k_beta, h_alpha, h_beta, degree
+//
+//       a, b, recharge_ratio, ..., direction_ln_sd    (one line per term)
+//
+//       statistic, rms_error, max_error               (one line per field)
+//
+//    The errors are in the output units; the directions in degrees.
+//=============================================================================
+void WriteSurrogate( std::ostream& out, const Surrogate& surrogate ) {
+   out.precision(17);
+   out << "k_alpha,k_beta,h_alpha,h_beta,degree\n";
+   out << surrogate.k_alpha << ',' << surrogate.k_beta << ',' << surrogate.h_alpha << ','
+       << surrogate.h_beta << ',' << surrogate.degree << '\n';
+
+   out << "a,b";
+   for (int s = 0; s < QUANTITIES; ++s)
+      out << ',' << COEFFICIENT_NAMES[s];
+   out << '\n';
+
+   int t = 0;
+   for (int d = 0; d <= surrogate.degree; ++d) {
+      for (int a = d; a >= 0; --a, ++t) {
+         out << a << ',' << d-a;
+         for (int s = 0; s < QUANTITIES; ++s)
+            out << ',' << surrogate.coefficients(t,s);
+         out << '\n';
+      }
+   }
+
+   out << "statistic,rms_error,max_error\n";
+   for (int f = 0; f < QUANTITIES; ++f)
+      out << RESULT_FIELDS[f].name << ',' << surrogate.rms_error[f] << ',' << surrogate.max_error[f] << '\n';
+}
+
+//=============================================================================
+// ReadSurrogate
+//
+//    Read a surrogate written by WriteSurrogate from "in"; "filename" is
+//    used only in the error messages.
+//=============================================================================
+Surrogate ReadSurrogate( std::istream& in, const std::string& filename ) {
+   int line = 0;
+
+   ExpectHeader(NextLine(in, 5, line, filename), {"k_alpha", "k_beta", "h_alpha", "h_beta", "degree"}, line, filename);
+   std::vector<std::string> fields = NextLine(in, 5, line, filename);
+
+   const double degree = Number(fields[4], line, filename);
+   if (degree != std::floor(degree) || degree < 0 || degree > MAXIMUM_DEGREE) {
+      std::stringstream message;
+      message << "Invalid surrogate degree on line " << line << " of surrogate file " << filename << ".";
+      throw InvalidSurrogateFile(message.str());
+   }
+
+   Surrogate surrogate(Number(fields[0], line, filename), Number(fields[1], line, filename),
+                       Number(fields[2], line, filename), Number(fields[3], line, filename),
+                       static_cast<int>(degree));
+   if (!(surrogate.k_beta > 0) || !(surrogate.h_beta > 0)) {
+      std::stringstream message;
+      message << "Invalid k_beta or h_beta on line " << line << " of surrogate file " << filename << ".";
+      throw InvalidSurrogateFile(message.str());
+   }
+
+   ExpectHeader(NextLine(in, 2 + QUANTITIES, line, filename), CoefficientHeader(), line, filename);
+
+   int t = 0;
+   for (int d = 0; d <= surrogate.degree; ++d) {
+      for (int a = d; a >= 0; --a, ++t) {
+         fields = NextLine(in, 2 + QUANTITIES, line, filename);
+         if (Number(fields[0], line, filename) != a || Number(fields[1], line, filename) != d-a) {
+            std::stringstream message;
+            message << "Expected the term a = " << a << ", b = " << d-a << " on line " << line << " of surrogate file " << filename << ".";
+            throw InvalidSurrogateFile(message.str());
+         }
+         for (int s = 0; s < QUANTITIES; ++s)
+            surrogate.coefficients(t,s) = Number(fields[2+s], line, filename);
+      }
+   }
+
+   ExpectHeader(NextLine(in, 3, line, filename), {"statistic", "rms_error", "max_error"}, line, filename);
+   for (int f = 0; f < QUANTITIES; ++f) {
+      fields = NextLine(in, 3, line, filename);
+      if (fields[0] != RESULT_FIELDS[f].name) {
+         std::stringstream message;
+         message << "Expected the statistic " << RESULT_FIELDS[f].name << " on line " << line << " of surrogate file " << filename << ".";
+         throw InvalidSurrogateFile(message.str());
+      }
+      surrogate.rms_error[f] = Number(fields[1], line, filename);
+      surrogate.max_error[f] = Number(fields[2], line, filename);
+   }
+
+   return surrogate;
+}
+
+//-----------------------------------------------------------------------------
+Surrogate ReadSurrogate( const std::string& filename ) {
+   std::ifstream in( filename );
+   if ( in.fail() ) {
+      std::stringstream message;
+      message << "Could not open <" << filename << "> for input.";
+      throw InvalidSurrogateFile(message.str());
+   }
+   return ReadSurrogate( in, filename );
+}
@@ -0,0 +1,91 @@
+//=============================================================================
+// surrogate.h
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#ifndef SURROGATE_H
+#define SURROGATE_H
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "matrix.h"
+#include "obs_table.h"
+#include "read_data.h"
+#include "result_sink.h"
+
+//-----------------------------------------------------------------------------
+class InvalidSurrogateFile : public std::runtime_error {
+   public :
+      InvalidSurrogateFile( const std::string& message ) : std::runtime_error(message) {
+      }
+};
+
+//=============================================================================
+// Surrogate
+//
+//    A Hermite polynomial chaos expansion of the recharge, magnitude, and
+//    direction, and their standard deviations, over the standardized
+//    log-conductivity and log-thickness,
+//
+//       xi  = (ln k - k_alpha) / k_beta,
+//       eta = (ln h - h_alpha) / h_beta,
+//
+//    with every term psi_a(xi) psi_b(eta) of total degree a + b <= degree,
+//    where psi_n is the orthonormal probabilists' Hermite polynomial.
+//
+//    The expanded quantities are, in the order of RESULT_FIELDS, the
+//    recharge and magnitude as multiples of their standard deviations, the
+//    direction [rad], and the logarithms of the three standard deviations.
+//
+//    rms_error and max_error hold the errors of the surrogate against the
+//    Engine at an independent set of (k,h) cells, for each RESULT_FIELDS
+//    statistic, in the output units.
+//=============================================================================
+class Surrogate {
+   public:
+      double k_alpha;
+      double k_beta;
+      double h_alpha;
+      double h_beta;
+      int    degree;
+
+      Matrix coefficients;             // (Terms() x RESULT_FIELD_COUNT)
+
+      std::vector<double> rms_error;
+      std::vector<double> max_error;
+
+      Surrogate();
+      Surrogate( double k_alpha, double k_beta, double h_alpha, double h_beta, int degree );
+
+      int Terms() const;
+      CellResult operator()( double k, double h ) const;
+};
+
+//=============================================================================
+Surrogate FitSurrogate(
+   double xo, double yo,
+   double k_alpha, double k_beta,
+   double h_alpha, double h_beta,
+   int degree,
+   double radius,
+   const ObsTable& obs,
+   const std::vector<WellRecord>& wells,
+   int nthreads
+);
+
+void WriteSurrogate( std::ostream& out, const Surrogate& surrogate );
+
+Surrogate ReadSurrogate( std::istream& in, const std::string& filename );
+Surrogate ReadSurrogate( const std::string& filename );
+
+//=============================================================================
+#endif  // SURROGATE_H
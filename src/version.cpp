@@ -79,6 +79,256 @@ void Help() {
       "\n"
    << std::endl;
 
+   std::cout <<
+      "Options: \n"
+      "   --stream        Read the observation file a chunk at a time and fold each \n"
+      "                   chunk directly into the normal equations for every (k,h) \n"
+      "                   pair. The memory required is proportional to the number \n"
+      "                   of (k,h) pairs, not to the number of observations. \n"
+      "\n"
+      "   --chunk=<n>     The number of observations per chunk in the --stream mode. \n"
+      "                   The default is 65536. \n"
+      "\n"
+      "   --format=<f>    The output format: csv (the default) for the six .csv \n"
+      "                   files described below, or npz for one binary NumPy \n"
+      "                   archive, <out fileroot>.npz, holding the arrays k, h, \n"
+      "                   recharge_ev, recharge_sd, magnitude_ev, magnitude_sd, \n"
+      "                   direction_ev, and direction_sd. \n"
+      "\n"
+      "   --precision=<n> The number of significant digits in the .csv files, from \n"
+      "                   1 to 17. The default, 0, writes each value with the fewest \n"
+      "                   digits that read back as exactly the same double. \n"
+      "\n"
+      "   --fit           Also write the goodness of fit of the model for every \n"
+      "                   (k,h) pair: the weighted residual sum of squares \n"
+      "                   (wrss), the reduced chi-square, wrss/(M-p) for M active \n"
+      "                   observations and p model terms (reduced_chisq), and the \n"
+      "                   Gaussian log-likelihood of the observed heads (loglik), \n"
+      "                   as three more .csv files, or npz arrays, with \n"
+      "                   the same layout and names as the others. Not available \n"
+      "                   with --factors, --search, --nearest, or --origins. \n"
+      "\n"
+      "   --threads=<n>   The maximum number of threads. The default, 0, uses every \n"
+      "                   hardware thread. \n"
+      "\n"
+      "   --qr            Fit the model by a parallel QR factorization of the \n"
+      "                   weighted observations, rather than by solving the normal \n"
+      "                   equations. Slower, but more accurate when the \n"
+      "                   observations are poorly spread about the origin. Not \n"
+      "                   available with --stream, --search, --nearest, or \n"
+      "                   --origins. \n"
+      "\n"
+      "   --order=<n>     The order of the polynomial discharge potential model: \n"
+      "                   1 (linear, 3 terms), 2 (quadratic, 6 terms; the \n"
+      "                   default), or 3 (cubic, 10 terms). The linear model has \n"
+      "                   no curvature, and so reports zero recharge. Orders 1 \n"
+      "                   and 3 are available only for the basic fit: not with \n"
+      "                   --stream, --qr, --factors, --scenario, --snapshots, \n"
+      "                   --search, --nearest, --origins, --loo, --bootstrap, or \n"
+      "                   --design. \n"
+      "\n"
+      "   --quadrature    Place the <k_count> conductivities and <h_count> \n"
+      "                   thicknesses at the Gauss-Hermite nodes of their \n"
+      "                   lognormal distributions, rather than at the centers of \n"
+      "                   equal probability intervals, and also write \n"
+      "                   <out fileroot>_quadrature.csv: for the recharge, \n"
+      "                   magnitude, and direction [deg], the mean and the total \n"
+      "                   standard deviation integrated over both distributions, \n"
+      "                   with the within-cell and between-cell parts of the \n"
+      "                   total. A few nodes integrate as accurately as a much \n"
+      "                   finer grid of set points. Not available with --stream, \n"
+      "                   --order, --factors, --scenario, --snapshots, --search, \n"
+      "                   --nearest, --origins, --loo, --nested, --bootstrap, or \n"
+      "                   --design. \n"
+      "\n"
+      "   --adaptive=<t>  Fit only enough of the (k,h) cells to interpolate the \n"
+      "                   rest, and also write <out fileroot>_adaptive.csv: the \n"
+      "                   fitted cells. Starting from a --coarse lattice, each \n"
+      "                   rectangle of fitted cells is split until the bilinear \n"
+      "                   interpolation, in ln k and ln h, of its corners matches \n"
+      "                   the fits at its edge midpoints and center to within <t> \n"
+      "                   standard deviations. Only those test points are \n"
+      "                   checked; the other interpolated cells may miss their \n"
+      "                   fits by somewhat more than <t>. The usual output files \n"
+      "                   hold the full grid, fitted and interpolated. <t> = 0 \n"
+      "                   fits every cell. Not available with --stream, --qr, \n"
+      "                   --order, --factors, --scenario, --snapshots, \n"
+      "                   --quadrature, --search, --nearest, or --origins. \n"
+      "\n"
+      "   --coarse=<n>    The number of set points along each axis of the \n"
+      "                   starting lattice for --adaptive. The default is 5. \n"
+      "\n"
+      "   --aggregate[=<tol>] \n"
+      "                   Combine co-located observations into one record before \n"
+      "                   the fit, weighting the heads by their inverse variances. \n"
+      "                   Observations are co-located when they fall in the same \n"
+      "                   <tol> x <tol> square; the default, 0, requires identical \n"
+      "                   coordinates. Not available with --stream or --factors. \n"
+      "\n"
+      "   --thin=<cell>   Thin a dense observation set by combining all of the \n"
+      "                   observations in each <cell> x <cell> square, in the same \n"
+      "                   way as --aggregate. The number of remaining observations, \n"
+      "                   their effective number, and the relative change in the \n"
+      "                   model parameter covariance at the median (k,h), with an \n"
+      "                   upper bound, are reported. Not available with --stream \n"
+      "                   or --factors. \n"
+      "\n"
+      "   --factors=<file> \n"
+      "                   Add errors shared between observations, such as a common \n"
+      "                   survey datum or sampling campaign, to the independent \n"
+      "                   observation errors. Each line of <file> has three fields, \n"
+      "                   <obs ID>, <factor ID>, and <head sd> [L]: the observation \n"
+      "                   shares an error with standard deviation <head sd> with \n"
+      "                   every other observation on the same factor. An observation \n"
+      "                   may appear on several factors, but each <obs ID> must be \n"
+      "                   unique in <obs file>. Not available with --stream, --qr, \n"
+      "                   --search, --nearest, --origins, --aggregate, --thin, \n"
+      "                   --loo, --nested, --bootstrap, or --design. \n"
+      "\n"
+      "   --scenario=<file> \n"
+      "                   Also evaluate the pumping scenario with the wells in \n"
+      "                   <file>, in the same format as <well file>. May be given \n"
+      "                   more than once. Every scenario shares one factorization \n"
+      "                   per (k,h) pair with the base scenario, <well file>, and \n"
+      "                   the results for each are written with the file root \n"
+      "                   <out fileroot>_<name>, where <name> is the scenario's \n"
+      "                   file name without its directory or extension. The buffer \n"
+      "                   radius is applied with the wells of all of the scenarios. \n"
+      "                   Not available with --stream, --qr, --factors, --search, \n"
+      "                   --nearest, or --origins. \n"
+      "\n"
+      "   --snapshots     Each line of <obs file> has a leading sixth field, \n"
+      "                   <snapshot ID>, naming the date or survey of the \n"
+      "                   observation: <snapshot ID>, <obs ID>, <x>, <y>, \n"
+      "                   <head ev>, and <head sd>. Every snapshot is analyzed, \n"
+      "                   and its results are written with the file root \n"
+      "                   <out fileroot>_<snapshot ID>. Snapshots observed at the \n"
+      "                   same locations, in the same order, share one \n"
+      "                   factorization per (k,h) pair whenever their weights \n"
+      "                   coincide. Only the .csv format is supported. Not \n"
+      "                   available with --stream, --qr, --factors, --scenario, \n"
+      "                   --search, --nearest, --origins, --aggregate, --thin, \n"
+      "                   --loo, --bootstrap, or --design. \n"
+      "\n"
+      "   --search=<r>    Fit the model using only the observations within distance \n"
+      "                   <r> of the origin. \n"
+      "\n"
+      "   --nearest=<n>   Fit the model using only the <n> observations nearest to \n"
+      "                   the origin (and within --search=<r>, if given). <n> \n"
+      "                   must be at least 10, the fewest unique locations the \n"
+      "                   model is fit to. \n"
+      "\n"
+      "   --origins=<file> \n"
+      "                   Repeat the analysis at every origin in <file>, in place \n"
+      "                   of <xo> and <yo>. Each line of the file has three fields, \n"
+      "                   <ID>, <x>, and <y>, with the same conventions as the well \n"
+      "                   file. The results for each origin are written with the \n"
+      "                   file root <out fileroot>_<ID>. Origins listed in spatial \n"
+      "                   order are processed fastest, since the search windows of \n"
+      "                   neighboring origins are updated rather than rebuilt. \n"
+      "                   --search, --nearest, and --origins are not available with \n"
+      "                   --stream. \n"
+      "\n"
+      "   --loo           Also write <out fileroot>_loo.csv: for every (k,h) pair \n"
+      "                   and every active observation, the leverage, the residual, \n"
+      "                   the leave-one-out residual and its standardized value \n"
+      "                   (the boomerang statistic), all in discharge potential \n"
+      "                   units, and the changes in the expected recharge, \n"
+      "                   magnitude, and direction [deg] when the observation is \n"
+      "                   left out. Not available with --stream, --search, \n"
+      "                   --nearest, or --origins. \n"
+      "\n"
+      "   --nested        Also write <out fileroot>_nested.csv: for every (k,h) \n"
+      "                   pair, the linear, quadratic, and cubic models, each with \n"
+      "                   its weighted residual sum of squares, AIC, and BIC, and \n"
+      "                   its recharge, magnitude, and direction [deg]. All three \n"
+      "                   models come from one factorization. Not available with \n"
+      "                   --stream, --search, --nearest, or --origins. \n"
+      "\n"
+      "   --bootstrap=<n> Also write <out fileroot>_bootstrap.csv: for every (k,h) \n"
+      "                   pair, the mean, standard deviation, and 2.5 and 97.5 \n"
+      "                   percentiles of the recharge, magnitude, and direction \n"
+      "                   [deg] over <n> bootstrap resamples of the active \n"
+      "                   observations. Not available with --stream, --search, \n"
+      "                   --nearest, or --origins. \n"
+      "\n"
+      "   --seed=<s>      The random number stream for --bootstrap and --qmc. The \n"
+      "                   default is 1; the same seed always gives the same \n"
+      "                   results. \n"
+      "\n"
+      "   --qmc=<n>       Write <out fileroot>_qmc.csv and \n"
+      "                   <out fileroot>_qmc_summary.csv in place of the (k,h) \n"
+      "                   grid, which is not computed: up to <n> randomized \n"
+      "                   quasi-Monte Carlo samples of the conductivity and \n"
+      "                   thickness, and optionally of the well discharges and \n"
+      "                   buffer radius, with the recharge, magnitude, and \n"
+      "                   direction [deg] of each; and the mean, its standard \n"
+      "                   error, and the total standard deviation of each over \n"
+      "                   the samples. Sampling stops early once every standard \n"
+      "                   error is below --target. Not available with --stream, \n"
+      "                   --qr, --order, --quadrature, --adaptive, --fit, \n"
+      "                   --format, --factors, --scenario, --snapshots, \n"
+      "                   --search, --nearest, or --origins. \n"
+      "\n"
+      "   --target=<t>    The --qmc stopping rule: the largest standard error of \n"
+      "                   a mean, as a fraction of its standard deviation. The \n"
+      "                   default is 0.01. \n"
+      "\n"
+      "   --qsd=<f>       The relative standard deviation of the well discharges \n"
+      "                   with --qmc. The default is 0, fixed discharges. \n"
+      "\n"
+      "   --rsd=<f>       The log-standard deviation of the well buffer radius \n"
+      "                   with --qmc. The default is 0, a fixed radius. \n"
+      "\n"
+      "   --surrogate=<n> Write <out fileroot>_surrogate.csv in place of the \n"
+      "                   (k,h) grid, which is not computed: a Hermite \n"
+      "                   polynomial chaos surrogate of total degree <n> in \n"
+      "                   ln k and ln h for the recharge, magnitude, and \n"
+      "                   direction and their standard deviations, fit from \n"
+      "                   (<n>+1)^2 cells at the Gauss-Hermite nodes, with its \n"
+      "                   root mean square and largest errors at (<n>+1)^2 \n"
+      "                   set points. See --evaluate. Not available with \n"
+      "                   --stream, --qr, --order, --quadrature, --adaptive, \n"
+      "                   --fit, --format, --qmc, --factors, --scenario, \n"
+      "                   --snapshots, --search, --nearest, or --origins. \n"
+      "\n"
+      "   --design=<file> Also write <out fileroot>_design.csv and \n"
+      "                   <out fileroot>_retire.csv. Each line of <file> is a \n"
+      "                   candidate new observation site with four fields, <ID>, \n"
+      "                   <x>, <y>, and <head sd> [L], with the same conventions \n"
+      "                   as the observation file. For every (k,h) pair, the \n"
+      "                   candidates that most reduce the standard deviations of \n"
+      "                   the recharge, magnitude, and direction are selected one \n"
+      "                   at a time, and the active observations are ranked from \n"
+      "                   the least to the most loss if each were retired alone. \n"
+      "                   Not available with --stream, --search, --nearest, or \n"
+      "                   --origins. \n"
+      "\n"
+      "   --select=<n>    The number of candidate sites to select with --design. \n"
+      "                   The default is 10. \n"
+   << std::endl;
+
+   std::cout <<
+      "Surrogate Evaluation: \n"
+      "   Gimiwan --evaluate <surrogate filename> <k> <h> \n"
+      "\n"
+      "   Evaluates a surrogate written by --surrogate at the conductivity <k> \n"
+      "   and thickness <h>, without refitting the model. Writes one .csv line \n"
+      "   for each of the recharge, magnitude, and direction [deg] and their \n"
+      "   standard deviations: the value, and the surrogate's root mean square \n"
+      "   and largest errors. \n"
+   << std::endl;
+
+   std::cout <<
+      "Binary Conversion: \n"
+      "   Gimiwan --convert <obs|wells> <csv filename> <binary filename> \n"
+      "\n"
+      "   Reads an observation (obs) or well (wells) .csv file and writes the same \n"
+      "   records in a compact binary columnar format. A binary file may be given \n"
+      "   in place of the corresponding .csv file in any later run; it is loaded \n"
+      "   by memory mapping, without any parsing. \n"
+   << std::endl;
+
    std::cout <<
       "Example: \n"
       "   Gimiwan 100 200 2.2 0.2 10  2.3 0.10 10 100 obs.csv wells.csv results \n"
@@ -194,7 +444,9 @@ void Help() {
 void Usage() {
    std::cout <<
       "Usage: \n"
-      "   Gimiwan <xo> <yo> <k alpha> <k beta> <k count> <h alpha> <h beta> <h count> <radius> <obs filename> <wells filename> <out fileroot> \n"
+      "   Gimiwan <xo> <yo> <k alpha> <k beta> <k count> <h alpha> <h beta> <h count> <radius> <obs filename> <wells filename> <out fileroot> [options] \n"
+      "   Gimiwan --convert <obs|wells> <csv filename> <binary filename> \n"
+      "   Gimiwan --evaluate <surrogate filename> <k> <h> \n"
       "   Gimiwan --help \n"
       "   Gimiwan --version \n"
    << std::endl;
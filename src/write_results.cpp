@@ -6,86 +6,416 @@
 //    Department of Civil, Environmental, and Geo- Engineering
 //    University of Minnesota
 //
+// notes:
+// o  The .csv files are formatted with std::to_chars. By default each value
+//    is written with the fewest digits that read back to exactly the same
+//    double. The rows are rendered in parallel, in blocks, and the files
+//    are written concurrently, one write per block.
+//
+// o  The .npz archive is an uncompressed ("stored") ZIP file of NumPy .npy
+//    arrays, so it can be read directly with numpy.load. It is assembled
+//    in memory and written with one call. See
+//
+//       https://numpy.org/doc/stable/reference/generated/numpy.lib.format.html
+//       https://pkware.cachefly.net/webdocs/casestudies/APPNOTE.TXT
+//
 // version:
 //    30 June 2017
 //=============================================================================
 #include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
-#include <iomanip>
 #include <sstream>
+#include <utility>
 
-#include "engine.h"
-#include "matrix.h"
-#include "numerical_constants.h"
+#include "parallel_for-inl.h"
 #include "write_results.h"
 
 //-----------------------------------------------------------------------------
 namespace {
 
    //--------------------------------------------------------------------------
-   void write_result_matrix( const std::string& outfilename,
-      std::vector<double> k, std::vector<double> h, Matrix V)
+   // The number of .csv rows rendered as one unit of parallel work.
+   //--------------------------------------------------------------------------
+   const int ROWS_PER_BLOCK = 64;
+
+   //--------------------------------------------------------------------------
+   // Append the text form of x. With precision = 0 this is the shortest
+   // string that reads back to exactly the same double; otherwise it is
+   // the %g-style form with the given number of significant digits.
+   //--------------------------------------------------------------------------
+   void AppendDouble( std::string& text, double x, int precision ) {
+      char buffer[32];
+      std::to_chars_result result = (precision > 0)
+         ? std::to_chars(buffer, buffer + sizeof(buffer), x, std::chars_format::general, precision)
+         : std::to_chars(buffer, buffer + sizeof(buffer), x);
+      text.append(buffer, result.ptr);
+   }
+
+   //--------------------------------------------------------------------------
+   // Render the header row: the h values, preceded by an empty cell.
+   //--------------------------------------------------------------------------
+   std::string RenderHeader( const std::vector<double>& h, int precision ) {
+      std::string text;
+      text.reserve( 25*(h.size() + 1) );
+
+      for (double hj : h) {
+         text.push_back(',');
+         AppendDouble(text, hj, precision);
+      }
+      text.push_back('\n');
+      return text;
+   }
+
+   //--------------------------------------------------------------------------
+   // Render the buffered rows of one field: each row is the k value followed
+   // by the scaled values of that field.
+   //--------------------------------------------------------------------------
+   std::string RenderRows( const std::vector<double>& k,
+      const std::vector<std::pair<int, std::vector<CellResult>>>& rows,
+      const ResultField& field, int precision )
    {
-      std::ofstream outfile( outfilename );
+      std::string text;
+      if (!rows.empty())
+         text.reserve( 25*rows.size()*(rows[0].second.size() + 1) );
+
+      for (const auto& row : rows) {
+         AppendDouble(text, k[row.first], precision);
+         for (const CellResult& cell : row.second) {
+            text.push_back(',');
+            AppendDouble(text, field.scale * (cell.*field.value), precision);
+         }
+         text.push_back('\n');
+      }
+      return text;
+   }
+
+   //--------------------------------------------------------------------------
+   void CheckStream( const std::ostream& outfile, const std::string& outfilename ) {
       if ( outfile.fail() ) {
          std::stringstream message;
-         message << "Could not open <" << outfilename << "> for output.";
+         message << "Writing <" << outfilename << "> failed.";
          throw InvalidOutputFile(message.str());
       }
+   }
+}
 
-      outfile << std::setprecision(std::numeric_limits<long double>::digits10 + 1);
+//-----------------------------------------------------------------------------
+namespace {
 
-      int k_count = k.size();
-      int h_count = h.size();
+   //--------------------------------------------------------------------------
+   // The standard (IEEE 802.3) CRC-32 required by the ZIP format. The CRC of
+   // a concatenation is computed by passing the CRC of the first part as
+   // "crc" when processing the second; start from zero.
+   //--------------------------------------------------------------------------
+   uint32_t Crc32( uint32_t crc, const char* data, std::size_t n ) {
+      // Built once, thread-safely, on first use.
+      static const std::array<uint32_t, 256> table = []() {
+         std::array<uint32_t, 256> t;
+         for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int b = 0; b < 8; ++b)
+               c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : (c >> 1);
+            t[i] = c;
+         }
+         return t;
+      }();
 
-      for (int j = 0; j < h_count; ++j) {
-         outfile << ',' << h[j];
+      crc ^= 0xFFFFFFFFu;
+      for (std::size_t i = 0; i < n; ++i)
+         crc = table[(crc ^ static_cast<unsigned char>(data[i])) & 0xFF] ^ (crc >> 8);
+      return crc ^ 0xFFFFFFFFu;
+   }
+
+   //--------------------------------------------------------------------------
+   void Put16( std::vector<char>& buffer, uint32_t v ) {
+      buffer.push_back( static_cast<char>(v & 0xFF) );
+      buffer.push_back( static_cast<char>((v >> 8) & 0xFF) );
+   }
+
+   void Put32( std::vector<char>& buffer, uint32_t v ) {
+      Put16(buffer, v & 0xFFFF);
+      Put16(buffer, v >> 16);
+   }
+
+   //--------------------------------------------------------------------------
+   // Append n scaled doubles in little-endian order.
+   //--------------------------------------------------------------------------
+   void PutDoubles( std::vector<char>& buffer, const double* data, std::size_t n, double scale ) {
+      for (std::size_t i = 0; i < n; ++i) {
+         uint64_t v;
+         double x = scale * data[i];
+         memcpy(&v, &x, sizeof(v));
+         Put32(buffer, static_cast<uint32_t>(v & 0xFFFFFFFFu));
+         Put32(buffer, static_cast<uint32_t>(v >> 32));
       }
-      outfile << std::endl;
+   }
 
-      for (int i = 0; i < k_count; ++i ) {
-         outfile << k[i];
-         for (int j = 0; j < h_count; ++j) {
-            outfile << ',' << V(i,j);
-         }
-         outfile << std::endl;
+   //--------------------------------------------------------------------------
+   // Build a version 1.0 .npy header for a C-ordered array of little-endian
+   // doubles with the given shape (one or two dimensions).
+   //--------------------------------------------------------------------------
+   std::vector<char> NpyHeader( const std::vector<int>& shape ) {
+      std::stringstream header;
+      header << "{'descr': '<f8', 'fortran_order': False, 'shape': (";
+      for (int d : shape)
+         header << d << ", ";
+      header << "), }";
+
+      // The magic string, version, and header length take ten bytes; the
+      // header is padded with spaces so the data start on a 64-byte boundary.
+      std::string text = header.str();
+      text.append( 63 - (10 + text.size()) % 64, ' ' );
+      text.push_back('\n');
+
+      std::string image("\x93NUMPY\x01\x00", 8);
+      image.push_back( static_cast<char>(text.size() & 0xFF) );
+      image.push_back( static_cast<char>((text.size() >> 8) & 0xFF) );
+      image += text;
+      return std::vector<char>(image.begin(), image.end());
+   }
+
+   //--------------------------------------------------------------------------
+   // Build a complete .npy image.
+   //--------------------------------------------------------------------------
+   std::vector<char> NpyArray( const std::vector<int>& shape, const double* data, double scale ) {
+      std::size_t count = 1;
+      for (int d : shape)
+         count *= d;
+
+      std::vector<char> npy = NpyHeader(shape);
+      npy.reserve(npy.size() + 8*count);
+      PutDoubles(npy, data, count, scale);
+      return npy;
+   }
+
+   //--------------------------------------------------------------------------
+   // The ZIP records for a stored (uncompressed) member: the local file
+   // header that precedes the data, and the central directory entry.
+   //--------------------------------------------------------------------------
+   void PutLocalHeader( std::vector<char>& buffer, const std::string& name, uint32_t crc, uint32_t size ) {
+      Put32(buffer, 0x04034b50);       // signature
+      Put16(buffer, 20);               // version needed to extract
+      Put16(buffer, 0);                // flags
+      Put16(buffer, 0);                // method: stored
+      Put16(buffer, 0);                // modification time
+      Put16(buffer, 0x21);             // modification date: 1 Jan 1980
+      Put32(buffer, crc);
+      Put32(buffer, size);             // compressed size
+      Put32(buffer, size);             // uncompressed size
+      Put16(buffer, static_cast<uint32_t>(name.size()));
+      Put16(buffer, 0);                // extra field length
+      buffer.insert(buffer.end(), name.begin(), name.end());
+   }
+
+   void PutDirectoryEntry( std::vector<char>& directory, const std::string& name,
+      uint32_t crc, uint32_t size, uint32_t offset )
+   {
+      Put32(directory, 0x02014b50);    // signature
+      Put16(directory, 20);            // version made by
+      Put16(directory, 20);            // version needed to extract
+      Put16(directory, 0);             // flags
+      Put16(directory, 0);             // method: stored
+      Put16(directory, 0);             // modification time
+      Put16(directory, 0x21);          // modification date
+      Put32(directory, crc);
+      Put32(directory, size);
+      Put32(directory, size);
+      Put16(directory, static_cast<uint32_t>(name.size()));
+      Put16(directory, 0);             // extra field length
+      Put16(directory, 0);             // comment length
+      Put16(directory, 0);             // disk number
+      Put16(directory, 0);             // internal attributes
+      Put32(directory, 0);             // external attributes
+      Put32(directory, offset);
+      directory.insert(directory.end(), name.begin(), name.end());
+   }
+
+   void PutEndOfDirectory( std::vector<char>& buffer, int nmembers, uint32_t size, uint32_t offset ) {
+      Put32(buffer, 0x06054b50);       // signature
+      Put16(buffer, 0);                // this disk
+      Put16(buffer, 0);                // disk with the central directory
+      Put16(buffer, nmembers);
+      Put16(buffer, nmembers);
+      Put32(buffer, size);
+      Put32(buffer, offset);
+      Put16(buffer, 0);                // comment length
+   }
+
+   //--------------------------------------------------------------------------
+   // Append one complete stored member to an archive image, and its entry
+   // to the central directory image.
+   //--------------------------------------------------------------------------
+   void AppendZipMember( std::vector<char>& archive, std::vector<char>& directory,
+      const std::string& name, const std::vector<char>& data )
+   {
+      const uint32_t crc    = Crc32(0, data.data(), data.size());
+      const uint32_t size   = static_cast<uint32_t>(data.size());
+      const uint32_t offset = static_cast<uint32_t>(archive.size());
+
+      PutLocalHeader(archive, name, crc, size);
+      archive.insert(archive.end(), data.begin(), data.end());
+      PutDirectoryEntry(directory, name, crc, size, offset);
+   }
+}
+
+//=============================================================================
+// CsvResultSink
+//
+//    The files are opened, and the header rows written, by Begin. The rows
+//    are buffered as they arrive; every ROWS_PER_BLOCK rows, and at End, the
+//    buffered rows of all of the files are rendered in parallel, and the
+//    files are then written concurrently, one write each. There is one file
+//    for each of the six statistics, and, if "fit" is true, one for each
+//    goodness of fit measure.
+//=============================================================================
+CsvResultSink::CsvResultSink( const std::string& outfileroot, int precision, bool fit, int nthreads )
+:  m_Root( outfileroot ),
+   m_Precision( precision ),
+   m_Threads( nthreads ),
+   m_Fields( OutputFields(fit) ),
+   m_k(),
+   m_Rows(),
+   m_Files(),
+   m_Filenames() {
+}
+
+//-----------------------------------------------------------------------------
+void CsvResultSink::Begin( const std::vector<double>& k, const std::vector<double>& h ) {
+   m_k = k;
+   const std::string header = RenderHeader(h, m_Precision);
+
+   for (size_t f = 0; f < m_Fields.size(); ++f) {
+      m_Filenames.push_back( m_Root + "_" + m_Fields[f].name + ".csv" );
+      m_Files.emplace_back( m_Filenames[f] );
+      if ( m_Files[f].fail() ) {
+         std::stringstream message;
+         message << "Could not open <" << m_Filenames[f] << "> for output.";
+         throw InvalidOutputFile(message.str());
       }
+      m_Files[f].write( header.data(), header.size() );
+   }
+   m_Rows.reserve(ROWS_PER_BLOCK);
+}
 
-      outfile.close();
+//-----------------------------------------------------------------------------
+void CsvResultSink::Row( int i, const std::vector<CellResult>& row ) {
+   m_Rows.emplace_back(i, row);
+   if (static_cast<int>(m_Rows.size()) == ROWS_PER_BLOCK)
+      Flush();
+}
+
+//-----------------------------------------------------------------------------
+void CsvResultSink::End() {
+   Flush();
+   for (size_t f = 0; f < m_Files.size(); ++f) {
+      m_Files[f].close();
+      CheckStream( m_Files[f], m_Filenames[f] );
    }
 }
 
 //-----------------------------------------------------------------------------
-void write_results( const std::string& outfileroot, Results results ) {
-   std::string outfilename;
+// Render the buffered rows of every file in parallel, and then write the
+// files concurrently.
+//-----------------------------------------------------------------------------
+void CsvResultSink::Flush() {
+   if (m_Rows.empty())
+      return;
+
+   const int nfields = m_Fields.size();
+   std::vector<std::string> text(nfields);
+
+   ParallelFor(0, nfields, m_Threads, [&](int f) {
+      text[f] = RenderRows(m_k, m_Rows, m_Fields[f], m_Precision);
+   });
+
+   ParallelFor(0, nfields, nfields, [&](int f) {
+      m_Files[f].write( text[f].data(), text[f].size() );
+      CheckStream( m_Files[f], m_Filenames[f] );
+   });
+
+   m_Rows.clear();
+}
+
+//=============================================================================
+// NpzResultSink
+//
+//    Begin opens the file, so that an error is reported before any
+//    computation is done. The scaled values of each member are collected
+//    as the rows arrive, and End assembles the whole archive in memory and
+//    writes it with one call. The members are named k, h, and the names of
+//    the output fields; the directions are in degrees, as in the .csv
+//    files.
+//=============================================================================
+NpzResultSink::NpzResultSink( const std::string& outfileroot, bool fit )
+:  m_Filename( outfileroot + ".npz" ),
+   m_Fields( OutputFields(fit) ),
+   m_File(),
+   m_k(),
+   m_h(),
+   m_Values() {
+}
+
+//-----------------------------------------------------------------------------
+void NpzResultSink::Begin( const std::vector<double>& k, const std::vector<double>& h ) {
+   m_k = k;
+   m_h = h;
+   const std::size_t cells = k.size() * h.size();
 
-   // Write out the recharge expected value.
-   outfilename = outfileroot + "_recharge_ev.csv";
-   write_result_matrix(outfilename, results.k, results.h, results.R_ev);
+   // The plain ZIP format is limited to 4 GiB.
+   const uint64_t total = (k.size() + h.size() + uint64_t(m_Fields.size())*cells)*sizeof(double) + 8*1024;
+   if (total > 0xFFFFFFFFu) {
+      std::stringstream message;
+      message << "The results are too large for <" << m_Filename << ">.";
+      throw InvalidOutputFile(message.str());
+   }
 
-   // Write out the recharge standard deviation.
-   outfilename = outfileroot + "_recharge_sd.csv";
-   write_result_matrix(outfilename, results.k, results.h, results.R_sd);
+   m_File.open( m_Filename, std::ios::binary );
+   if ( m_File.fail() ) {
+      std::stringstream message;
+      message << "Could not open <" << m_Filename << "> for output.";
+      throw InvalidOutputFile(message.str());
+   }
 
-   // Write out the magnitude expected value.
-   outfilename = outfileroot + "_magnitude_ev.csv";
-   write_result_matrix(outfilename, results.k, results.h, results.M_ev);
+   m_Values.assign( m_Fields.size(), std::vector<double>(cells) );
+}
+
+//-----------------------------------------------------------------------------
+void NpzResultSink::Row( int i, const std::vector<CellResult>& row ) {
+   const std::size_t h_count = m_h.size();
+   for (size_t f = 0; f < m_Fields.size(); ++f) {
+      double* values = &m_Values[f][i*h_count];
+      for (size_t j = 0; j < h_count; ++j)
+         values[j] = row[j].*m_Fields[f].value;
+   }
+}
+
+//-----------------------------------------------------------------------------
+void NpzResultSink::End() {
+   const int k_count = m_k.size();
+   const int h_count = m_h.size();
 
-   // Write out the magnitude standard deviation.
-   outfilename = outfileroot + "_magnitude_sd.csv";
-   write_result_matrix(outfilename, results.k, results.h, results.M_sd);
+   std::vector<char> archive;
+   std::vector<char> directory;
+   archive.reserve( (k_count + h_count + m_Fields.size()*k_count*h_count)*sizeof(double) + 8*1024 );
 
-   // Write out the direction expected value.
-   Matrix D_ev_deg;
-   Multiply_aM(RAD_TO_DEG, results.D_ev, D_ev_deg);
+   AppendZipMember(archive, directory, "k.npy", NpyArray({k_count}, m_k.data(), 1.0));
+   AppendZipMember(archive, directory, "h.npy", NpyArray({h_count}, m_h.data(), 1.0));
+   for (size_t f = 0; f < m_Fields.size(); ++f)
+      AppendZipMember(archive, directory, std::string(m_Fields[f].name) + ".npy",
+         NpyArray({k_count, h_count}, m_Values[f].data(), m_Fields[f].scale));
 
-   outfilename = outfileroot + "_direction_ev.csv";
-   write_result_matrix(outfilename, results.k, results.h, D_ev_deg);
+   const int nmembers = 2 + m_Fields.size();
+   const uint32_t directory_offset = static_cast<uint32_t>(archive.size());
+   const uint32_t directory_size   = static_cast<uint32_t>(directory.size());
+   PutEndOfDirectory(directory, nmembers, directory_size, directory_offset);
 
-   // Write out the direction standard deviation.
-   Matrix D_sd_deg;
-   Multiply_aM(RAD_TO_DEG, results.D_sd, D_sd_deg);
+   archive.insert(archive.end(), directory.begin(), directory.end());
 
-   outfilename = outfileroot + "_direction_sd.csv";
-   write_result_matrix(outfilename, results.k, results.h, D_sd_deg);
+   m_File.write( archive.data(), archive.size() );
+   m_File.close();
+   CheckStream( m_File, m_Filename );
 }
@@ -12,11 +12,15 @@
 #ifndef WRITE_RESULTS_H
 #define WRITE_RESULTS_H
 
+#include <cstdint>
+#include <fstream>
 #include <stdexcept>
 #include <string>
-#include <tuple>
+#include <utility>
 #include <vector>
 
+#include "result_sink.h"
+
 //-----------------------------------------------------------------------------
 class InvalidOutputFile : public std::runtime_error {
    public :
@@ -25,8 +29,52 @@ class InvalidOutputFile : public std::runtime_error {
 };
 
 //-----------------------------------------------------------------------------
-void write_results( const std::string& outfilename, Results results );
+// Write the rows to the files <outfileroot>_<name>.csv, one for each of
+// OutputFields(fit), a block of rows at a time. Each block is rendered on up
+// to "nthreads" threads; see ThreadCount.
+//-----------------------------------------------------------------------------
+class CsvResultSink : public ResultSink {
+   public:
+      CsvResultSink( const std::string& outfileroot, int precision, bool fit, int nthreads );
+
+      void Begin( const std::vector<double>& k, const std::vector<double>& h );
+      void Row( int i, const std::vector<CellResult>& row );
+      void End();
+
+   private:
+      void Flush();
+
+      std::string                m_Root;
+      int                        m_Precision;
+      int                        m_Threads;
+      std::vector<ResultField>   m_Fields;
+      std::vector<double>        m_k;
+      std::vector<std::pair<int, std::vector<CellResult>>> m_Rows;   // not yet written
+      std::vector<std::ofstream> m_Files;
+      std::vector<std::string>   m_Filenames;
+};
 
+//-----------------------------------------------------------------------------
+// Write the results into the single file <outfileroot>.npz: the k and h
+// axes, and one member for each of OutputFields(fit). The archive is
+// written once, by End.
+//-----------------------------------------------------------------------------
+class NpzResultSink : public ResultSink {
+   public:
+      NpzResultSink( const std::string& outfileroot, bool fit );
+
+      void Begin( const std::vector<double>& k, const std::vector<double>& h );
+      void Row( int i, const std::vector<CellResult>& row );
+      void End();
+
+   private:
+      std::string                      m_Filename;
+      std::vector<ResultField>         m_Fields;
+      std::ofstream                    m_File;
+      std::vector<double>              m_k;
+      std::vector<double>              m_h;
+      std::vector<std::vector<double>> m_Values;   // [field][i*h_count + j], unscaled
+};
 
 //=============================================================================
 #endif  // WRITE_RESULTS_H
@@ -0,0 +1,110 @@
+//=============================================================================
+// test_adaptive_engine.cpp
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include "test_adaptive_engine.h"
+#include "test_helpers.h"
+#include "unit_test.h"
+#include "..\src\adaptive_engine.h"
+#include "..\src\engine.h"
+
+//-----------------------------------------------------------------------------
+// Hide all of the testing details inside an unnamed namespace. This allows me
+// to create many small unit tests with polluting the global namespace.
+//-----------------------------------------------------------------------------
+namespace{
+
+   //--------------------------------------------------------------------------
+   // The largest difference between the adaptive and full results, in
+   // standard deviations.
+   //--------------------------------------------------------------------------
+   double LargestError( const Results& adaptive, const Results& full ) {
+      double largest = 0.0;
+      for (int i = 0; i < full.R_ev.nRows(); ++i) {
+         for (int j = 0; j < full.R_ev.nCols(); ++j) {
+            largest = std::max(largest, std::fabs(adaptive.R_ev(i,j) - full.R_ev(i,j)) / full.R_sd(i,j));
+            largest = std::max(largest, std::fabs(adaptive.M_ev(i,j) - full.M_ev(i,j)) / full.M_sd(i,j));
+            largest = std::max(largest, std::fabs(adaptive.D_ev(i,j) - full.D_ev(i,j)) / full.D_sd(i,j));
+            largest = std::max(largest, std::fabs(adaptive.R_sd(i,j) - full.R_sd(i,j)) / full.R_sd(i,j));
+         }
+      }
+      return largest;
+   }
+
+   //--------------------------------------------------------------------------
+   // TestAdaptiveEngineExact
+   //
+   //    A tolerance of 0 fits every cell, and matches the Engine.
+   //--------------------------------------------------------------------------
+   bool TestAdaptiveEngineExact() {
+      std::vector<ObsRecord> records;
+      std::vector<WellRecord> wells;
+      MakeProblem(records, wells);
+      ObsTable obs(records);
+
+      Results full = Engine(2000, -2000, 2.0, 0.5, 9, 4.5, 0.3, 7, 100.0, obs, wells);
+
+      Results adaptive;
+      MemoryResultSink sink(adaptive);
+      std::ostringstream points;
+      int nfits = AdaptiveEngine(2000, -2000, 2.0, 0.5, 9, 4.5, 0.3, 7, 100.0, obs, wells, 3, 0.0, 0, sink, points);
+
+      bool flag = true;
+      flag &= CHECK( nfits == 63 );
+      flag &= CHECK( LargestError(adaptive, full) < 1e-9 );
+      flag &= CHECK( isClose(adaptive.LogLik(4,3), full.LogLik(4,3), 1e-9) );
+      return flag;
+   }
+
+   //--------------------------------------------------------------------------
+   // TestAdaptiveEngineSmooth
+   //
+   //    With every observation on the confined branch the results are
+   //    smooth, so a small fraction of the cells is enough, and the
+   //    interpolated cells are close to the fits.
+   //--------------------------------------------------------------------------
+   bool TestAdaptiveEngineSmooth() {
+      std::vector<ObsRecord> records;
+      std::vector<WellRecord> wells;
+      MakeProblem(records, wells);
+      ObsTable obs(records);
+
+      Results full = Engine(2000, -2000, 2.0, 0.5, 33, 3.0, 0.2, 33, 100.0, obs, wells);
+
+      Results adaptive;
+      MemoryResultSink sink(adaptive);
+      std::ostringstream points;
+      int nfits = AdaptiveEngine(2000, -2000, 2.0, 0.5, 33, 3.0, 0.2, 33, 100.0, obs, wells, 5, 0.1, 4, sink, points);
+
+      bool flag = true;
+      flag &= CHECK( nfits < 33*33/4 );
+      flag &= CHECK( LargestError(adaptive, full) < 0.25 );
+      return flag;
+   }
+}
+
+//-----------------------------------------------------------------------------
+// test_AdaptiveEngine
+//-----------------------------------------------------------------------------
+std::pair<int,int> test_AdaptiveEngine()
+{
+   int nsucc = 0;
+   int nfail = 0;
+
+   TALLY( TestAdaptiveEngineExact() );
+   TALLY( TestAdaptiveEngineSmooth() );
+
+   return std::make_pair( nsucc, nfail );
+}
@@ -0,0 +1,228 @@
+//=============================================================================
+// test_binary_data.cpp
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "test_binary_data.h"
+#include "unit_test.h"
+#include "..\src\binary_data.h"
+
+//-----------------------------------------------------------------------------
+// Hide all of the testing details inside an unnamed namespace. This allows me
+// to create many small unit tests with polluting the global namespace.
+//-----------------------------------------------------------------------------
+namespace{
+   const char* FILENAME = "test_binary_data.gwb";
+
+   // Three observations with two distinct ids. With three records and two
+   // strings, the sections start at these 64-byte aligned offsets.
+   const std::size_t ID_INDEX = 64 + 4*64;
+   const std::size_t OFFSETS  = ID_INDEX + 64;
+   const std::size_t STRINGS  = OFFSETS + 64;
+
+   std::vector<ObsRecord> Observations() {
+      return std::vector<ObsRecord>{
+         ObsRecord{"MW-1", 100.5, -20.25, 250.0, 0.5},
+         ObsRecord{"MW-22", -3e5, 4e6, 251.125, 0.25},
+         ObsRecord{"MW-1", 0.0, 1.0, 249.0, 1.0}
+      };
+   }
+
+   std::vector<char> ReadBytes( const std::string& filename ) {
+      std::ifstream inpfile( filename, std::ios::binary );
+      return std::vector<char>( std::istreambuf_iterator<char>(inpfile), std::istreambuf_iterator<char>() );
+   }
+
+   void WriteBytes( const std::string& filename, const std::vector<char>& bytes ) {
+      std::ofstream outfile( filename, std::ios::binary );
+      outfile.write(bytes.data(), bytes.size());
+   }
+
+   void PutU64( std::vector<char>& bytes, std::size_t offset, uint64_t v ) {
+      for (int b = 0; b < 8; ++b)
+         bytes[offset + b] = static_cast<char>((v >> (8*b)) & 0xFF);
+   }
+
+   // True if opening the given file image throws InvalidBinaryFile.
+   bool isRejected( const std::vector<char>& bytes ) {
+      WriteBytes(FILENAME, bytes);
+      bool thrown = false;
+      try {
+         ColumnarFile file(FILENAME, BINARY_OBSERVATIONS);
+      }
+      catch (InvalidBinaryFile&) {
+         thrown = true;
+      }
+      std::remove(FILENAME);
+      return thrown;
+   }
+
+   //--------------------------------------------------------------------------
+   // TestRoundTrip
+   //
+   //    Every value must come back bit for bit, and the repeated id must be
+   //    stored only once.
+   //--------------------------------------------------------------------------
+   bool TestRoundTrip()
+   {
+      bool flag = true;
+
+      std::vector<ObsRecord> obs = Observations();
+      write_obs_binary(FILENAME, obs);
+      flag &= CHECK( is_binary_file(FILENAME) );
+      flag &= CHECK( ReadBytes(FILENAME).size() == STRINGS + 9 );
+
+      std::vector<ObsRecord> copy = read_obs_binary(FILENAME);
+      flag &= CHECK( copy.size() == obs.size() );
+      for (std::size_t m = 0; m < obs.size() && m < copy.size(); ++m) {
+         flag &= CHECK( copy[m].id == obs[m].id );
+         flag &= CHECK( copy[m].x == obs[m].x && copy[m].y == obs[m].y );
+         flag &= CHECK( copy[m].head_ev == obs[m].head_ev && copy[m].head_sd == obs[m].head_sd );
+      }
+
+      std::vector<WellRecord> wells = {
+         WellRecord{"PW-1", 2000, -2000, 0.25, 1500},
+         WellRecord{"PW-2", -50, 75, 0.5, -200}
+      };
+      write_well_binary(FILENAME, wells);
+      std::vector<WellRecord> well_copy = read_well_binary(FILENAME);
+      flag &= CHECK( well_copy.size() == wells.size() );
+      for (std::size_t n = 0; n < wells.size() && n < well_copy.size(); ++n) {
+         flag &= CHECK( well_copy[n].id == wells[n].id );
+         flag &= CHECK( well_copy[n].x == wells[n].x && well_copy[n].y == wells[n].y );
+         flag &= CHECK( well_copy[n].r == wells[n].r && well_copy[n].q == wells[n].q );
+      }
+
+      // A well file is not an observation file.
+      bool thrown = false;
+      try {
+         read_obs_binary(FILENAME);
+      }
+      catch (InvalidBinaryFile&) {
+         thrown = true;
+      }
+      flag &= CHECK( thrown );
+
+      std::remove(FILENAME);
+      return flag;
+   }
+
+   //--------------------------------------------------------------------------
+   // TestCorruptFiles
+   //
+   //    Every damaged image must be rejected at open, before any pointer
+   //    into the mapping is used.
+   //--------------------------------------------------------------------------
+   bool TestCorruptFiles()
+   {
+      write_obs_binary(FILENAME, Observations());
+      const std::vector<char> good = ReadBytes(FILENAME);
+      std::remove(FILENAME);
+
+      bool flag = true;
+      flag &= CHECK( !isRejected(good) );
+
+      // Truncated, in the header and in the string table.
+      flag &= CHECK( isRejected(std::vector<char>(good.begin(), good.begin() + 40)) );
+      flag &= CHECK( isRejected(std::vector<char>(good.begin(), good.end() - 1)) );
+
+      // The header: magic, version, record count, and string count.
+      std::vector<char> bytes = good;
+      bytes[0] = 'X';
+      flag &= CHECK( isRejected(bytes) );
+
+      bytes = good;
+      bytes[8] = 2;
+      flag &= CHECK( isRejected(bytes) );
+
+      bytes = good;
+      PutU64(bytes, 16, 1000);
+      flag &= CHECK( isRejected(bytes) );
+
+      bytes = good;
+      PutU64(bytes, 24, 4);
+      flag &= CHECK( isRejected(bytes) );
+
+      // The string offsets: out of order, and past the string table.
+      bytes = good;
+      PutU64(bytes, OFFSETS + 8, 10);
+      flag &= CHECK( isRejected(bytes) );
+
+      bytes = good;
+      PutU64(bytes, OFFSETS + 16, 10);
+      flag &= CHECK( isRejected(bytes) );
+
+      // The id index: a string that does not exist.
+      bytes = good;
+      bytes[ID_INDEX + 4] = 2;
+      flag &= CHECK( isRejected(bytes) );
+
+      return flag;
+   }
+
+   //--------------------------------------------------------------------------
+   // TestInvalidValues
+   //
+   //    The values must pass the same checks as the .csv reader.
+   //--------------------------------------------------------------------------
+   bool TestInvalidValues()
+   {
+      bool flag = true;
+
+      std::vector<ObsRecord> obs = Observations();
+      obs[1].head_sd = 0.0;
+      write_obs_binary(FILENAME, obs);
+      flag &= CHECK( isRejected(ReadBytes(FILENAME)) );
+
+      obs = Observations();
+      obs[2].head_ev = -1.0;
+      write_obs_binary(FILENAME, obs);
+      flag &= CHECK( isRejected(ReadBytes(FILENAME)) );
+
+      // The wells have no such restriction; a negative discharge is an
+      // injection well.
+      std::vector<WellRecord> wells = { WellRecord{"IW-1", 0, 0, 0.25, -100} };
+      write_well_binary(FILENAME, wells);
+      bool thrown = false;
+      try {
+         read_well_binary(FILENAME);
+      }
+      catch (InvalidBinaryFile&) {
+         thrown = true;
+      }
+      flag &= CHECK( !thrown );
+
+      std::remove(FILENAME);
+      return flag;
+   }
+}
+
+//-----------------------------------------------------------------------------
+// test_BinaryData
+//-----------------------------------------------------------------------------
+std::pair<int,int> test_BinaryData()
+{
+   int nsucc = 0;
+   int nfail = 0;
+
+   TALLY( TestRoundTrip() );
+   TALLY( TestCorruptFiles() );
+   TALLY( TestInvalidValues() );
+
+   return std::make_pair( nsucc, nfail );
+}
@@ -0,0 +1,21 @@
+//=============================================================================
+// test_binary_data.h
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#ifndef TEST_BINARY_DATA_H
+#define TEST_BINARY_DATA_H
+
+#include <utility>
+
+//-----------------------------------------------------------------------------
+std::pair<int,int> test_BinaryData();
+
+//=============================================================================
+#endif  // TEST_BINARY_DATA_H
@@ -0,0 +1,105 @@
+//=============================================================================
+// test_bootstrap.cpp
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#include <cmath>
+#include <utility>
+
+#include "test_bootstrap.h"
+#include "unit_test.h"
+#include "..\src\bootstrap.h"
+#include "..\src\engine.h"
+
+//-----------------------------------------------------------------------------
+// Hide all of the testing details inside an unnamed namespace. This allows me
+// to create many small unit tests with polluting the global namespace.
+//-----------------------------------------------------------------------------
+namespace{
+
+   //--------------------------------------------------------------------------
+   // A 6 x 6 grid of observations with a little noise, about the origin.
+   //--------------------------------------------------------------------------
+   void MakeSystem( std::vector<double>& rows, std::vector<double>& w, std::vector<double>& y ) {
+      for (int i = 0; i < 6; ++i) {
+         for (int j = 0; j < 6; ++j) {
+            double dx = 200.0*(i - 2.5);
+            double dy = 200.0*(j - 2.5);
+            double row[QUADRATIC_TERMS];
+            QuadraticBasis(dx, dy, row);
+            rows.insert(rows.end(), row, row + QUADRATIC_TERMS);
+
+            double noise = ((7*i + 3*j) % 5 - 2) * 0.4;
+            w.push_back( 1.0/(1.0 + 0.1*i) );
+            y.push_back( -1e-4*(dx*dx + dy*dy) + 0.3*dx - 0.2*dy + 1000 + noise );
+         }
+      }
+   }
+
+   //--------------------------------------------------------------------------
+   // TestBootstrapReproducible
+   //
+   //    The same seed gives the same results on any number of threads; a
+   //    different seed gives different results.
+   //--------------------------------------------------------------------------
+   bool TestBootstrapReproducible()
+   {
+      std::vector<double> rows, w, y;
+      MakeSystem(rows, w, y);
+
+      BootstrapResult one  = Bootstrap(rows, w, y, 500, 42, 1);
+      BootstrapResult four = Bootstrap(rows, w, y, 500, 42, 4);
+      BootstrapResult other = Bootstrap(rows, w, y, 500, 43, 4);
+
+      bool flag = true;
+      flag &= CHECK( one.replicates == four.replicates );
+      flag &= CHECK( one.recharge.mean  == four.recharge.mean );
+      flag &= CHECK( one.magnitude.sd   == four.magnitude.sd );
+      flag &= CHECK( one.direction.upper == four.direction.upper );
+      flag &= CHECK( one.recharge.mean  != other.recharge.mean );
+      return flag;
+   }
+
+   //--------------------------------------------------------------------------
+   // TestBootstrapSummary
+   //
+   //    The bootstrap distributions must bracket the all-observation values.
+   //--------------------------------------------------------------------------
+   bool TestBootstrapSummary()
+   {
+      std::vector<double> rows, w, y;
+      MakeSystem(rows, w, y);
+
+      BootstrapResult result = Bootstrap(rows, w, y, 2000, 7, 0);
+
+      // The generating recharge is -2(A+B) = 4e-4, the magnitude is
+      // sqrt(0.3^2 + 0.2^2), and the direction is atan2(0.2, -0.3).
+      bool flag = true;
+      flag &= CHECK( result.replicates == 2000 );
+      flag &= CHECK( result.recharge.lower  < 4e-4 && 4e-4 < result.recharge.upper );
+      flag &= CHECK( result.magnitude.lower < std::hypot(0.3, 0.2) && std::hypot(0.3, 0.2) < result.magnitude.upper );
+      flag &= CHECK( result.direction.lower < std::atan2(0.2, -0.3) && std::atan2(0.2, -0.3) < result.direction.upper );
+      flag &= CHECK( result.recharge.sd > 0 && result.recharge.sd < 1e-4 );
+      return flag;
+   }
+}
+
+//-----------------------------------------------------------------------------
+// test_Bootstrap
+//-----------------------------------------------------------------------------
+std::pair<int,int> test_Bootstrap()
+{
+   int nsucc = 0;
+   int nfail = 0;
+
+   TALLY( TestBootstrapReproducible() );
+   TALLY( TestBootstrapSummary() );
+
+   return std::make_pair( nsucc, nfail );
+}
@@ -0,0 +1,21 @@
+//=============================================================================
+// test_bootstrap.h
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#ifndef TEST_BOOTSTRAP_H
+#define TEST_BOOTSTRAP_H
+
+#include <utility>
+
+//-----------------------------------------------------------------------------
+std::pair<int,int> test_Bootstrap();
+
+//=============================================================================
+#endif  // TEST_BOOTSTRAP_H
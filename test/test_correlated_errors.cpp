@@ -0,0 +1,170 @@
+//=============================================================================
+// test_correlated_errors.cpp
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#include <cmath>
+#include <utility>
+
+#include "test_correlated_errors.h"
+#include "unit_test.h"
+#include "..\src\correlated_errors.h"
+#include "..\src\engine.h"
+#include "..\src\linear_systems.h"
+#include "..\src\normal_equations.h"
+
+//-----------------------------------------------------------------------------
+// Hide all of the testing details inside an unnamed namespace. This allows me
+// to create many small unit tests with polluting the global namespace.
+//-----------------------------------------------------------------------------
+namespace{
+   const double TOLERANCE = 1e-9;
+
+   // True if a and b differ by at most TOLERANCE times "scale", e.g. a
+   // standard deviation.
+   bool isWithin( double a, double b, double scale ) {
+      return std::fabs(a - b) <= TOLERANCE * scale;
+   }
+
+   //--------------------------------------------------------------------------
+   // TestFitCorrelatedModel
+   //
+   //    The Woodbury fit must match the dense generalized least squares fit
+   //    with the full covariance matrix V = diag(1/w) + UU'.
+   //--------------------------------------------------------------------------
+   bool TestFitCorrelatedModel()
+   {
+      const int M = 30;
+      const int n = QUADRATIC_TERMS;
+      const int r = 3;
+
+      std::vector<double> rows(M*n), w(M), y(M);
+      std::vector<FactorLoading> loadings;
+      for (int m = 0; m < M; ++m) {
+         double dx = 100.0*(m % 6) - 250;
+         double dy = 120.0*(m / 6) - 240 + 7*(m % 4);
+         QuadraticBasis(dx, dy, &rows[m*n]);
+         w[m] = 1.0/(0.5 + 0.05*m);
+         y[m] = 1000 - 1e-4*(dx*dx + dy*dy) + 0.2*dx - 0.1*dy + 0.3*((m*7) % 5);
+
+         // Two campaigns, and a season shared by every third observation.
+         loadings.push_back( FactorLoading{m, m < 15 ? 0 : 1, 0.8 + 0.01*m} );
+         if (m % 3 == 0)
+            loadings.push_back( FactorLoading{m, 2, 0.4} );
+      }
+
+      Matrix P_ev, P_cov;
+      std::tie(P_ev, P_cov) = FitCorrelatedModel(rows, w, y, loadings, r, 2);
+
+      // The dense reference.
+      Matrix U(M, r, 0.0);
+      for (const FactorLoading& l : loadings)
+         U(l.obs, l.factor) += l.value;
+
+      Matrix V, Vinv;
+      Multiply_MMt(U, U, V);
+      for (int m = 0; m < M; ++m)
+         V(m,m) += 1.0/w[m];
+      RSPDInv(V, Vinv);
+
+      Matrix X(M, n, &rows[0]);
+      Matrix Y(M, 1, &y[0]);
+      Matrix Q_ev, Q_cov;
+      std::tie(Q_ev, Q_cov) = FitQuadraticModel(X, Vinv, Y);
+
+      bool flag = true;
+      for (int i = 0; i < n; ++i) {
+         flag &= CHECK( isWithin(P_ev(i,0), Q_ev(i,0), std::sqrt(Q_cov(i,i))) );
+         for (int j = 0; j < n; ++j)
+            flag &= CHECK( isWithin(P_cov(i,j), Q_cov(i,j), std::sqrt(Q_cov(i,i)*Q_cov(j,j))) );
+      }
+
+      // Without factors, the fit is the independent errors fit.
+      NormalEquations equations;
+      for (int m = 0; m < M; ++m)
+         equations.Add(&rows[m*n], w[m], y[m]);
+      Matrix XtWX, XtWY, R_ev, R_cov;
+      equations.Assemble(XtWX, XtWY);
+      std::tie(R_ev, R_cov) = SolveNormalEquations(XtWX, XtWY);
+
+      std::tie(P_ev, P_cov) = FitCorrelatedModel(rows, w, y, std::vector<FactorLoading>(), 0, 1);
+      flag &= CHECK( isClose(P_ev, R_ev, 0.0) );
+      flag &= CHECK( isClose(P_cov, R_cov, 0.0) );
+      return flag;
+   }
+
+   //--------------------------------------------------------------------------
+   // TestBuildErrorFactors
+   //--------------------------------------------------------------------------
+   bool TestBuildErrorFactors()
+   {
+      std::vector<ObsRecord> records = {
+         ObsRecord{"a", 0, 0, 10, 1},
+         ObsRecord{"b", 1, 0, 10, 1},
+         ObsRecord{"c", 2, 0, 10, 1}
+      };
+      ObsTable obs(records);
+
+      std::vector<FactorRecord> factor_records = {
+         FactorRecord{"c", "datum", 0.5},
+         FactorRecord{"a", "spring", 0.2},
+         FactorRecord{"a", "datum", 0.5}
+      };
+      ErrorFactors factors = BuildErrorFactors(obs, factor_records);
+
+      bool flag = true;
+      flag &= CHECK( factors.names.size() == 2 );
+      flag &= CHECK( factors.names[0] == "datum" );
+      flag &= CHECK( factors.loadings.size() == 3 );
+      flag &= CHECK( factors.loadings[0].obs == 2 && factors.loadings[0].factor == 0 );
+      flag &= CHECK( factors.loadings[1].obs == 0 && factors.loadings[1].factor == 1 );
+      flag &= CHECK( factors.loadings[2].obs == 0 && factors.loadings[2].factor == 0 );
+
+      factor_records.push_back( FactorRecord{"z", "datum", 0.5} );
+      bool thrown = false;
+      try {
+         BuildErrorFactors(obs, factor_records);
+      }
+      catch (InvalidFactorRecord&) {
+         thrown = true;
+      }
+      flag &= CHECK( thrown );
+
+      // An ID shared by two observations is ambiguous, but only if named.
+      records.push_back( ObsRecord{"b", 3, 0, 10, 1} );
+      ObsTable repeated(records);
+      factor_records.pop_back();
+      flag &= CHECK( BuildErrorFactors(repeated, factor_records).loadings.size() == 3 );
+
+      factor_records.push_back( FactorRecord{"b", "datum", 0.5} );
+      thrown = false;
+      try {
+         BuildErrorFactors(repeated, factor_records);
+      }
+      catch (InvalidFactorRecord&) {
+         thrown = true;
+      }
+      flag &= CHECK( thrown );
+      return flag;
+   }
+}
+
+//-----------------------------------------------------------------------------
+// test_CorrelatedErrors
+//-----------------------------------------------------------------------------
+std::pair<int,int> test_CorrelatedErrors()
+{
+   int nsucc = 0;
+   int nfail = 0;
+
+   TALLY( TestFitCorrelatedModel() );
+   TALLY( TestBuildErrorFactors() );
+
+   return std::make_pair( nsucc, nfail );
+}
@@ -0,0 +1,21 @@
+//=============================================================================
+// test_correlated_errors.h
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#ifndef TEST_CORRELATED_ERRORS_H
+#define TEST_CORRELATED_ERRORS_H
+
+#include <utility>
+
+//-----------------------------------------------------------------------------
+std::pair<int,int> test_CorrelatedErrors();
+
+//=============================================================================
+#endif  // TEST_CORRELATED_ERRORS_H
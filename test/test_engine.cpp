@@ -9,6 +9,7 @@
 // version:
 //    30 June 2017
 //=============================================================================
+#include <cmath>
 #include <utility>
 
 #include "test_engine.h"
@@ -141,6 +142,156 @@ namespace{
       return flag;
    }
 
+   //--------------------------------------------------------------------------
+   // TestSetupQuadraticModelActiveView
+   //
+   //    Setting up the model from an index view into an ObsTable must give
+   //    exactly the same matrices as setting it up from a copy of the
+   //    selected records.
+   //--------------------------------------------------------------------------
+   bool TestSetupQuadraticModelActiveView()
+   {
+      double xo = 2250;
+      double yo = -2250;
+
+      double conductivity = 10;
+      double thickness = 105;
+
+      std::vector<ObsRecord> obs = {
+         ObsRecord{"01",1000,-1000,100,1},
+         ObsRecord{"xx",2250,-2250,999,9},
+         ObsRecord{"03",1000,-2000,110,1},
+         ObsRecord{"04",1000,-2500,115,2},
+         ObsRecord{"xx",2260,-2240,999,9},
+         ObsRecord{"06",1500,-1000,95,1},
+         ObsRecord{"07",1500,-1500,100,3},
+         ObsRecord{"08",1500,-2000,105,1}
+      };
+      std::vector<int> active = {0, 2, 3, 5, 6, 7};
+
+      std::vector<ObsRecord> selected;
+      for (int m : active)
+         selected.push_back(obs[m]);
+
+      std::vector<WellRecord> wells = {
+         WellRecord{"12345",2250,-2250,0.25,750}
+      };
+
+      Matrix X1, Vinv1, Y1;
+      std::tie(X1, Vinv1, Y1) = SetupQuadraticModel(xo, yo, conductivity, thickness, ObsTable(obs), active, wells);
+
+      Matrix X2, Vinv2, Y2;
+      std::tie(X2, Vinv2, Y2) = SetupQuadraticModel(xo, yo, conductivity, thickness, selected, wells);
+
+      bool flag = true;
+      flag &= CHECK( isClose(X1, X2, TOLERANCE) );
+      flag &= CHECK( isClose(Y1, Y2, TOLERANCE) );
+      flag &= CHECK( isClose(Vinv1, Vinv2, TOLERANCE) );
+      return flag;
+   }
+
+   //--------------------------------------------------------------------------
+   // TestNormalEquations
+   //
+   //    Folding the observations into the normal equations one at a time
+   //    must give the same fit as building X, Vinv and Y.
+   //--------------------------------------------------------------------------
+   bool TestNormalEquations()
+   {
+      double xo = 2250;
+      double yo = -2250;
+
+      double conductivity = 10;
+      double thickness = 105;
+
+      std::vector<ObsRecord> obs;
+      for (int i = 0; i < 5; ++i)
+         for (int j = 0; j < 5; ++j)
+            obs.push_back( ObsRecord{"", 1000.0+500*i, -1000.0-500*j, 100.0-5*i+5*j, 1.0+0.1*j} );
+
+      std::vector<WellRecord> wells = {
+         WellRecord{"12345",2250,-2250,0.25,750}
+      };
+
+      Matrix X, Vinv, Y;
+      std::tie(X, Vinv, Y) = SetupQuadraticModel(xo, yo, conductivity, thickness, obs, wells);
+
+      Matrix P_ev, P_cov;
+      std::tie(P_ev, P_cov) = FitQuadraticModel(X, Vinv, Y);
+
+      NormalEquations ne;
+      for (const ObsRecord& ob : obs) {
+         double row[QUADRATIC_TERMS];
+         QuadraticBasis(ob.x - xo, ob.y - yo, row);
+
+         double Phi_ev, Phi_sd;
+         DischargePotential(ob.head_ev, ob.head_sd, conductivity, thickness, Phi_ev, Phi_sd);
+         ne.Add(row, 1.0/(Phi_sd*Phi_sd), Phi_ev - WellPotential(ob.x, ob.y, wells));
+      }
+
+      Matrix XtWX, XtWY;
+      ne.Assemble(XtWX, XtWY);
+
+      Matrix Q_ev, Q_cov;
+      std::tie(Q_ev, Q_cov) = SolveNormalEquations(XtWX, XtWY);
+
+      bool flag = true;
+      flag &= CHECK( ne.Count() == 25 );
+      flag &= CHECK( isClose(P_ev,  Q_ev,  TOLERANCE) );
+      flag &= CHECK( isClose(P_cov, Q_cov, TOLERANCE) );
+      return flag;
+   }
+
+   //--------------------------------------------------------------------------
+   // TestNormalEquationsTranslate
+   //
+   //    Sums accumulated about one center, with one observation added and
+   //    removed, and then translated to another center must match the sums
+   //    accumulated directly about the second center.
+   //--------------------------------------------------------------------------
+   bool TestNormalEquationsTranslate()
+   {
+      const double xa = 1000, ya = -3000;     // the first center
+      const double xb = 2250, yb = -2250;     // the second center
+
+      NormalEquations about_a, about_b;
+      double row[QUADRATIC_TERMS];
+
+      for (int i = 0; i < 5; ++i) {
+         for (int j = 0; j < 5; ++j) {
+            double x = 1000.0+500*i;
+            double y = -1000.0-500*j;
+            double w = 1.0/(1.0+0.1*j);
+            double v = 100.0-5*i+5*j;
+
+            QuadraticBasis(x - xa, y - ya, row);
+            about_a.Add(row, w, v);
+            QuadraticBasis(x - xb, y - yb, row);
+            about_b.Add(row, w, v);
+         }
+      }
+
+      QuadraticBasis(1234 - xa, -2345 - ya, row);
+      about_a.Add(row, 3.0, 17.0);
+      about_a.Remove(row, 3.0, 17.0);
+
+      about_a.Translate(xb - xa, yb - ya);
+
+      Matrix A, a, B, b;
+      about_a.Assemble(A, a);
+      about_b.Assemble(B, b);
+
+      Matrix dA, da;
+      Subtract_MM(A, B, dA);
+      Subtract_MM(a, b, da);
+
+      bool flag = true;
+      flag &= CHECK( about_a.Count() == 25 );
+      flag &= CHECK( MaxAbs(dA) <= 1e-12 * MaxAbs(B) );
+      flag &= CHECK( MaxAbs(da) <= 1e-12 * MaxAbs(b) );
+      return flag;
+   }
+
    //--------------------------------------------------------------------------
    // TestFitQuadraticModel
    //
@@ -243,6 +394,123 @@ namespace{
       return flag;
    }
 
+   //--------------------------------------------------------------------------
+   // TestFitWeightedModelQR
+   //
+   //    The QR fit of the weighted regression matrix must match the normal
+   //    equations fit, on one thread and on several.
+   //--------------------------------------------------------------------------
+   bool TestFitWeightedModelQR() {
+      const double xo = 2250;
+      const double yo = -2250;
+      const double conductivity = 10;
+      const double thickness = 105;
+
+      std::vector<ObsRecord> records;
+      for (int i = 0; i < 60; ++i)
+         for (int j = 0; j < 50; ++j)
+            records.push_back( ObsRecord{"", 1000.0+40*i + 3*j, -1000.0-45*j + 0.1*i*i, 100.0-0.1*i+0.2*j + 0.003*i*j, 1.0+0.01*j} );
+
+      std::vector<WellRecord> wells = {
+         WellRecord{"12345",2250,-2250,0.25,750}
+      };
+
+      ObsTable obs(records);
+      std::vector<int> active = AllIndices(obs);
+
+      Matrix X, Vinv, Y;
+      std::tie(X, Vinv, Y) = SetupQuadraticModel(xo, yo, conductivity, thickness, obs, active, wells);
+
+      Matrix P_ev, P_cov;
+      std::tie(P_ev, P_cov) = FitQuadraticModel(X, Vinv, Y);
+
+      Matrix Z = SetupWeightedModel(xo, yo, conductivity, thickness, obs, active, wells);
+
+      bool flag = true;
+      for (int nthreads = 1; nthreads <= 4; nthreads += 3) {
+         Matrix Q_ev, Q_cov;
+         std::tie(Q_ev, Q_cov) = FitWeightedModelQR(Z, nthreads);
+
+         for (int i = 0; i < QUADRATIC_TERMS; ++i) {
+            flag &= CHECK( std::fabs(Q_ev(i,0) - P_ev(i,0)) <= 1e-7*std::fabs(P_ev(i,0)) );
+            for (int j = 0; j < QUADRATIC_TERMS; ++j)
+               flag &= CHECK( std::fabs(Q_cov(i,j) - P_cov(i,j)) <= 1e-7*std::sqrt(P_cov(i,i)*P_cov(j,j)) );
+         }
+      }
+      return flag;
+   }
+
+   //--------------------------------------------------------------------------
+   // TestGoodnessOfFit
+   //
+   //    The weighted residual sum of squares from the sufficient statistics,
+   //    by the normal equations and by QR, and the log-likelihood of the
+   //    heads, against the same quantities computed directly from the
+   //    residuals: the density of each discharge potential times its
+   //    Jacobian, Phi_sd/head_sd. The thicknesses put every observation on
+   //    the confined branch, some on each, and every one on the unconfined
+   //    branch.
+   //--------------------------------------------------------------------------
+   bool TestGoodnessOfFit() {
+      const double xo = 2250;
+      const double yo = -2250;
+      const double conductivity = 10;
+
+      std::vector<ObsRecord> records;
+      for (int i = 0; i < 60; ++i)
+         for (int j = 0; j < 50; ++j)
+            records.push_back( ObsRecord{"", 1000.0+40*i + 3*j, -1000.0-45*j + 0.1*i*i, 100.0-0.1*i+0.2*j + 0.003*i*j, 1.0+0.01*j} );
+
+      std::vector<WellRecord> wells = {
+         WellRecord{"12345",2250,-2250,0.25,750}
+      };
+
+      ObsTable obs(records);
+      std::vector<int> active = AllIndices(obs);
+      const int M = active.size();
+
+      const double log_head_sd = HeadLogSdSum(obs, active);
+
+      bool flag = true;
+      for (double thickness : {50.0, 105.0, 200.0}) {
+         Matrix X, Vinv, Y;
+         std::tie(X, Vinv, Y) = SetupQuadraticModel(xo, yo, conductivity, thickness, obs, active, wells);
+
+         Matrix P_ev, P_cov;
+         double wrss;
+         std::tie(P_ev, P_cov) = FitQuadraticModel(X, Vinv, Y, wrss);
+
+         double yWy = 0.0;
+         double direct = 0.0;
+         double loglik = 0.0;
+         for (int m = 0; m < M; ++m) {
+            double r = Y(m,0);
+            for (int t = 0; t < QUADRATIC_TERMS; ++t)
+               r -= X(m,t) * P_ev(t,0);
+
+            const double w = Vinv(m,m);
+            const double Phi_sd = 1.0/std::sqrt(w);
+            yWy    += w * Y(m,0) * Y(m,0);
+            direct += w * r * r;
+            loglik += -0.5*(w*r*r + std::log(TWO_PI) - std::log(w)) + std::log(Phi_sd/obs.head_sd()[active[m]]);
+         }
+
+         flag &= CHECK( std::fabs(wrss - direct) <= TOLERANCE*yWy );
+
+         Matrix Z = SetupWeightedModel(xo, yo, conductivity, thickness, obs, active, wells);
+         Matrix Q_ev, Q_cov;
+         double qr_wrss;
+         std::tie(Q_ev, Q_cov) = FitWeightedModelQR(Z, 1, qr_wrss);
+         flag &= CHECK( std::fabs(qr_wrss - direct) <= 1e-7*direct );
+
+         CellResult cell;
+         SetGoodnessOfFit(cell, direct, M, QUADRATIC_TERMS, log_head_sd);
+         flag &= CHECK( std::fabs(cell.reduced_chisq - direct/(M - QUADRATIC_TERMS)) <= TOLERANCE*cell.reduced_chisq );
+         flag &= CHECK( std::fabs(cell.loglik - loglik) <= TOLERANCE*std::fabs(loglik) );
+      }
+      return flag;
+   }
+
    //--------------------------------------------------------------------------
    // TestComputeGeohydrologyStatistics
    //
@@ -406,6 +674,44 @@ namespace{
       return flag;
    }
 
+   //--------------------------------------------------------------------------
+   bool TestAsyncResultSink() {
+      const int k_count = 100;
+      const int h_count = 7;
+
+      std::vector<double> k(k_count);
+      std::vector<double> h(h_count);
+      for (int i = 0; i < k_count; ++i) k[i] = i;
+      for (int j = 0; j < h_count; ++j) h[j] = j;
+
+      // Push the rows through a small queue, so that the producer has to
+      // wait for the background thread.
+      Results results;
+      MemoryResultSink memory(results);
+      AsyncResultSink sink(memory, 2);
+
+      sink.Begin(k, h);
+      std::vector<CellResult> row(h_count);
+      for (int i = 0; i < k_count; ++i) {
+         for (int j = 0; j < h_count; ++j)
+            row[j] = CellResult{1.0*i, 1.0*j, i+j+0.0, i-j+0.0, i*j+0.0, 2.0*i};
+         sink.Row(i, row);
+      }
+      sink.End();
+
+      bool flag = true;
+      flag &= CHECK( results.k == k );
+      flag &= CHECK( results.h == h );
+      for (int i = 0; i < k_count; ++i) {
+         for (int j = 0; j < h_count; ++j) {
+            flag &= CHECK( results.R_ev(i,j) == i   && results.R_sd(i,j) == j );
+            flag &= CHECK( results.M_ev(i,j) == i+j && results.M_sd(i,j) == i-j );
+            flag &= CHECK( results.D_ev(i,j) == i*j && results.D_sd(i,j) == 2*i );
+         }
+      }
+      return flag;
+   }
+
 
 //-----------------------------------------------------------------------------
 // test_Engine
@@ -416,9 +722,15 @@ std::pair<int,int> test_Engine()
    int nfail = 0;
 
    TALLY( TestSetupQuadraticModel() );
+   TALLY( TestSetupQuadraticModelActiveView() );
+   TALLY( TestNormalEquations() );
+   TALLY( TestNormalEquationsTranslate() );
    TALLY( TestFitQuadraticModel() );
+   TALLY( TestFitWeightedModelQR() );
+   TALLY( TestGoodnessOfFit() );
    TALLY( TestComputeGeohydrologyStatistics() );
    TALLY( TestEngine() );
+   TALLY( TestAsyncResultSink() );
 
    return std::make_pair( nsucc, nfail );
 }
@@ -0,0 +1,57 @@
+//=============================================================================
+// test_helpers.cpp
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#include "test_helpers.h"
+
+//-----------------------------------------------------------------------------
+namespace{
+   const double TOLERANCE = 1e-9;
+}
+
+//-----------------------------------------------------------------------------
+bool isCloseRel( double a, double b ) {
+   return std::fabs(a - b) <= TOLERANCE * std::max(1.0, std::fabs(b));
+}
+
+//-----------------------------------------------------------------------------
+bool isCloseRel( const Matrix& A, const Matrix& B ) {
+   bool flag = (A.nRows() == B.nRows() && A.nCols() == B.nCols());
+   for (int i = 0; flag && i < A.nRows(); ++i)
+      for (int j = 0; j < A.nCols(); ++j)
+         flag &= isCloseRel(A(i,j), B(i,j));
+   return flag;
+}
+
+//-----------------------------------------------------------------------------
+std::vector<ObsRecord> GridObservations() {
+   std::vector<ObsRecord> obs;
+   for (int i = 0; i < 4; ++i)
+      for (int j = 0; j < 4; ++j)
+         obs.push_back( ObsRecord{"", 1000.0+500*i + 37*j, -1000.0-500*j + 11*i*i, 100.0-5*i+5*j + 0.3*i*j, 1.0+0.1*j} );
+   return obs;
+}
+
+//-----------------------------------------------------------------------------
+void MakeProblem( std::vector<ObsRecord>& obs, std::vector<WellRecord>& wells ) {
+   for (int i = 0; i < 6; ++i) {
+      for (int j = 0; j < 6; ++j) {
+         double x = 1500.0 + 200.0*i;
+         double y = -2500.0 + 200.0*j;
+         double head = 100.0 - 0.004*(x - 2000.0) + 0.002*(y + 2000.0) - 1e-6*((x-2000)*(x-2000) + (y+2000)*(y+2000));
+         obs.push_back( ObsRecord{std::to_string(6*i + j), x, y, head, 0.5 + 0.1*((i + 2*j) % 3)} );
+      }
+   }
+   wells.push_back( WellRecord{"W1", 2000.0, -2000.0, 0.25, 200.0} );
+}
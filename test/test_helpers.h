@@ -0,0 +1,46 @@
+//=============================================================================
+// test_helpers.h
+//
+//    Comparisons and small observation sets shared by the unit tests.
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#ifndef TEST_HELPERS_H
+#define TEST_HELPERS_H
+
+#include <vector>
+
+#include "..\src\matrix.h"
+#include "..\src\read_data.h"
+
+//-----------------------------------------------------------------------------
+// True if a and b agree to a relative tolerance of 1e-9, or an absolute
+// tolerance of 1e-9 when b is smaller than one; elementwise for matrices.
+//-----------------------------------------------------------------------------
+bool isCloseRel( double a, double b );
+bool isCloseRel( const Matrix& A, const Matrix& B );
+
+//-----------------------------------------------------------------------------
+// A 4 x 4 grid of observations, slightly skewed, about (2250,-2250).
+// Observation 4*i + j is at
+//
+//    (1000 + 500 i + 37 j, -1000 - 500 j + 11 i^2)
+//
+// with head_ev = 100 - 5 i + 5 j + 0.3 i j and head_sd = 1 + 0.1 j.
+//-----------------------------------------------------------------------------
+std::vector<ObsRecord> GridObservations();
+
+//-----------------------------------------------------------------------------
+// A 6 x 6 grid of observations about (2000,-2000), with one well at the
+// center. The heads range from about 94 to 106.
+//-----------------------------------------------------------------------------
+void MakeProblem( std::vector<ObsRecord>& obs, std::vector<WellRecord>& wells );
+
+//=============================================================================
+#endif  // TEST_HELPERS_H
@@ -0,0 +1,121 @@
+//=============================================================================
+// test_kdtree.cpp
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "test_kdtree.h"
+#include "unit_test.h"
+#include "..\src\kdtree.h"
+#include "..\src\numerical_constants.h"
+
+//-----------------------------------------------------------------------------
+// Hide all of the testing details inside an unnamed namespace. This allows me
+// to create many small unit tests with polluting the global namespace.
+//-----------------------------------------------------------------------------
+namespace{
+
+   //--------------------------------------------------------------------------
+   // A scattered, deterministic set of points, with some repeats.
+   //--------------------------------------------------------------------------
+   void MakePoints( std::vector<double>& x, std::vector<double>& y ) {
+      unsigned int seed = 12345;
+      for (int m = 0; m < 500; ++m) {
+         seed = 1103515245u*seed + 12345u;
+         x.push_back( (seed >> 8) % 1000 );
+         seed = 1103515245u*seed + 12345u;
+         y.push_back( (seed >> 8) % 700 );
+      }
+   }
+
+   //--------------------------------------------------------------------------
+   // TestKdTreeWithin
+   //
+   //    Compare the radius search against a brute force search.
+   //--------------------------------------------------------------------------
+   bool TestKdTreeWithin()
+   {
+      std::vector<double> x, y;
+      MakePoints(x, y);
+      KdTree tree(x.data(), y.data(), x.size());
+
+      bool flag = true;
+      std::vector<int> found;
+
+      const double queries[][3] = { {500, 350, 100}, {0, 0, 150}, {999, 10, 60}, {300, 300, 0}, {-5000, 0, 10} };
+      for (const auto& q : queries) {
+         tree.Within(q[0], q[1], q[2], found);
+         std::sort(found.begin(), found.end());
+
+         std::vector<int> expected;
+         for (int m = 0; m < static_cast<int>(x.size()); ++m)
+            if ((x[m]-q[0])*(x[m]-q[0]) + (y[m]-q[1])*(y[m]-q[1]) <= q[2]*q[2])
+               expected.push_back(m);
+
+         flag &= CHECK( found == expected );
+      }
+      return flag;
+   }
+
+   //--------------------------------------------------------------------------
+   // TestKdTreeNearest
+   //
+   //    Compare the nearest neighbor search against a brute force sort, by
+   //    distance (ties may be broken either way).
+   //--------------------------------------------------------------------------
+   bool TestKdTreeNearest()
+   {
+      std::vector<double> x, y;
+      MakePoints(x, y);
+      KdTree tree(x.data(), y.data(), x.size());
+
+      auto Distance2 = [&](int m, double qx, double qy) {
+         return (x[m]-qx)*(x[m]-qx) + (y[m]-qy)*(y[m]-qy);
+      };
+
+      bool flag = true;
+      std::vector<int> found;
+
+      const double queries[][2] = { {500, 350}, {0, 0}, {1200, 800} };
+      for (const auto& q : queries) {
+         std::vector<double> d2;
+         for (int m = 0; m < static_cast<int>(x.size()); ++m)
+            d2.push_back( Distance2(m, q[0], q[1]) );
+         std::sort(d2.begin(), d2.end());
+
+         tree.Nearest(q[0], q[1], 25, INF, found);
+         flag &= CHECK( found.size() == 25 );
+         for (int n = 0; n < static_cast<int>(found.size()); ++n)
+            flag &= CHECK( Distance2(found[n], q[0], q[1]) == d2[n] );
+
+         // The radius limit: only the points within 50 of the query.
+         tree.Nearest(q[0], q[1], 1000, 50, found);
+         int within = std::count_if(d2.begin(), d2.end(), [](double d) { return d <= 2500; });
+         flag &= CHECK( static_cast<int>(found.size()) == within );
+      }
+      return flag;
+   }
+}
+
+//-----------------------------------------------------------------------------
+// test_KdTree
+//-----------------------------------------------------------------------------
+std::pair<int,int> test_KdTree()
+{
+   int nsucc = 0;
+   int nfail = 0;
+
+   TALLY( TestKdTreeWithin() );
+   TALLY( TestKdTreeNearest() );
+
+   return std::make_pair( nsucc, nfail );
+}
@@ -0,0 +1,21 @@
+//=============================================================================
+// test_kdtree.h
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#ifndef TEST_KDTREE_H
+#define TEST_KDTREE_H
+
+#include <utility>
+
+//-----------------------------------------------------------------------------
+std::pair<int,int> test_KdTree();
+
+//=============================================================================
+#endif  // TEST_KDTREE_H
@@ -0,0 +1,105 @@
+//=============================================================================
+// test_leave_one_out.cpp
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#include <cmath>
+#include <utility>
+
+#include "test_leave_one_out.h"
+#include "test_helpers.h"
+#include "unit_test.h"
+#include "..\src\engine.h"
+#include "..\src\leave_one_out.h"
+
+//-----------------------------------------------------------------------------
+// Hide all of the testing details inside an unnamed namespace. This allows me
+// to create many small unit tests with polluting the global namespace.
+//-----------------------------------------------------------------------------
+namespace{
+
+   //--------------------------------------------------------------------------
+   // TestLeaveOneOut
+   //
+   //    The Sherman-Morrison downdates must match brute force refits without
+   //    each observation in turn.
+   //--------------------------------------------------------------------------
+   bool TestLeaveOneOut()
+   {
+      const double xo = 2250;
+      const double yo = -2250;
+      const double conductivity = 10;
+      const double thickness = 105;
+
+      std::vector<ObsRecord> obs = GridObservations();
+
+      std::vector<WellRecord> wells = {
+         WellRecord{"12345",2250,-2250,0.25,750}
+      };
+
+      const int M = obs.size();
+      const int n = QUADRATIC_TERMS;
+
+      Matrix X, Vinv, Y;
+      std::tie(X, Vinv, Y) = SetupQuadraticModel(xo, yo, conductivity, thickness, obs, wells);
+
+      Matrix P_ev, P_cov;
+      std::tie(P_ev, P_cov) = FitQuadraticModel(X, Vinv, Y);
+
+      std::vector<double> rows(X.begin(), X.end());
+      std::vector<double> w(M), y(M);
+      for (int m = 0; m < M; ++m) {
+         w[m] = Vinv(m,m);
+         y[m] = Y(m,0);
+      }
+
+      std::vector<LooRecord> records = LeaveOneOut(P_ev, P_cov, rows, w, y, 4);
+
+      double r_ev, r_sd, m_ev, m_sd, d_ev, d_sd;
+      std::tie(r_ev, r_sd, m_ev, m_sd, d_ev, d_sd) = ComputeGeohydrologyStatistics(P_ev, P_cov);
+
+      bool flag = true;
+      for (int m = 0; m < M; ++m) {
+         std::vector<ObsRecord> others(obs);
+         others.erase(others.begin() + m);
+
+         Matrix Xm, Vinvm, Ym;
+         std::tie(Xm, Vinvm, Ym) = SetupQuadraticModel(xo, yo, conductivity, thickness, others, wells);
+
+         Matrix Q_ev, Q_cov;
+         std::tie(Q_ev, Q_cov) = FitQuadraticModel(Xm, Vinvm, Ym);
+
+         double prediction = 0.0;
+         for (int i = 0; i < n; ++i)
+            prediction += X(m,i) * Q_ev(i,0);
+
+         double lr_ev, lr_sd, lm_ev, lm_sd, ld_ev, ld_sd;
+         std::tie(lr_ev, lr_sd, lm_ev, lm_sd, ld_ev, ld_sd) = ComputeGeohydrologyStatistics(Q_ev, Q_cov);
+
+         flag &= CHECK( isCloseRel(records[m].loo_residual, y[m] - prediction) );
+         flag &= CHECK( isCloseRel(records[m].d_recharge  / r_sd, (lr_ev - r_ev) / r_sd) );
+         flag &= CHECK( isCloseRel(records[m].d_magnitude / m_sd, (lm_ev - m_ev) / m_sd) );
+         flag &= CHECK( isCloseRel(records[m].d_direction / d_sd, (ld_ev - d_ev) / d_sd) );
+      }
+      return flag;
+   }
+}
+
+//-----------------------------------------------------------------------------
+// test_LeaveOneOut
+//-----------------------------------------------------------------------------
+std::pair<int,int> test_LeaveOneOut()
+{
+   int nsucc = 0;
+   int nfail = 0;
+
+   TALLY( TestLeaveOneOut() );
+
+   return std::make_pair( nsucc, nfail );
+}
@@ -0,0 +1,21 @@
+//=============================================================================
+// test_leave_one_out.h
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#ifndef TEST_LEAVE_ONE_OUT_H
+#define TEST_LEAVE_ONE_OUT_H
+
+#include <utility>
+
+//-----------------------------------------------------------------------------
+std::pair<int,int> test_LeaveOneOut();
+
+//=============================================================================
+#endif  // TEST_LEAVE_ONE_OUT_H
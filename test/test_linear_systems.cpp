@@ -9,6 +9,7 @@
 // version:
 //    2 July 2017
 //=============================================================================
+#include <cmath>
 #include <utility>
 
 #include "test_linear_systems.h"
@@ -71,6 +72,137 @@ namespace{
       return CHECK( isClose(Ainv, C, TOLERANCE) );
    }
 
+   //--------------------------------------------------------------------------
+   // TestCholeskyFactor
+   //
+   //    A system large enough to need several blocks.
+   //--------------------------------------------------------------------------
+   bool TestCholeskyFactor()
+   {
+      const int N = 200;
+      Matrix G(N, N);
+      for (int i = 0; i < N; ++i)
+         for (int j = 0; j < N; ++j)
+            G(i,j) = ((i*31 + j*17) % 23) / 23.0 - 0.5;
+
+      Matrix A;
+      Multiply_MMt(G, G, A);
+      for (int i = 0; i < N; ++i)
+         A(i,i) += 1.0;
+
+      Matrix L1(A), L4(A);
+      bool flag = true;
+      flag &= CHECK( CholeskyFactor(L1, 1) );
+      flag &= CHECK( CholeskyFactor(L4, 4) );
+      flag &= CHECK( isClose(L1, L4, 0.0) );
+
+      Matrix LLt;
+      Multiply_MMt(L1, L1, LLt);
+      flag &= CHECK( isClose(LLt, A, TOLERANCE) );
+
+      // Solve A X = B for more right hand sides than one chunk.
+      Matrix B(N, 70);
+      for (int i = 0; i < N; ++i)
+         for (int p = 0; p < 70; ++p)
+            B(i,p) = std::sin(0.1*i + 0.7*p);
+
+      Matrix X(B);
+      TriangularSolve(L1, X, false, 4);
+      TriangularSolve(L1, X, true, 4);
+
+      Matrix AX;
+      Multiply_MM(A, X, AX);
+      flag &= CHECK( isClose(AX, B, TOLERANCE) );
+
+      // The wrappers agree with the blocked routines.
+      Matrix L, x, b(N, 1);
+      for (int i = 0; i < N; ++i)
+         b(i,0) = B(i,3);
+      flag &= CHECK( CholeskyDecomposition(A, L) );
+      flag &= CHECK( isClose(L, L1, 0.0) );
+      CholeskySolve(L, b, x);
+      for (int i = 0; i < N; ++i)
+         flag &= CHECK( std::fabs(x(i,0) - X(i,3)) <= TOLERANCE );
+      return flag;
+   }
+
+   //--------------------------------------------------------------------------
+   // TestCholeskyUpdate
+   //--------------------------------------------------------------------------
+   bool TestCholeskyUpdate()
+   {
+      Matrix A("4,6,4,4; 6,10,9,7; 4,9,17,11; 4,7,11,18");
+      Matrix x("1; -2; 0.5; 3");
+
+      Matrix xxt, B;
+      Multiply_MMt(x, x, xxt);
+      Add_MM(A, xxt, B);
+
+      Matrix L, M;
+      CholeskyDecomposition(A, L);
+      CholeskyDecomposition(B, M);
+
+      Matrix U(L);
+      CholeskyUpdate(U, x);
+
+      Matrix D(U);
+      bool flag = true;
+      flag &= CHECK( isClose(U, M, TOLERANCE) );
+      flag &= CHECK( CholeskyDowndate(D, x) );
+      flag &= CHECK( isClose(D, L, TOLERANCE) );
+      return flag;
+   }
+
+   //--------------------------------------------------------------------------
+   // TestCholeskyDowndateFails
+   //--------------------------------------------------------------------------
+   bool TestCholeskyDowndateFails()
+   {
+      Matrix A("4,6,4,4; 6,10,9,7; 4,9,17,11; 4,7,11,18");
+      Matrix x("2; 3; 2; 2");          // the first column of L, so A - xx' is singular
+
+      Matrix L;
+      CholeskyDecomposition(A, L);
+
+      Matrix D(L);
+      bool flag = true;
+      flag &= CHECK( !CholeskyDowndate(D, x) );
+      flag &= CHECK( isClose(D, L, 0.0) );
+      return flag;
+   }
+
+   //--------------------------------------------------------------------------
+   // TestCholeskyUpdateBatch
+   //--------------------------------------------------------------------------
+   bool TestCholeskyUpdateBatch()
+   {
+      Matrix A("4,6,4,4; 6,10,9,7; 4,9,17,11; 4,7,11,18");
+      Matrix X("1,0,2; -2,1,0; 0.5,1,-1; 3,0,1");
+
+      Matrix L;
+      CholeskyDecomposition(A, L);
+
+      // One column at a time.
+      Matrix S(L);
+      for (int p = 0; p < X.nCols(); ++p) {
+         Matrix x(X.nRows(), 1);
+         for (int i = 0; i < X.nRows(); ++i)
+            x(i,0) = X(i,p);
+         CholeskyUpdate(S, x);
+      }
+
+      Matrix U(L);
+      CholeskyUpdateBatch(U, X);
+
+      Matrix D(U);
+      bool flag = true;
+      flag &= CHECK( isClose(U, S, TOLERANCE) );
+      flag &= CHECK( CholeskyDowndateBatch(D, X) );
+      flag &= CHECK( isClose(D, L, TOLERANCE) );
+      flag &= CHECK( !CholeskyDowndateBatch(L, U) );
+      return flag;
+   }
+
    //--------------------------------------------------------------------------
    // TestRSPDInv
    //--------------------------------------------------------------------------
@@ -99,6 +231,46 @@ namespace{
       return CHECK( isClose(X, C, TOLERANCE) );
    }
 
+   //--------------------------------------------------------------------------
+   // TestTsqrSolve
+   //--------------------------------------------------------------------------
+   bool TestTsqrSolve()
+   {
+      Matrix A("5,2,8,1; 4,6,5,5; 7,1,1,3; 2,6,1,1; 4,6,7,4; 8,6,4,2; 5,8,7,1; 7,8,2,2; 6,7,5,2; 5,5,6,2");
+      Matrix B("1,7,1; 6,7,2; 3,3,2; 5,2,5; 6,5,5; 4,6,1; 5,4,8; 4,2,6; 1,8,6; 4,1,1");
+      Matrix X;
+      Matrix C("-0.122286918422277,0.266063484829536,-0.0575443373772838; 0.464217553042304,-0.0279214573318259,0.846505417553293; -0.00883317831785533,0.470311201138176,-0.027798955351842; 0.836316520297104,0.470195843209534,-0.259472798611811");
+
+      bool flag = true;
+      flag &= CHECK( TsqrSolve(A,B,X,1) );
+      flag &= CHECK( isClose(X, C, TOLERANCE) );
+
+      // A tall system, with many row blocks to merge.
+      const int M = 5000;
+      Matrix T(M, 4);
+      Matrix b(M, 1);
+      for (int i = 0; i < M; ++i) {
+         T(i,0) = 1.0;
+         T(i,1) = (i % 97) / 97.0;
+         T(i,2) = (i % 89) / 89.0;
+         T(i,3) = T(i,1) * T(i,2);
+         b(i,0) = 3 - 2*T(i,1) + T(i,2) + 0.5*T(i,3) + 0.01*((i*7) % 13 - 6);
+      }
+
+      Matrix X1, X4, G;
+      flag &= CHECK( LeastSquaresSolve(T, b, G) );
+      flag &= CHECK( TsqrSolve(T, b, X1, 1) );
+      flag &= CHECK( TsqrSolve(T, b, X4, 4) );
+      flag &= CHECK( isClose(X1, G, TOLERANCE) );
+      flag &= CHECK( isClose(X4, G, TOLERANCE) );
+
+      // A rank deficient system.
+      for (int i = 0; i < M; ++i)
+         T(i,3) = T(i,1) + T(i,2);
+      flag &= CHECK( !TsqrSolve(T, b, X1, 4) );
+      return flag;
+   }
+
    //--------------------------------------------------------------------------
    // TestAffineTransformation
    //--------------------------------------------------------------------------
@@ -127,8 +299,13 @@ std::pair<int,int> test_LinearSystems()
    TALLY( TestCholeskyDecomposition() );
    TALLY( TestCholeskySolve() );
    TALLY( TestCholeskyInverse() );
+   TALLY( TestCholeskyFactor() );
+   TALLY( TestCholeskyUpdate() );
+   TALLY( TestCholeskyDowndateFails() );
+   TALLY( TestCholeskyUpdateBatch() );
    TALLY( TestRSPDInv() );
    TALLY( TestLeastSquaresSolve() );
+   TALLY( TestTsqrSolve() );
    TALLY( TestAffineTransformation() );
 
    return std::make_pair( nsucc, nfail );
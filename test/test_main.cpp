@@ -11,10 +11,28 @@
 //=============================================================================
 #include <iostream>
 
+#include "test_adaptive_engine.h"
+#include "test_binary_data.h"
+#include "test_bootstrap.h"
+#include "test_correlated_errors.h"
 #include "test_engine.h"
+#include "test_kdtree.h"
+#include "test_leave_one_out.h"
 #include "test_linear_systems.h"
 #include "test_matrix.h"
+#include "test_nested_models.h"
+#include "test_network_design.h"
+#include "test_options.h"
+#include "test_polynomial_engine.h"
+#include "test_preprocess.h"
+#include "test_qmc_engine.h"
+#include "test_quadrature.h"
+#include "test_scenario_engine.h"
+#include "test_snapshot_engine.h"
 #include "test_special_functions.h"
+#include "test_streaming_engine.h"
+#include "test_surrogate.h"
+#include "test_write_results.h"
 
 //-----------------------------------------------------------------------------
 //
@@ -26,10 +44,34 @@ int main()
 
    std::pair<int,int> counts;
 
+   counts = test_AdaptiveEngine();
+   nsucc += counts.first;
+   nfail += counts.second;
+
+   counts = test_BinaryData();
+   nsucc += counts.first;
+   nfail += counts.second;
+
+   counts = test_Bootstrap();
+   nsucc += counts.first;
+   nfail += counts.second;
+
+   counts = test_CorrelatedErrors();
+   nsucc += counts.first;
+   nfail += counts.second;
+
    counts = test_Engine();
    nsucc += counts.first;
    nfail += counts.second;
 
+   counts = test_KdTree();
+   nsucc += counts.first;
+   nfail += counts.second;
+
+   counts = test_LeaveOneOut();
+   nsucc += counts.first;
+   nfail += counts.second;
+
    counts = test_LinearSystems();
    nsucc += counts.first;
    nfail += counts.second;
@@ -38,10 +80,58 @@ int main()
    nsucc += counts.first;
    nfail += counts.second;
 
+   counts = test_NestedModels();
+   nsucc += counts.first;
+   nfail += counts.second;
+
+   counts = test_NetworkDesign();
+   nsucc += counts.first;
+   nfail += counts.second;
+
+   counts = test_Options();
+   nsucc += counts.first;
+   nfail += counts.second;
+
+   counts = test_PolynomialEngine();
+   nsucc += counts.first;
+   nfail += counts.second;
+
+   counts = test_Preprocess();
+   nsucc += counts.first;
+   nfail += counts.second;
+
+   counts = test_QmcEngine();
+   nsucc += counts.first;
+   nfail += counts.second;
+
+   counts = test_Quadrature();
+   nsucc += counts.first;
+   nfail += counts.second;
+
+   counts = test_ScenarioEngine();
+   nsucc += counts.first;
+   nfail += counts.second;
+
+   counts = test_SnapshotEngine();
+   nsucc += counts.first;
+   nfail += counts.second;
+
    counts = test_SpecialFunctions();
    nsucc += counts.first;
    nfail += counts.second;
 
+   counts = test_StreamingEngine();
+   nsucc += counts.first;
+   nfail += counts.second;
+
+   counts = test_Surrogate();
+   nsucc += counts.first;
+   nfail += counts.second;
+
+   counts = test_WriteResults();
+   nsucc += counts.first;
+   nfail += counts.second;
+
    if (nfail > 0)
       std::cerr << "GIMIWAN TESTS: nsucc = " << nsucc << '\t' << "nfail = " << nfail << std::endl;
    else
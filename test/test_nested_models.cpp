@@ -0,0 +1,138 @@
+//=============================================================================
+// test_nested_models.cpp
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "test_nested_models.h"
+#include "test_helpers.h"
+#include "unit_test.h"
+#include "..\src\engine.h"
+#include "..\src\nested_models.h"
+#include "..\src\numerical_constants.h"
+
+//-----------------------------------------------------------------------------
+// Hide all of the testing details inside an unnamed namespace. This allows me
+// to create many small unit tests with polluting the global namespace.
+//-----------------------------------------------------------------------------
+namespace{
+   const double TOLERANCE = 1e-9;
+
+   //--------------------------------------------------------------------------
+   // A separate fit of the model of the given order, with its WRSS.
+   //--------------------------------------------------------------------------
+   template <int ORDER>
+   std::pair<CellResult, double> SeparateFit(
+      const std::vector<double>& dx, const std::vector<double>& dy,
+      const std::vector<double>& w, const std::vector<double>& y )
+   {
+      const int n = PolynomialModel<ORDER>::TERMS;
+      const int M = w.size();
+
+      std::vector<double> rows(M*n);
+      PolynomialEquations<ORDER> equations;
+      for (int m = 0; m < M; ++m) {
+         PolynomialModel<ORDER>::Basis(dx[m], dy[m], &rows[m*n]);
+         equations.Add(&rows[m*n], w[m], y[m]);
+      }
+
+      Matrix XtWX, XtWY;
+      equations.Assemble(XtWX, XtWY);
+
+      Matrix P_ev, P_cov;
+      std::tie(P_ev, P_cov) = SolveNormalEquations(XtWX, XtWY);
+
+      double wrss = 0.0;
+      for (int m = 0; m < M; ++m) {
+         double r = y[m];
+         for (int t = 0; t < n; ++t)
+            r -= rows[m*n + t] * P_ev(t,0);
+         wrss += w[m] * r * r;
+      }
+      return std::make_pair(ComputePolynomialCellResult(ORDER, P_ev, P_cov), wrss);
+   }
+
+   //--------------------------------------------------------------------------
+   bool CheckFit( const NestedFit& fit, const std::pair<CellResult, double>& expected, double yWy )
+   {
+      // The WRSS is y'Wy - z'z, so its error is relative to y'Wy.
+      bool flag = true;
+      flag &= CHECK( std::fabs(fit.wrss - expected.second) <= 1e-3 * TOLERANCE * yWy );
+      flag &= CHECK( isCloseRel(fit.cell.r_ev, expected.first.r_ev) );
+      flag &= CHECK( isCloseRel(fit.cell.r_sd, expected.first.r_sd) );
+      flag &= CHECK( isCloseRel(fit.cell.m_ev, expected.first.m_ev) );
+      flag &= CHECK( isCloseRel(fit.cell.m_sd, expected.first.m_sd) );
+      flag &= CHECK( isCloseRel(fit.cell.d_ev, expected.first.d_ev) );
+      flag &= CHECK( isCloseRel(fit.cell.d_sd, expected.first.d_sd) );
+      return flag;
+   }
+
+   //--------------------------------------------------------------------------
+   // TestFitNestedModels
+   //
+   //    Each nested model, taken from the shared cubic factorization, must
+   //    match a separate fit of that model, and the information criteria
+   //    must follow from the WRSS and the number of terms.
+   //--------------------------------------------------------------------------
+   bool TestFitNestedModels()
+   {
+      const int M = 30;
+
+      std::vector<double> dx(M), dy(M), w(M), y(M), rows(M*NESTED_TERMS);
+      double yWy = 0.0;
+      for (int m = 0; m < M; ++m) {
+         dx[m] = 100.0*(m % 6) - 250;
+         dy[m] = 120.0*(m / 6) - 240 + 7*(m % 4);
+         w[m] = 1.0/(0.5 + 0.05*m);
+         y[m] = 1000 - 1e-4*(dx[m]*dx[m] + dy[m]*dy[m]) + 1e-7*dx[m]*dx[m]*dy[m]
+              + 0.2*dx[m] - 0.1*dy[m] + 0.3*((m*7) % 5);
+         NestedBasis(dx[m], dy[m], &rows[m*NESTED_TERMS]);
+         yWy += w[m] * y[m] * y[m];
+      }
+
+      const double log_head_sd = -4.25;
+      std::vector<NestedFit> fits = FitNestedModels(rows, w, y, log_head_sd);
+
+      bool flag = CHECK( fits.size() == 3 );
+      if (!flag)
+         return flag;
+
+      flag &= CHECK( fits[0].order == 1 && fits[1].order == 2 && fits[2].order == 3 );
+      flag &= CheckFit( fits[0], SeparateFit<1>(dx, dy, w, y), yWy );
+      flag &= CheckFit( fits[1], SeparateFit<2>(dx, dy, w, y), yWy );
+      flag &= CheckFit( fits[2], SeparateFit<3>(dx, dy, w, y), yWy );
+
+      // Each larger model fits at least as well, and the penalties differ by
+      // 2 and log(M) per term.
+      flag &= CHECK( fits[0].wrss >= fits[1].wrss && fits[1].wrss >= fits[2].wrss );
+      flag &= CHECK( isCloseRel((fits[1].aic - fits[1].wrss) - (fits[0].aic - fits[0].wrss), 6.0) );
+      flag &= CHECK( isCloseRel((fits[2].bic - fits[2].wrss) - (fits[1].bic - fits[1].wrss), 4*std::log(double(M))) );
+
+      // AIC = -2 log L + 2p, with the log-likelihood of the heads.
+      const double minus_2_loglik = fits[1].wrss + M*std::log(TWO_PI) + 2*log_head_sd;
+      flag &= CHECK( isCloseRel(fits[1].aic, minus_2_loglik + 2*fits[1].terms) );
+      return flag;
+   }
+}
+
+//-----------------------------------------------------------------------------
+// test_NestedModels
+//-----------------------------------------------------------------------------
+std::pair<int,int> test_NestedModels()
+{
+   int nsucc = 0;
+   int nfail = 0;
+
+   TALLY( TestFitNestedModels() );
+
+   return std::make_pair( nsucc, nfail );
+}
@@ -0,0 +1,21 @@
+//=============================================================================
+// test_nested_models.h
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#ifndef TEST_NESTED_MODELS_H
+#define TEST_NESTED_MODELS_H
+
+#include <utility>
+
+//-----------------------------------------------------------------------------
+std::pair<int,int> test_NestedModels();
+
+//=============================================================================
+#endif  // TEST_NESTED_MODELS_H
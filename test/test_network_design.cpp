@@ -0,0 +1,178 @@
+//=============================================================================
+// test_network_design.cpp
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#include <cmath>
+#include <utility>
+
+#include "test_network_design.h"
+#include "test_helpers.h"
+#include "unit_test.h"
+#include "..\src\engine.h"
+#include "..\src\linear_systems.h"
+#include "..\src\network_design.h"
+#include "..\src\normal_equations.h"
+
+//-----------------------------------------------------------------------------
+// Hide all of the testing details inside an unnamed namespace. This allows me
+// to create many small unit tests with polluting the global namespace.
+//-----------------------------------------------------------------------------
+namespace{
+
+   //--------------------------------------------------------------------------
+   // A 4 x 4 grid of observations about the origin, and the fit.
+   //--------------------------------------------------------------------------
+   void MakeSystem( std::vector<double>& rows, std::vector<double>& w, Matrix& XtWX, Matrix& P_ev ) {
+      NormalEquations equations;
+      for (int i = 0; i < 4; ++i) {
+         for (int j = 0; j < 4; ++j) {
+            double dx = 300.0*(i - 1.5) + 17*j;
+            double dy = 300.0*(j - 1.5) - 11*i;
+            double row[QUADRATIC_TERMS];
+            QuadraticBasis(dx, dy, row);
+            rows.insert(rows.end(), row, row + QUADRATIC_TERMS);
+
+            w.push_back( 1.0/(1.0 + 0.2*i + 0.1*j) );
+            equations.Add(row, w.back(), -1e-4*(dx*dx + dy*dy) + 0.3*dx - 0.2*dy + 1000 + 0.5*((i*j) % 3));
+         }
+      }
+
+      Matrix XtWY, P_cov;
+      equations.Assemble(XtWX, XtWY);
+      std::tie(P_ev, P_cov) = SolveNormalEquations(XtWX, XtWY);
+   }
+
+   //--------------------------------------------------------------------------
+   // The descriptor standard deviations after adding "sign" w xx' to XtWX.
+   //--------------------------------------------------------------------------
+   void Refit( const Matrix& P_ev, Matrix& XtWX, const double* x, double w, double sign, double sd[3] ) {
+      for (int i = 0; i < QUADRATIC_TERMS; ++i)
+         for (int j = 0; j < QUADRATIC_TERMS; ++j)
+            XtWX(i,j) += sign * w * x[i] * x[j];
+
+      Matrix L, P_cov;
+      CholeskyDecomposition(XtWX, L);
+      CholeskyInverse(L, P_cov);
+
+      double r_ev, m_ev, d_ev;
+      std::tie(r_ev, sd[0], m_ev, sd[1], d_ev, sd[2]) = ComputeGeohydrologyStatistics(P_ev, P_cov);
+   }
+
+   //--------------------------------------------------------------------------
+   // TestSelectSites
+   //
+   //    Each greedy selection must match a refit with the selected sites
+   //    added, and the first selection must be the best single site.
+   //--------------------------------------------------------------------------
+   bool TestSelectSites()
+   {
+      std::vector<double> rows, w;
+      Matrix XtWX, P_ev;
+      MakeSystem(rows, w, XtWX, P_ev);
+
+      std::vector<double> c_rows, c_w;
+      for (int c = 0; c < 50; ++c) {
+         double row[QUADRATIC_TERMS];
+         QuadraticBasis(40.0*c - 1000, 1000.0 - 35.0*c + 3*(c % 7), row);
+         c_rows.insert(c_rows.end(), row, row + QUADRATIC_TERMS);
+         c_w.push_back( (c % 10 == 3) ? 0.0 : 0.5 + 0.01*c );
+      }
+
+      std::vector<DesignRecord> one  = SelectSites(P_ev, XtWX, c_rows, c_w, 3, 1);
+      std::vector<DesignRecord> four = SelectSites(P_ev, XtWX, c_rows, c_w, 3, 4);
+
+      bool flag = true;
+      flag &= CHECK( one.size() == 3 );
+      for (int r = 0; r < 3; ++r) {
+         flag &= CHECK( one[r].index == four[r].index );
+         flag &= CHECK( c_w[one[r].index] > 0 );
+      }
+
+      // The sequential refits.
+      Matrix A = XtWX;
+      for (int r = 0; r < 3; ++r) {
+         double sd[3];
+         Refit(P_ev, A, &c_rows[one[r].index*QUADRATIC_TERMS], c_w[one[r].index], +1.0, sd);
+         flag &= CHECK( isCloseRel(one[r].r_sd, sd[0]) );
+         flag &= CHECK( isCloseRel(one[r].m_sd, sd[1]) );
+         flag &= CHECK( isCloseRel(one[r].d_sd, sd[2]) );
+      }
+
+      // No single site does better than the first selection.
+      for (int c = 0; c < 50; ++c) {
+         std::vector<double> single(c_rows.begin() + c*QUADRATIC_TERMS, c_rows.begin() + (c+1)*QUADRATIC_TERMS);
+         std::vector<DesignRecord> best = SelectSites(P_ev, XtWX, single, std::vector<double>(1, c_w[c]), 1, 1);
+         if (!best.empty())
+            flag &= CHECK( best[0].score <= one[0].score );
+      }
+      return flag;
+   }
+
+   //--------------------------------------------------------------------------
+   // TestRankRetirements
+   //
+   //    Each retirement must match a refit without the observation, and the
+   //    ranking must run from the least to the most loss.
+   //--------------------------------------------------------------------------
+   bool TestRankRetirements()
+   {
+      std::vector<double> rows, w;
+      Matrix XtWX, P_ev;
+      MakeSystem(rows, w, XtWX, P_ev);
+
+      std::vector<DesignRecord> records = RankRetirements(P_ev, XtWX, rows, w, 4);
+
+      bool flag = true;
+      flag &= CHECK( records.size() == w.size() );
+      for (size_t r = 0; r < records.size(); ++r) {
+         if (r > 0)
+            flag &= CHECK( records[r-1].score <= records[r].score );
+
+         Matrix A = XtWX;
+         double sd[3];
+         Refit(P_ev, A, &rows[records[r].index*QUADRATIC_TERMS], w[records[r].index], -1.0, sd);
+         flag &= CHECK( isCloseRel(records[r].r_sd, sd[0]) );
+         flag &= CHECK( isCloseRel(records[r].m_sd, sd[1]) );
+         flag &= CHECK( isCloseRel(records[r].d_sd, sd[2]) );
+      }
+
+      // With only six observations, none can be retired.
+      const double corners[6][2] = { {0,0}, {1,0}, {2,0}, {0,1}, {1,1}, {0,2} };
+      std::vector<double> six_rows(6*QUADRATIC_TERMS);
+      std::vector<double> six_w(6, 1.0);
+      NormalEquations equations;
+      for (int m = 0; m < 6; ++m) {
+         QuadraticBasis(300*corners[m][0] - 250, 300*corners[m][1] - 250, &six_rows[m*QUADRATIC_TERMS]);
+         equations.Add(&six_rows[m*QUADRATIC_TERMS], six_w[m], 0.0);
+      }
+
+      Matrix XtWX6, XtWY6;
+      equations.Assemble(XtWX6, XtWY6);
+
+      std::vector<DesignRecord> six = RankRetirements(P_ev, XtWX6, six_rows, six_w, 1);
+      for (const DesignRecord& record : six)
+         flag &= CHECK( std::isinf(record.score) );
+      return flag;
+   }
+}
+
+//-----------------------------------------------------------------------------
+// test_NetworkDesign
+//-----------------------------------------------------------------------------
+std::pair<int,int> test_NetworkDesign()
+{
+   int nsucc = 0;
+   int nfail = 0;
+
+   TALLY( TestSelectSites() );
+   TALLY( TestRankRetirements() );
+
+   return std::make_pair( nsucc, nfail );
+}
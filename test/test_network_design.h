@@ -0,0 +1,21 @@
+//=============================================================================
+// test_network_design.h
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#ifndef TEST_NETWORK_DESIGN_H
+#define TEST_NETWORK_DESIGN_H
+
+#include <utility>
+
+//-----------------------------------------------------------------------------
+std::pair<int,int> test_NetworkDesign();
+
+//=============================================================================
+#endif  // TEST_NETWORK_DESIGN_H
@@ -0,0 +1,70 @@
+//=============================================================================
+// test_options.cpp
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "test_options.h"
+#include "unit_test.h"
+#include "..\src\options.h"
+
+//-----------------------------------------------------------------------------
+// Hide all of the testing details inside an unnamed namespace. This allows me
+// to create many small unit tests with polluting the global namespace.
+//-----------------------------------------------------------------------------
+namespace{
+   // True if ParseOptions throws InvalidOption for the given arguments.
+   bool isRejected( std::vector<std::string> args ) {
+      std::vector<char*> argv;
+      for (std::string& arg : args)
+         argv.push_back(&arg[0]);
+
+      Options options;
+      try {
+         ParseOptions(static_cast<int>(argv.size()), argv.data(), options);
+      }
+      catch (InvalidOption&) {
+         return true;
+      }
+      return false;
+   }
+
+   //--------------------------------------------------------------------------
+   // TestFactorsWithMerging
+   //
+   //    --aggregate and --thin merge observations, so the IDs in a factor
+   //    file would no longer name them.
+   //--------------------------------------------------------------------------
+   bool TestFactorsWithMerging()
+   {
+      bool flag = true;
+      flag &= CHECK( !isRejected({"gimiwan", "--factors=f.csv"}) );
+      flag &= CHECK( !isRejected({"gimiwan", "--aggregate"}) );
+      flag &= CHECK( isRejected({"gimiwan", "--factors=f.csv", "--aggregate"}) );
+      flag &= CHECK( isRejected({"gimiwan", "--aggregate=5", "--factors=f.csv"}) );
+      flag &= CHECK( isRejected({"gimiwan", "--factors=f.csv", "--thin=100"}) );
+      return flag;
+   }
+}
+
+//-----------------------------------------------------------------------------
+// test_Options
+//-----------------------------------------------------------------------------
+std::pair<int,int> test_Options()
+{
+   int nsucc = 0;
+   int nfail = 0;
+
+   TALLY( TestFactorsWithMerging() );
+
+   return std::make_pair( nsucc, nfail );
+}
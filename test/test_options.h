@@ -0,0 +1,21 @@
+//=============================================================================
+// test_options.h
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#ifndef TEST_OPTIONS_H
+#define TEST_OPTIONS_H
+
+#include <utility>
+
+//-----------------------------------------------------------------------------
+std::pair<int,int> test_Options();
+
+//=============================================================================
+#endif  // TEST_OPTIONS_H
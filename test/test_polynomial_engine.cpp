@@ -0,0 +1,151 @@
+//=============================================================================
+// test_polynomial_engine.cpp
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "test_polynomial_engine.h"
+#include "test_helpers.h"
+#include "unit_test.h"
+#include "..\src\engine.h"
+#include "..\src\polynomial_engine.h"
+#include "..\src\polynomial_model-inl.h"
+
+//-----------------------------------------------------------------------------
+// Hide all of the testing details inside an unnamed namespace. This allows me
+// to create many small unit tests with polluting the global namespace.
+//-----------------------------------------------------------------------------
+namespace{
+
+   //--------------------------------------------------------------------------
+   // TestPolynomialBasis
+   //
+   //    The quadratic basis must keep the original term order, and the cubic
+   //    basis must put its third degree terms first.
+   //--------------------------------------------------------------------------
+   bool TestPolynomialBasis()
+   {
+      const double dx = 1.5;
+      const double dy = -2.5;
+
+      double quadratic[6];
+      PolynomialModel<2>::Basis(dx, dy, quadratic);
+
+      double cubic[10];
+      PolynomialModel<3>::Basis(dx, dy, cubic);
+
+      const double expected2[6] = {dx*dx, dy*dy, dx*dy, dx, dy, 1};
+      const double expected3[10] = {dx*dx*dx, dy*dy*dy, dx*dx*dy, dx*dy*dy, dx*dx, dy*dy, dx*dy, dx, dy, 1};
+
+      bool flag = true;
+      for (int t = 0; t < 6; ++t)
+         flag &= CHECK( quadratic[t] == expected2[t] );
+      for (int t = 0; t < 10; ++t)
+         flag &= CHECK( isCloseRel(cubic[t], expected3[t]) );
+
+      flag &= CHECK( PolynomialModel<1>::TERMS == 3 && PolynomialModel<1>::XX == -1 && PolynomialModel<1>::X == 0 );
+      flag &= CHECK( PolynomialModel<2>::XX == 0 && PolynomialModel<2>::YY == 1 && PolynomialModel<2>::X == 3 && PolynomialModel<2>::Y == 4 );
+      flag &= CHECK( PolynomialModel<3>::TERMS == 10 && PolynomialModel<3>::XX == 4 && PolynomialModel<3>::Y == 8 );
+      return flag;
+   }
+
+   //--------------------------------------------------------------------------
+   // TestPolynomialEquations
+   //
+   //    A cubic fit to an exact cubic must recover its coefficients.
+   //--------------------------------------------------------------------------
+   bool TestPolynomialEquations()
+   {
+      const double coefficients[10] = {1e-3, -2e-3, 3e-3, 4e-4, 0.05, -0.02, 0.03, 1.5, -0.5, 100};
+
+      PolynomialEquations<3> equations;
+      for (int i = 0; i < 5; ++i) {
+         for (int j = 0; j < 5; ++j) {
+            double row[10];
+            PolynomialModel<3>::Basis(10.0*i - 20 + j, 12.0*j - 25 + 0.5*i*i, row);
+
+            double y = 0.0;
+            for (int t = 0; t < 10; ++t)
+               y += coefficients[t] * row[t];
+            equations.Add(row, 1.0 + 0.1*i, y);
+         }
+      }
+
+      Matrix XtWX, XtWY;
+      equations.Assemble(XtWX, XtWY);
+
+      Matrix P_ev, P_cov;
+      std::tie(P_ev, P_cov) = SolveNormalEquations(XtWX, XtWY);
+
+      bool flag = true;
+      for (int t = 0; t < 10; ++t)
+         flag &= CHECK( std::fabs(P_ev(t,0) - coefficients[t]) <= 1e-7 * std::max(1.0, std::fabs(coefficients[t])) );
+      return flag;
+   }
+
+   //--------------------------------------------------------------------------
+   // TestPolynomialEngine
+   //
+   //    The quadratic PolynomialEngine must match the Engine; the linear
+   //    engine reports no recharge; the cubic engine runs to completion.
+   //--------------------------------------------------------------------------
+   bool TestPolynomialEngine()
+   {
+      const double xo = 2250;
+      const double yo = -2250;
+
+      std::vector<ObsRecord> records = GridObservations();
+      ObsTable obs(records);
+
+      std::vector<WellRecord> wells = {
+         WellRecord{"1",2250,-2250,0.25,750}
+      };
+
+      Results expected = Engine(xo, yo, 2.3, 0.5, 3, 4.6, 0.1, 4, 0.0, obs, wells);
+
+      Results quadratic, linear, cubic;
+      MemoryResultSink quadratic_sink(quadratic), linear_sink(linear), cubic_sink(cubic);
+      PolynomialEngine(2, xo, yo, 2.3, 0.5, 3, 4.6, 0.1, 4, 0.0, obs, wells, 2, quadratic_sink);
+      PolynomialEngine(1, xo, yo, 2.3, 0.5, 3, 4.6, 0.1, 4, 0.0, obs, wells, 2, linear_sink);
+      PolynomialEngine(3, xo, yo, 2.3, 0.5, 3, 4.6, 0.1, 4, 0.0, obs, wells, 2, cubic_sink);
+
+      bool flag = true;
+      flag &= CHECK( isCloseRel(quadratic.R_ev, expected.R_ev) );
+      flag &= CHECK( isCloseRel(quadratic.R_sd, expected.R_sd) );
+      flag &= CHECK( isCloseRel(quadratic.M_ev, expected.M_ev) );
+      flag &= CHECK( isCloseRel(quadratic.M_sd, expected.M_sd) );
+      flag &= CHECK( isCloseRel(quadratic.D_ev, expected.D_ev) );
+      flag &= CHECK( isCloseRel(quadratic.D_sd, expected.D_sd) );
+
+      flag &= CHECK( linear.R_ev(0,0) == 0.0 && linear.R_ev(2,3) == 0.0 );
+      flag &= CHECK( linear.M_ev(1,1) > 0.0 );
+
+      // The cubic terms can only increase the parameter uncertainty.
+      flag &= CHECK( cubic.M_sd(1,1) >= quadratic.M_sd(1,1) );
+      return flag;
+   }
+}
+
+//-----------------------------------------------------------------------------
+// test_PolynomialEngine
+//-----------------------------------------------------------------------------
+std::pair<int,int> test_PolynomialEngine()
+{
+   int nsucc = 0;
+   int nfail = 0;
+
+   TALLY( TestPolynomialBasis() );
+   TALLY( TestPolynomialEquations() );
+   TALLY( TestPolynomialEngine() );
+
+   return std::make_pair( nsucc, nfail );
+}
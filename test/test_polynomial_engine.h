@@ -0,0 +1,21 @@
+//=============================================================================
+// test_polynomial_engine.h
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#ifndef TEST_POLYNOMIAL_ENGINE_H
+#define TEST_POLYNOMIAL_ENGINE_H
+
+#include <utility>
+
+//-----------------------------------------------------------------------------
+std::pair<int,int> test_PolynomialEngine();
+
+//=============================================================================
+#endif  // TEST_POLYNOMIAL_ENGINE_H
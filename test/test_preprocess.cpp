@@ -0,0 +1,112 @@
+//=============================================================================
+// test_preprocess.cpp
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#include <cmath>
+#include <utility>
+
+#include "test_preprocess.h"
+#include "unit_test.h"
+#include "..\src\preprocess.h"
+
+//-----------------------------------------------------------------------------
+// Hide all of the testing details inside an unnamed namespace. This allows me
+// to create many small unit tests with polluting the global namespace.
+//-----------------------------------------------------------------------------
+namespace{
+   const double TOLERANCE = 1e-9;
+
+   //--------------------------------------------------------------------------
+   // TestAggregateColocated
+   //
+   //    Three readings at one well nest, two at another (1 cm apart), and a
+   //    lone observation.
+   //--------------------------------------------------------------------------
+   bool TestAggregateColocated()
+   {
+      std::vector<ObsRecord> records = {
+         ObsRecord{"A1", 100, 200, 50, 1},
+         ObsRecord{"B1", 300, 400, 60, 2},
+         ObsRecord{"A2", 100, 200, 52, 1},
+         ObsRecord{"C1", 500, 600, 70, 1},
+         ObsRecord{"A3", 100, 200, 54, 2},
+         ObsRecord{"B2", 300.01, 400, 62, 2}
+      };
+      ObsTable obs(records);
+
+      bool flag = true;
+
+      // Exact matching: only the A readings are combined.
+      ObsTable exact = AggregateColocated(obs, 0.0);
+      flag &= CHECK( exact.size() == 4 );
+      flag &= CHECK( exact.id(0) == "A1" );
+      flag &= CHECK( std::fabs(exact.head_ev()[0] - (50 + 52 + 54*0.25)/2.25) < TOLERANCE );
+      flag &= CHECK( std::fabs(exact.head_sd()[0] - 1/std::sqrt(2.25)) < TOLERANCE );
+      flag &= CHECK( exact.head_ev()[1] == 60 && exact.head_sd()[1] == 2 );
+
+      // A 1 m tolerance also combines the B readings, at their mean location.
+      ObsTable loose = AggregateColocated(obs, 1.0);
+      flag &= CHECK( loose.size() == 3 );
+      flag &= CHECK( loose.id(1) == "B1" );
+      flag &= CHECK( std::fabs(loose.x()[1] - 300.005) < TOLERANCE );
+      flag &= CHECK( std::fabs(loose.head_ev()[1] - 61) < TOLERANCE );
+      flag &= CHECK( std::fabs(loose.head_sd()[1] - std::sqrt(2.0)) < TOLERANCE );
+      flag &= CHECK( loose.id(2) == "C1" && loose.head_ev()[2] == 70 );
+
+      flag &= CHECK( CountUniqueLocations(obs, AllIndices(obs)) == 4 );
+      flag &= CHECK( CountUniqueLocations(obs, std::vector<int>{0, 2, 4}) == 1 );
+      return flag;
+   }
+
+   //--------------------------------------------------------------------------
+   // TestThinning
+   //
+   //    A 10 x 10 grid of observations at 100 m spacing, thinned to 250 m
+   //    cells.
+   //--------------------------------------------------------------------------
+   bool TestThinning()
+   {
+      std::vector<ObsRecord> records;
+      for (int i = 0; i < 10; ++i)
+         for (int j = 0; j < 10; ++j)
+            records.push_back( ObsRecord{"P", 100.0*i, -100.0*j, 100 + i - 0.5*j, (i+j) % 2 ? 1.0 : 2.0} );
+      ObsTable dense(records);
+
+      bool flag = true;
+
+      // Half of the weights are 1, half are 1/4.
+      flag &= CHECK( std::fabs(EffectiveCount(dense) - 100*(1.25/2)*(1.25/2)/(1.0625/2)) < TOLERANCE );
+
+      ObsTable thinned = AggregateColocated(dense, 250.0);
+      flag &= CHECK( thinned.size() == 20 );
+
+      double change, bound;
+      CovarianceChange(450, -450, 10, 10, dense, dense, change, bound);
+      flag &= CHECK( change == 0 && bound == 0 );
+
+      CovarianceChange(450, -450, 10, 10, dense, thinned, change, bound);
+      flag &= CHECK( change > 0 && change <= bound );
+      return flag;
+   }
+}
+
+//-----------------------------------------------------------------------------
+// test_Preprocess
+//-----------------------------------------------------------------------------
+std::pair<int,int> test_Preprocess()
+{
+   int nsucc = 0;
+   int nfail = 0;
+
+   TALLY( TestAggregateColocated() );
+   TALLY( TestThinning() );
+
+   return std::make_pair( nsucc, nfail );
+}
@@ -0,0 +1,21 @@
+//=============================================================================
+// test_preprocess.h
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#ifndef TEST_PREPROCESS_H
+#define TEST_PREPROCESS_H
+
+#include <utility>
+
+//-----------------------------------------------------------------------------
+std::pair<int,int> test_Preprocess();
+
+//=============================================================================
+#endif  // TEST_PREPROCESS_H
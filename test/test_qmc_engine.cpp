@@ -0,0 +1,215 @@
+//=============================================================================
+// test_qmc_engine.cpp
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include "test_qmc_engine.h"
+#include "test_helpers.h"
+#include "unit_test.h"
+#include "..\src\engine.h"
+#include "..\src\numerical_constants.h"
+#include "..\src\qmc_engine.h"
+
+//-----------------------------------------------------------------------------
+// Hide all of the testing details inside an unnamed namespace. This allows me
+// to create many small unit tests with polluting the global namespace.
+//-----------------------------------------------------------------------------
+namespace{
+
+   //--------------------------------------------------------------------------
+   // Read the summary lines: statistic, samples, mean, standard_error, sd,
+   // within_sd, between_sd.
+   //--------------------------------------------------------------------------
+   std::vector<std::vector<double>> ReadSummary( const std::string& text ) {
+      std::istringstream in(text);
+      std::string line;
+      std::getline(in, line);
+
+      std::vector<std::vector<double>> summary;
+      while (std::getline(in, line)) {
+         std::istringstream fields(line);
+         std::string field;
+         std::getline(fields, field, ',');
+
+         std::vector<double> values;
+         while (std::getline(fields, field, ','))
+            values.push_back(std::stod(field));
+         summary.push_back(values);
+      }
+      return summary;
+   }
+
+   //--------------------------------------------------------------------------
+   // TestScrambledHalton
+   //
+   //    The points are in (0,1), their moments and quartile counts are far
+   //    closer to the uniform than random points would be, and another key
+   //    gives other points.
+   //--------------------------------------------------------------------------
+   bool TestScrambledHalton() {
+      const int S = 1024;
+      ScrambledHalton sequence(4, 17);
+      ScrambledHalton other(4, 18);
+
+      bool flag = true;
+      for (int d = 0; d < 4; ++d) {
+         double sum = 0.0, sum2 = 0.0;
+         int below = 0, differ = 0;
+         for (int i = 0; i < S; ++i) {
+            const double u = sequence(i, d);
+            flag &= CHECK( u > 0.0 && u < 1.0 );
+            sum  += u;
+            sum2 += u*u;
+            below += (u < 0.25);
+            differ += (u != other(i, d));
+         }
+         flag &= CHECK( std::fabs(sum/S - 0.5) < 2e-3 );
+         flag &= CHECK( std::fabs(sum2/S - 1.0/3.0) < 2e-3 );
+         flag &= CHECK( std::abs(below - S/4) <= 4 );
+         flag &= CHECK( differ == S );
+      }
+      return flag;
+   }
+
+   //--------------------------------------------------------------------------
+   // TestQmcEngineFixed
+   //
+   //    With fixed inputs every sample is the median fit: the means are the
+   //    Engine's values, the standard errors and between_sd vanish, and
+   //    the sampling stops after the first batch.
+   //--------------------------------------------------------------------------
+   bool TestQmcEngineFixed() {
+      std::vector<ObsRecord> records;
+      std::vector<WellRecord> wells;
+      MakeProblem(records, wells);
+      ObsTable obs(records);
+
+      const double k_alpha = std::log(10.0), h_alpha = std::log(20.0);
+      Results results = Engine(2000, -2000, k_alpha, 0.0, 1, h_alpha, 0.0, 1, 100.0, obs, wells);
+
+      std::ostringstream samples_out, summary_out;
+      QmcEngine(2000, -2000, k_alpha, 0.0, h_alpha, 0.0, 100.0, 0.0, obs, wells, 0.0, 10000, 0.01, 1, 0, samples_out, summary_out);
+      std::vector<std::vector<double>> summary = ReadSummary(summary_out.str());
+
+      bool flag = true;
+      flag &= CHECK( summary.size() == 3 );
+      flag &= CHECK( summary[0][0] == 256 );
+      flag &= CHECK( isClose(summary[0][1], results.R_ev(0,0), 1e-12) );
+      flag &= CHECK( isClose(summary[0][3], results.R_sd(0,0), 1e-12) );
+      flag &= CHECK( isClose(summary[1][1], results.M_ev(0,0), 1e-12) );
+      flag &= CHECK( isClose(summary[2][3], RAD_TO_DEG*results.D_sd(0,0), 1e-9) );
+      for (int s = 0; s < 3; ++s) {
+         flag &= CHECK( summary[s][2] <= 1e-9 * summary[s][3] );
+         flag &= CHECK( summary[s][5] <= 1e-9 * summary[s][3] );
+      }
+      return flag;
+   }
+
+   //--------------------------------------------------------------------------
+   // TestQmcEngineUncertain
+   //
+   //    With uncertain conductivity, thickness, discharge, and radius, the
+   //    output is the same on any number of threads, the between-sample
+   //    spread is positive, and the standard errors fall below the target.
+   //--------------------------------------------------------------------------
+   bool TestQmcEngineUncertain() {
+      std::vector<ObsRecord> records;
+      std::vector<WellRecord> wells;
+      MakeProblem(records, wells);
+      ObsTable obs(records);
+
+      const double k_alpha = std::log(10.0), h_alpha = std::log(20.0);
+
+      std::ostringstream samples_one, summary_one, samples_four, summary_four;
+      QmcEngine(2000, -2000, k_alpha, 0.3, h_alpha, 0.2, 100.0, 0.2, obs, wells, 0.1, 4096, 0.05, 5, 1, samples_one, summary_one);
+      QmcEngine(2000, -2000, k_alpha, 0.3, h_alpha, 0.2, 100.0, 0.2, obs, wells, 0.1, 4096, 0.05, 5, 4, samples_four, summary_four);
+      std::vector<std::vector<double>> summary = ReadSummary(summary_one.str());
+
+      bool flag = true;
+      flag &= CHECK( samples_one.str() == samples_four.str() );
+      flag &= CHECK( summary_one.str() == summary_four.str() );
+      for (int s = 0; s < 3; ++s) {
+         flag &= CHECK( summary[s][5] > 0.0 );
+         flag &= CHECK( summary[s][2] <= 0.05 * summary[s][3] );
+      }
+      return flag;
+   }
+
+   //--------------------------------------------------------------------------
+   // TestQmcEngineLimits
+   //
+   //    With a well at a corner of the grid and an uncertain radius, the
+   //    sampling never converges, so exactly max_samples are drawn, even
+   //    though that is not a whole number of batches; and a sample is left
+   //    out exactly when its radius leaves fewer than 10 unique locations.
+   //--------------------------------------------------------------------------
+   bool TestQmcEngineLimits() {
+      std::vector<ObsRecord> records;
+      std::vector<WellRecord> wells;
+      MakeProblem(records, wells);
+      wells[0].x = 1500.0;
+      wells[0].y = -2500.0;
+      ObsTable obs(records);
+
+      const int S = 200;
+      std::ostringstream samples_out, summary_out;
+      QmcEngine(2000, -2000, std::log(10.0), 0.3, std::log(20.0), 0.2, 700.0, 0.3, obs, wells, 0.0, S, 0.0, 1, 0, samples_out, summary_out);
+      std::vector<std::vector<double>> summary = ReadSummary(summary_out.str());
+
+      std::istringstream in(samples_out.str());
+      std::string line;
+      std::getline(in, line);
+
+      bool flag = true;
+      int lines = 0, ok = 0, left_out = 0;
+      while (std::getline(in, line)) {
+         std::istringstream fields(line);
+         std::string field;
+         std::vector<double> values;
+         while (std::getline(fields, field, ','))
+            values.push_back(std::stod(field));
+
+         // replicate, index, k, h, radius, q_W1, recharge_ev, ...
+         int count = 0;
+         for (const ObsRecord& ob : records)
+            count += (std::hypot(ob.x - 1500.0, ob.y + 2500.0) >= values[4]);
+
+         flag &= CHECK( std::isnan(values[6]) == (count < 10) );
+         ok       += !std::isnan(values[6]);
+         left_out += (count < 10);
+         ++lines;
+      }
+
+      flag &= CHECK( lines == S );
+      flag &= CHECK( summary[0][0] == ok );
+      flag &= CHECK( ok > 0 && left_out > 0 );
+      return flag;
+   }
+}
+
+//-----------------------------------------------------------------------------
+// test_QmcEngine
+//-----------------------------------------------------------------------------
+std::pair<int,int> test_QmcEngine()
+{
+   int nsucc = 0;
+   int nfail = 0;
+
+   TALLY( TestScrambledHalton() );
+   TALLY( TestQmcEngineFixed() );
+   TALLY( TestQmcEngineUncertain() );
+   TALLY( TestQmcEngineLimits() );
+
+   return std::make_pair( nsucc, nfail );
+}
@@ -0,0 +1,127 @@
+//=============================================================================
+// test_quadrature.cpp
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#include <cmath>
+#include <utility>
+
+#include "test_quadrature.h"
+#include "unit_test.h"
+#include "..\src\engine.h"
+#include "..\src\numerical_constants.h"
+#include "..\src\quadrature.h"
+
+//-----------------------------------------------------------------------------
+// Hide all of the testing details inside an unnamed namespace. This allows me
+// to create many small unit tests with polluting the global namespace.
+//-----------------------------------------------------------------------------
+namespace{
+   const double TOLERANCE = 1e-9;
+
+   //--------------------------------------------------------------------------
+   // TestQuadraturePoints
+   //
+   //    The moments of a lognormal distribution, E[k^r] = exp(r alpha +
+   //    r^2 beta^2/2), against the rule.
+   //--------------------------------------------------------------------------
+   bool TestQuadraturePoints() {
+      const double alpha = 2.0;
+      const double beta  = 0.5;
+
+      std::vector<double> k, w;
+      QuadraturePoints(alpha, beta, 12, k, w);
+
+      bool flag = true;
+      for (int r = 1; r <= 3; ++r) {
+         double sum = 0.0;
+         for (size_t i = 0; i < k.size(); ++i)
+            sum += w[i] * std::pow(k[i], r);
+         const double exact = std::exp(r*alpha + 0.5*r*r*beta*beta);
+         flag &= CHECK( std::fabs(sum - exact) <= TOLERANCE*exact );
+      }
+      return flag;
+   }
+
+   //--------------------------------------------------------------------------
+   // TestQuadratureResultSink
+   //
+   //    Statistics that are linear in ln k and ln h, with a constant
+   //    standard deviation, so that the rule is exact:
+   //
+   //       ev = a + b ln k + c ln h,   sd = s,
+   //
+   //    have mean a + b alpha_k + c alpha_h, within_sd s, and between_sd
+   //    sqrt(b^2 beta_k^2 + c^2 beta_h^2). The directions straddle the
+   //    branch cut at 180 degrees.
+   //--------------------------------------------------------------------------
+   bool TestQuadratureResultSink() {
+      const double k_alpha = 2.0, k_beta = 0.5;
+      const double h_alpha = 3.0, h_beta = 0.2;
+
+      std::vector<double> k, k_weights, h, h_weights;
+      QuadraturePoints(k_alpha, k_beta, 5, k, k_weights);
+      QuadraturePoints(h_alpha, h_beta, 4, h, h_weights);
+
+      Results results;
+      MemoryResultSink memory(results);
+      QuadratureResultSink sink(memory, k_weights, h_weights);
+
+      const double b = 0.3, c = -0.2, s = 0.05;
+
+      sink.Begin(k, h);
+      for (size_t i = 0; i < k.size(); ++i) {
+         std::vector<CellResult> row(h.size());
+         for (size_t j = 0; j < h.size(); ++j) {
+            const double u = b*(std::log(k[i]) - k_alpha) + c*(std::log(h[j]) - h_alpha);
+            row[j].r_ev = 1.0 + u;
+            row[j].r_sd = s;
+            row[j].m_ev = 2.0 + u;
+            row[j].m_sd = s;
+            row[j].d_ev = std::remainder(ONE_PI + u, TWO_PI);
+            row[j].d_sd = s;
+         }
+         sink.Row(i, row);
+      }
+      sink.End();
+
+      const std::vector<QuadratureSummary> summaries = sink.Summaries();
+      const double between = std::sqrt(b*b*k_beta*k_beta + c*c*h_beta*h_beta);
+      const double means[] = { 1.0, 2.0, ONE_PI };
+      const double scales[] = { 1.0, 1.0, RAD_TO_DEG };
+
+      bool flag = CHECK( summaries.size() == 3 );
+      for (int t = 0; t < 3; ++t) {
+         const double mean = std::remainder(summaries[t].mean/scales[t] - means[t], TWO_PI);
+         flag &= CHECK( std::fabs(mean) <= TOLERANCE );
+         flag &= CHECK( std::fabs(summaries[t].within_sd/scales[t] - s) <= TOLERANCE );
+         flag &= CHECK( std::fabs(summaries[t].between_sd/scales[t] - between) <= TOLERANCE );
+         flag &= CHECK( std::fabs(summaries[t].sd/scales[t] - std::sqrt(s*s + between*between)) <= TOLERANCE );
+      }
+
+      // The rows were forwarded.
+      flag &= CHECK( results.R_ev.nRows() == 5 && results.R_ev.nCols() == 4 );
+      flag &= CHECK( std::fabs(results.M_ev(4,3) - (2.0 + b*(std::log(k[4]) - k_alpha) + c*(std::log(h[3]) - h_alpha))) <= TOLERANCE );
+      return flag;
+   }
+}
+
+//-----------------------------------------------------------------------------
+// test_Quadrature
+//-----------------------------------------------------------------------------
+std::pair<int,int> test_Quadrature()
+{
+   int nsucc = 0;
+   int nfail = 0;
+
+   TALLY( TestQuadraturePoints() );
+   TALLY( TestQuadratureResultSink() );
+
+   return std::make_pair( nsucc, nfail );
+}
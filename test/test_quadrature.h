@@ -0,0 +1,21 @@
+//=============================================================================
+// test_quadrature.h
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#ifndef TEST_QUADRATURE_H
+#define TEST_QUADRATURE_H
+
+#include <utility>
+
+//-----------------------------------------------------------------------------
+std::pair<int,int> test_Quadrature();
+
+//=============================================================================
+#endif  // TEST_QUADRATURE_H
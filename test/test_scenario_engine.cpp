@@ -0,0 +1,84 @@
+//=============================================================================
+// test_scenario_engine.cpp
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <utility>
+
+#include "test_scenario_engine.h"
+#include "test_helpers.h"
+#include "unit_test.h"
+#include "..\src\engine.h"
+#include "..\src\scenario_engine.h"
+
+//-----------------------------------------------------------------------------
+// Hide all of the testing details inside an unnamed namespace. This allows me
+// to create many small unit tests with polluting the global namespace.
+//-----------------------------------------------------------------------------
+namespace{
+
+   //--------------------------------------------------------------------------
+   // TestScenarioEngine
+   //
+   //    Every scenario solved against the shared factorization must match a
+   //    separate run of the Engine with that scenario's wells.
+   //--------------------------------------------------------------------------
+   bool TestScenarioEngine()
+   {
+      const double xo = 2250;
+      const double yo = -2250;
+
+      std::vector<ObsRecord> records = GridObservations();
+      ObsTable obs(records);
+
+      std::vector<Scenario> scenarios = {
+         Scenario{"", { WellRecord{"1",2250,-2250,0.25,750} }},
+         Scenario{"two", { WellRecord{"1",2250,-2250,0.25,500}, WellRecord{"2",1800,-1700,0.25,300} }},
+         Scenario{"none", {}}
+      };
+
+      // A zero buffer radius leaves every observation active in every run.
+      std::map<std::string, Results> results;
+      ResultSinkFactory make_sink = [&]( const std::string& name ) {
+         return std::unique_ptr<ResultSink>( new MemoryResultSink(results[name]) );
+      };
+      ScenarioEngine(xo, yo, 2.3, 0.5, 3, 4.6, 0.1, 4, 0.0, obs, scenarios, 2, make_sink);
+
+      bool flag = CHECK( results.size() == scenarios.size() );
+      for (const Scenario& scenario : scenarios) {
+         Results expected = Engine(xo, yo, 2.3, 0.5, 3, 4.6, 0.1, 4, 0.0, obs, scenario.wells);
+         const Results& actual = results[scenario.name];
+
+         flag &= CHECK( isCloseRel(actual.R_ev, expected.R_ev) );
+         flag &= CHECK( isCloseRel(actual.R_sd, expected.R_sd) );
+         flag &= CHECK( isCloseRel(actual.M_ev, expected.M_ev) );
+         flag &= CHECK( isCloseRel(actual.M_sd, expected.M_sd) );
+         flag &= CHECK( isCloseRel(actual.D_ev, expected.D_ev) );
+         flag &= CHECK( isCloseRel(actual.D_sd, expected.D_sd) );
+      }
+      return flag;
+   }
+}
+
+//-----------------------------------------------------------------------------
+// test_ScenarioEngine
+//-----------------------------------------------------------------------------
+std::pair<int,int> test_ScenarioEngine()
+{
+   int nsucc = 0;
+   int nfail = 0;
+
+   TALLY( TestScenarioEngine() );
+
+   return std::make_pair( nsucc, nfail );
+}
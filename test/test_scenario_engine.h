@@ -0,0 +1,21 @@
+//=============================================================================
+// test_scenario_engine.h
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#ifndef TEST_SCENARIO_ENGINE_H
+#define TEST_SCENARIO_ENGINE_H
+
+#include <utility>
+
+//-----------------------------------------------------------------------------
+std::pair<int,int> test_ScenarioEngine();
+
+//=============================================================================
+#endif  // TEST_SCENARIO_ENGINE_H
@@ -0,0 +1,103 @@
+//=============================================================================
+// test_snapshot_engine.cpp
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <utility>
+
+#include "test_snapshot_engine.h"
+#include "test_helpers.h"
+#include "unit_test.h"
+#include "..\src\engine.h"
+#include "..\src\snapshot_engine.h"
+
+//-----------------------------------------------------------------------------
+// Hide all of the testing details inside an unnamed namespace. This allows me
+// to create many small unit tests with polluting the global namespace.
+//-----------------------------------------------------------------------------
+namespace{
+
+   //--------------------------------------------------------------------------
+   // TestSnapshotEngine
+   //
+   //    Every snapshot, whether or not it shares a factorization with
+   //    others, must match a separate run of the Engine on its own
+   //    observations. The heads straddle the thickness set-points, so some
+   //    cells are fit on the confined branch, where snapshots with the same
+   //    head_sd share their weights, and some are not.
+   //--------------------------------------------------------------------------
+   bool TestSnapshotEngine()
+   {
+      const double xo = 2250;
+      const double yo = -2250;
+
+      // Snapshots "a" to "d" share their locations; "e" does not. "c" has
+      // different head_sd values.
+      const std::vector<ObsRecord> grid = GridObservations();
+      std::vector<SnapshotRecord> records;
+      const char* names[] = {"a", "b", "c", "d", "e"};
+      for (int s = 0; s < 5; ++s) {
+         for (int i = 0; i < 4; ++i) {
+            for (int j = 0; j < 4; ++j) {
+               ObsRecord ob = grid[4*i + j];
+               ob.x       += (s == 4 ? 60 : 0);
+               ob.head_ev += 0.7*s*(i-j);
+               ob.head_sd  = (s == 2) ? 1.5+0.1*i : ob.head_sd;
+               records.push_back( SnapshotRecord{names[s], ob} );
+            }
+         }
+      }
+
+      std::vector<Snapshot> snapshots = BuildSnapshots(records);
+
+      bool flag = CHECK( snapshots.size() == 5 );
+      flag &= CHECK( snapshots[0].name == "a" && snapshots[0].obs.size() == 16 );
+
+      std::vector<WellRecord> wells = {
+         WellRecord{"1",2250,-2250,0.25,750}
+      };
+
+      std::map<std::string, Results> results;
+      ResultSinkFactory make_sink = [&]( const std::string& name ) {
+         return std::unique_ptr<ResultSink>( new MemoryResultSink(results[name]) );
+      };
+      SnapshotEngine(xo, yo, 2.3, 0.5, 3, 4.6, 0.1, 4, 0.0, snapshots, wells, 2, make_sink);
+
+      flag &= CHECK( results.size() == snapshots.size() );
+      for (const Snapshot& snapshot : snapshots) {
+         Results expected = Engine(xo, yo, 2.3, 0.5, 3, 4.6, 0.1, 4, 0.0, snapshot.obs, wells);
+         const Results& actual = results[snapshot.name];
+
+         flag &= CHECK( isCloseRel(actual.R_ev, expected.R_ev) );
+         flag &= CHECK( isCloseRel(actual.R_sd, expected.R_sd) );
+         flag &= CHECK( isCloseRel(actual.M_ev, expected.M_ev) );
+         flag &= CHECK( isCloseRel(actual.M_sd, expected.M_sd) );
+         flag &= CHECK( isCloseRel(actual.D_ev, expected.D_ev) );
+         flag &= CHECK( isCloseRel(actual.D_sd, expected.D_sd) );
+      }
+      return flag;
+   }
+}
+
+//-----------------------------------------------------------------------------
+// test_SnapshotEngine
+//-----------------------------------------------------------------------------
+std::pair<int,int> test_SnapshotEngine()
+{
+   int nsucc = 0;
+   int nfail = 0;
+
+   TALLY( TestSnapshotEngine() );
+
+   return std::make_pair( nsucc, nfail );
+}
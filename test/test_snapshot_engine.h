@@ -0,0 +1,21 @@
+//=============================================================================
+// test_snapshot_engine.h
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#ifndef TEST_SNAPSHOT_ENGINE_H
+#define TEST_SNAPSHOT_ENGINE_H
+
+#include <utility>
+
+//-----------------------------------------------------------------------------
+std::pair<int,int> test_SnapshotEngine();
+
+//=============================================================================
+#endif  // TEST_SNAPSHOT_ENGINE_H
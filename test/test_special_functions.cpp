@@ -270,6 +270,50 @@ namespace{
 
       return flag;
    }
+
+   //--------------------------------------------------------------------------
+   // TestGaussHermite
+   //
+   //    The n-point rule must reproduce the moments of the standard normal
+   //    distribution, E[Z^(2m)] = (2m-1)!!, up to degree 2n-1, and the
+   //    three-point rule is known in closed form.
+   //--------------------------------------------------------------------------
+   bool TestGaussHermite()
+   {
+      bool flag = true;
+
+      for (int n = 1; n <= 40; n += 3) {
+         std::vector<double> z, w;
+         GaussHermite(n, z, w);
+
+         for (int i = 1; i < n; ++i)
+            flag &= (z[i-1] < z[i]);
+
+         double moment = 1.0;       // (2m-1)!!
+         for (int m = 0; 2*m <= 2*n-1 && m <= 6; ++m) {
+            double even = 0.0;
+            double odd = 0.0;
+            for (int i = 0; i < n; ++i) {
+               even += w[i] * std::pow(z[i], 2*m);
+               odd  += w[i] * std::pow(z[i], 2*m+1);
+            }
+            flag &= isClose(even, moment, 1e-12*moment);
+            flag &= isClose(odd, 0.0, 1e-12*moment);
+            moment *= 2*m + 1;
+         }
+      }
+
+      std::vector<double> z, w;
+      GaussHermite(3, z, w);
+      flag &= isClose(z[0], -std::sqrt(3.0), 1e-14);
+      flag &= isClose(z[1], 0.0, 1e-14);
+      flag &= isClose(z[2], std::sqrt(3.0), 1e-14);
+      flag &= isClose(w[0], 1.0/6.0, 1e-14);
+      flag &= isClose(w[1], 2.0/3.0, 1e-14);
+      flag &= isClose(w[2], 1.0/6.0, 1e-14);
+
+      return flag;
+   }
 }
 
 //-----------------------------------------------------------------------------
@@ -288,6 +332,7 @@ std::pair<int,int> test_SpecialFunctions()
    TALLY( TestIncompleteGammaInv() );
    TALLY( TestGaussianCDF() );
    TALLY( TestGaussianCDFInv() );
+   TALLY( TestGaussHermite() );
 
    return std::make_pair( nsucc, nfail );
 }
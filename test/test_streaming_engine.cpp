@@ -0,0 +1,126 @@
+//=============================================================================
+// test_streaming_engine.cpp
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <utility>
+
+#include "test_streaming_engine.h"
+#include "test_helpers.h"
+#include "unit_test.h"
+#include "..\src\binary_data.h"
+#include "..\src\engine.h"
+#include "..\src\numerical_constants.h"
+#include "..\src\streaming_engine.h"
+
+//-----------------------------------------------------------------------------
+// Hide all of the testing details inside an unnamed namespace. This allows me
+// to create many small unit tests with polluting the global namespace.
+//-----------------------------------------------------------------------------
+namespace{
+
+   //--------------------------------------------------------------------------
+   // Write the observations as a .csv file, with every digit.
+   //--------------------------------------------------------------------------
+   void WriteObsCsv( const std::string& filename, const std::vector<ObsRecord>& records ) {
+      std::ofstream out(filename);
+      out.precision(17);
+      out << "# id, x, y, head, sd\n";
+      for (const ObsRecord& ob : records)
+         out << ob.id << ", " << ob.x << ", " << ob.y << ", " << ob.head_ev << ", " << ob.head_sd << '\n';
+   }
+
+   //--------------------------------------------------------------------------
+   // TestStreamingEngine
+   //
+   //    Streamed from a .csv file and from a binary file, in chunks smaller
+   //    than, and not dividing, the number of observations, the results must
+   //    match the Engine's. The buffer radius deactivates the four
+   //    observations nearest the well, and the thicknesses put the
+   //    observations on both branches.
+   //--------------------------------------------------------------------------
+   bool TestStreamingEngine() {
+      std::vector<ObsRecord> records;
+      std::vector<WellRecord> wells;
+      MakeProblem(records, wells);
+      ObsTable obs(records);
+
+      const double h_alpha = std::log(100.0);
+      Results expected = Engine(2000, -2000, 2.3, 0.5, 3, h_alpha, 0.05, 4, 150.0, obs, wells);
+
+      const std::string csvfilename = "test_streaming_engine.csv";
+      const std::string binfilename = "test_streaming_engine.gwb";
+      WriteObsCsv(csvfilename, records);
+      write_obs_binary(binfilename, records);
+
+      bool flag = true;
+      for (const std::string& filename : {csvfilename, binfilename}) {
+         Results actual = StreamingEngine(2000, -2000, 2.3, 0.5, 3, h_alpha, 0.05, 4, 150.0, filename, wells, 7);
+
+         flag &= CHECK( isCloseRel(actual.R_ev, expected.R_ev) );
+         flag &= CHECK( isCloseRel(actual.R_sd, expected.R_sd) );
+         flag &= CHECK( isCloseRel(actual.M_ev, expected.M_ev) );
+         flag &= CHECK( isCloseRel(actual.M_sd, expected.M_sd) );
+         flag &= CHECK( isCloseRel(actual.D_ev, expected.D_ev) );
+         flag &= CHECK( isCloseRel(actual.D_sd, expected.D_sd) );
+         flag &= CHECK( isCloseRel(actual.LogLik, expected.LogLik) );
+      }
+
+      std::remove(csvfilename.c_str());
+      std::remove(binfilename.c_str());
+      return flag;
+   }
+
+   //--------------------------------------------------------------------------
+   // TestStreamingEngineUnique
+   //
+   //    Twelve active observations at only eight locations are too few, as
+   //    they are for the Engine, even though the model could be fit.
+   //--------------------------------------------------------------------------
+   bool TestStreamingEngineUnique() {
+      std::vector<ObsRecord> records;
+      for (int m = 0; m < 12; ++m) {
+         const double angle = TWO_PI * (m % 8) / 8;
+         const double r = 400.0 + 60.0*(m % 8);
+         records.push_back( ObsRecord{"", 2000.0 + r*std::cos(angle), -2000.0 + r*std::sin(angle), 100.0 + 0.1*m, 1.0} );
+      }
+
+      const std::string filename = "test_streaming_engine.csv";
+      WriteObsCsv(filename, records);
+
+      bool thrown = false;
+      try {
+         StreamingEngine(2000, -2000, 2.3, 0.5, 2, 3.0, 0.1, 2, 0.0, filename, std::vector<WellRecord>(), 5);
+      }
+      catch (TooFewObservations&) {
+         thrown = true;
+      }
+
+      std::remove(filename.c_str());
+      return CHECK( thrown );
+   }
+}
+
+//-----------------------------------------------------------------------------
+// test_StreamingEngine
+//-----------------------------------------------------------------------------
+std::pair<int,int> test_StreamingEngine()
+{
+   int nsucc = 0;
+   int nfail = 0;
+
+   TALLY( TestStreamingEngine() );
+   TALLY( TestStreamingEngineUnique() );
+
+   return std::make_pair( nsucc, nfail );
+}
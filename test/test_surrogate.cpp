@@ -0,0 +1,117 @@
+//=============================================================================
+// test_surrogate.cpp
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include "test_surrogate.h"
+#include "test_helpers.h"
+#include "unit_test.h"
+#include "..\src\engine.h"
+#include "..\src\surrogate.h"
+
+//-----------------------------------------------------------------------------
+// Hide all of the testing details inside an unnamed namespace. This allows me
+// to create many small unit tests with polluting the global namespace.
+//-----------------------------------------------------------------------------
+namespace{
+
+   //--------------------------------------------------------------------------
+   // TestSurrogateAccuracy
+   //
+   //    Within the distributions, the surrogate matches the Engine to a
+   //    small fraction of a standard deviation, and its reported errors
+   //    bound the errors at other cells.
+   //--------------------------------------------------------------------------
+   bool TestSurrogateAccuracy() {
+      std::vector<ObsRecord> records;
+      std::vector<WellRecord> wells;
+      MakeProblem(records, wells);
+      ObsTable obs(records);
+
+      const double k_alpha = 2.0, k_beta = 0.5, h_alpha = 3.0, h_beta = 0.2;
+      Surrogate surrogate = FitSurrogate(2000, -2000, k_alpha, k_beta, h_alpha, h_beta, 6, 100.0, obs, wells, 0);
+      Results full = Engine(2000, -2000, k_alpha, k_beta, 7, h_alpha, h_beta, 5, 100.0, obs, wells);
+
+      bool flag = true;
+      flag &= CHECK( surrogate.Terms() == 28 );
+      for (int i = 0; i < 7; ++i) {
+         for (int j = 0; j < 5; ++j) {
+            CellResult cell = surrogate(full.k[i], full.h[j]);
+            flag &= CHECK( std::fabs(cell.r_ev - full.R_ev(i,j)) <= 0.01 * full.R_sd(i,j) );
+            flag &= CHECK( std::fabs(cell.m_ev - full.M_ev(i,j)) <= 0.01 * full.M_sd(i,j) );
+            flag &= CHECK( std::fabs(cell.d_ev - full.D_ev(i,j)) <= 0.01 * full.D_sd(i,j) );
+            flag &= CHECK( std::fabs(cell.r_sd - full.R_sd(i,j)) <= 0.01 * full.R_sd(i,j) );
+         }
+      }
+      for (int f = 0; f < RESULT_FIELD_COUNT; ++f)
+         flag &= CHECK( surrogate.rms_error[f] <= surrogate.max_error[f] );
+      return flag;
+   }
+
+   //--------------------------------------------------------------------------
+   // TestSurrogateFile
+   //
+   //    A surrogate read back from its file evaluates identically; a damaged
+   //    file is rejected.
+   //--------------------------------------------------------------------------
+   bool TestSurrogateFile() {
+      Surrogate surrogate(2.0, 0.5, 3.0, 0.2, 2);
+      for (int t = 0; t < surrogate.Terms(); ++t)
+         for (int s = 0; s < RESULT_FIELD_COUNT; ++s)
+            surrogate.coefficients(t,s) = std::sin(1.0 + t + 0.1*s) / (1 + t);
+      for (int f = 0; f < RESULT_FIELD_COUNT; ++f) {
+         surrogate.rms_error[f] = 0.1 * (f+1);
+         surrogate.max_error[f] = 0.3 * (f+1);
+      }
+
+      std::stringstream file;
+      WriteSurrogate(file, surrogate);
+      const std::string text = file.str();
+      Surrogate copy = ReadSurrogate(file, "test");
+
+      bool flag = true;
+      flag &= CHECK( copy.degree == 2 );
+      flag &= CHECK( copy.max_error[5] == surrogate.max_error[5] );
+
+      CellResult a = surrogate(9.0, 21.0);
+      CellResult b = copy(9.0, 21.0);
+      flag &= CHECK( a.r_ev == b.r_ev && a.m_sd == b.m_sd && a.d_ev == b.d_ev );
+
+      // Drop the last line.
+      std::istringstream damaged( text.substr(0, text.rfind('\n', text.size()-2) + 1) );
+      bool thrown = false;
+      try {
+         ReadSurrogate(damaged, "damaged");
+      }
+      catch (InvalidSurrogateFile&) {
+         thrown = true;
+      }
+      flag &= CHECK( thrown );
+      return flag;
+   }
+}
+
+//-----------------------------------------------------------------------------
+// test_Surrogate
+//-----------------------------------------------------------------------------
+std::pair<int,int> test_Surrogate()
+{
+   int nsucc = 0;
+   int nfail = 0;
+
+   TALLY( TestSurrogateAccuracy() );
+   TALLY( TestSurrogateFile() );
+
+   return std::make_pair( nsucc, nfail );
+}
@@ -0,0 +1,21 @@
+//=============================================================================
+// test_surrogate.h
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#ifndef TEST_SURROGATE_H
+#define TEST_SURROGATE_H
+
+#include <utility>
+
+//-----------------------------------------------------------------------------
+std::pair<int,int> test_Surrogate();
+
+//=============================================================================
+#endif  // TEST_SURROGATE_H
@@ -0,0 +1,372 @@
+//=============================================================================
+// test_write_results.cpp
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "test_write_results.h"
+#include "unit_test.h"
+#include "..\src\result_sink.h"
+#include "..\src\write_results.h"
+
+//-----------------------------------------------------------------------------
+// Hide all of the testing details inside an unnamed namespace. This allows me
+// to create many small unit tests with polluting the global namespace.
+//-----------------------------------------------------------------------------
+namespace{
+   const char* ROOT = "test_write_results";
+
+   //--------------------------------------------------------------------------
+   // A small grid with distinct, awkward values in every field.
+   //--------------------------------------------------------------------------
+   struct Grid {
+      std::vector<double> k;
+      std::vector<double> h;
+      std::vector<std::vector<CellResult>> rows;
+   };
+
+   Grid MakeGrid( int k_count, int h_count ) {
+      Grid grid;
+      for (int i = 0; i < k_count; ++i)
+         grid.k.push_back( 0.1*(i+1) + 1.0/3.0 );
+      for (int j = 0; j < h_count; ++j)
+         grid.h.push_back( 10.0*(j+1) + 1.0/7.0 );
+
+      for (int i = 0; i < k_count; ++i) {
+         std::vector<CellResult> row(h_count);
+         for (int j = 0; j < h_count; ++j) {
+            const double v = (i+1) / (j + 3.0);
+            row[j].r_ev = 1e-4*v;
+            row[j].r_sd = 3e-5*v;
+            row[j].m_ev = 1.5 + v;
+            row[j].m_sd = 0.2*v;
+            row[j].d_ev = -2.0 + 0.01*v;
+            row[j].d_sd = 0.003*v;
+         }
+         grid.rows.push_back(row);
+      }
+      return grid;
+   }
+
+   void Send( ResultSink& sink, const Grid& grid ) {
+      sink.Begin(grid.k, grid.h);
+      for (size_t i = 0; i < grid.rows.size(); ++i)
+         sink.Row(static_cast<int>(i), grid.rows[i]);
+      sink.End();
+   }
+
+   std::vector<char> ReadBytes( const std::string& filename ) {
+      std::ifstream inpfile( filename, std::ios::binary );
+      return std::vector<char>( std::istreambuf_iterator<char>(inpfile), std::istreambuf_iterator<char>() );
+   }
+
+   uint32_t Get16( const std::vector<char>& bytes, size_t offset ) {
+      return static_cast<unsigned char>(bytes[offset]) | (static_cast<unsigned char>(bytes[offset+1]) << 8);
+   }
+
+   uint32_t Get32( const std::vector<char>& bytes, size_t offset ) {
+      return Get16(bytes, offset) | (Get16(bytes, offset+2) << 16);
+   }
+
+   double GetDouble( const std::vector<char>& bytes, size_t offset ) {
+      uint64_t v = Get32(bytes, offset) | (uint64_t(Get32(bytes, offset+4)) << 32);
+      double x;
+      memcpy(&x, &v, sizeof(x));
+      return x;
+   }
+
+   // The CRC-32 of the ZIP format, bit by bit, independent of the table
+   // driven version in write_results.cpp.
+   uint32_t BitwiseCrc32( const char* data, size_t n ) {
+      uint32_t crc = 0xFFFFFFFFu;
+      for (size_t i = 0; i < n; ++i) {
+         crc ^= static_cast<unsigned char>(data[i]);
+         for (int b = 0; b < 8; ++b)
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+      }
+      return crc ^ 0xFFFFFFFFu;
+   }
+
+   // Split a .csv file into its lines, and each line into its fields.
+   std::vector<std::vector<std::string>> SplitCsv( const std::vector<char>& bytes ) {
+      std::vector<std::vector<std::string>> lines;
+      std::stringstream text( std::string(bytes.begin(), bytes.end()) );
+      std::string line;
+      while (std::getline(text, line)) {
+         std::vector<std::string> fields;
+         std::stringstream fieldtext(line);
+         std::string field;
+         while (std::getline(fieldtext, field, ','))
+            fields.push_back(field);
+         lines.push_back(fields);
+      }
+      return lines;
+   }
+
+   // The number of significant digits in a number's text, ignoring the
+   // leading and trailing zeros.
+   int SignificantDigits( const std::string& text ) {
+      std::string digits;
+      for (char c : text.substr(0, text.find_first_of("eE"))) {
+         if (c >= '0' && c <= '9')
+            digits.push_back(c);
+      }
+      const size_t first = digits.find_first_not_of('0');
+      if (first == std::string::npos)
+         return 0;
+      return static_cast<int>(digits.find_last_not_of('0') - first + 1);
+   }
+
+   // True if "text" is the expected form of x: with precision 0, text that
+   // reads back to exactly x with the fewest significant digits that can;
+   // otherwise, the %g form with "precision" significant digits.
+   bool isFormatted( const std::string& text, double x, int precision ) {
+      char expected[32];
+      if (precision > 0) {
+         snprintf(expected, sizeof(expected), "%.*g", precision, x);
+         return text == expected;
+      }
+
+      for (int digits = 1; digits <= 17; ++digits) {
+         snprintf(expected, sizeof(expected), "%.*g", digits, x);
+         if (std::strtod(expected, nullptr) == x)
+            break;
+      }
+      return std::strtod(text.c_str(), nullptr) == x && SignificantDigits(text) == SignificantDigits(expected);
+   }
+
+   // Write the grid with a CsvResultSink, and return the bytes of each file.
+   std::vector<std::vector<char>> WriteCsv( const Grid& grid, int precision, int nthreads ) {
+      const std::vector<ResultField> fields = OutputFields(false);
+      {
+         CsvResultSink sink(ROOT, precision, false, nthreads);
+         Send(sink, grid);
+      }
+
+      std::vector<std::vector<char>> files;
+      for (const ResultField& field : fields) {
+         const std::string filename = std::string(ROOT) + "_" + field.name + ".csv";
+         files.push_back( ReadBytes(filename) );
+         std::remove(filename.c_str());
+      }
+      return files;
+   }
+
+   //--------------------------------------------------------------------------
+   // TestCsvResultSink
+   //
+   //    More rows than one block, at the default shortest round-trip form and
+   //    at a fixed precision, on one thread and on four. The values must
+   //    parse back as expected, and the bytes must not depend on the number
+   //    of threads.
+   //--------------------------------------------------------------------------
+   bool TestCsvResultSink()
+   {
+      bool flag = true;
+
+      const Grid grid = MakeGrid(150, 5);
+      const std::vector<ResultField> fields = OutputFields(false);
+
+      for (int precision : {0, 4}) {
+         const std::vector<std::vector<char>> serial = WriteCsv(grid, precision, 1);
+         const std::vector<std::vector<char>> parallel = WriteCsv(grid, precision, 4);
+         flag &= CHECK( serial == parallel );
+         flag &= CHECK( serial.size() == fields.size() );
+
+         for (size_t f = 0; f < serial.size() && f < fields.size(); ++f) {
+            const std::vector<std::vector<std::string>> lines = SplitCsv(serial[f]);
+            flag &= CHECK( lines.size() == grid.k.size() + 1 );
+            if (lines.size() != grid.k.size() + 1)
+               continue;
+
+            // The header row: an empty cell, then the h values.
+            flag &= CHECK( lines[0].size() == grid.h.size() + 1 && lines[0][0].empty() );
+            for (size_t j = 0; j < grid.h.size() && j+1 < lines[0].size(); ++j)
+               flag &= CHECK( isFormatted(lines[0][j+1], grid.h[j], precision) );
+
+            // Each row: the k value, then the scaled values of the field.
+            for (size_t i = 0; i < grid.k.size(); ++i) {
+               const std::vector<std::string>& line = lines[i+1];
+               flag &= CHECK( line.size() == grid.h.size() + 1 );
+               if (line.size() != grid.h.size() + 1)
+                  continue;
+
+               flag &= CHECK( isFormatted(line[0], grid.k[i], precision) );
+               for (size_t j = 0; j < grid.h.size(); ++j) {
+                  const double x = fields[f].scale * (grid.rows[i][j].*fields[f].value);
+                  flag &= CHECK( isFormatted(line[j+1], x, precision) );
+               }
+            }
+         }
+      }
+      return flag;
+   }
+
+   //--------------------------------------------------------------------------
+   // Check one .npy member: the version 1.0 header, its padding, the shape,
+   // and the values.
+   //--------------------------------------------------------------------------
+   bool CheckNpy( const std::vector<char>& npy, const std::string& shape, const std::vector<double>& values ) {
+      bool flag = true;
+
+      flag &= CHECK( npy.size() >= 10 && memcmp(npy.data(), "\x93NUMPY\x01\x00", 8) == 0 );
+      if (!flag)
+         return flag;
+
+      const size_t length = Get16(npy, 8);
+      const size_t data = 10 + length;
+      flag &= CHECK( data % 64 == 0 );
+      flag &= CHECK( npy.size() == data + 8*values.size() );
+      if (!flag)
+         return flag;
+
+      const std::string dict = "{'descr': '<f8', 'fortran_order': False, 'shape': (" + shape + "), }";
+      const std::string header(npy.begin() + 10, npy.begin() + data);
+      flag &= CHECK( header.compare(0, dict.size(), dict) == 0 );
+      flag &= CHECK( header.find_first_not_of(' ', dict.size()) == length-1 );
+      flag &= CHECK( header[length-1] == '\n' );
+
+      for (size_t n = 0; n < values.size(); ++n)
+         flag &= CHECK( GetDouble(npy, data + 8*n) == values[n] );
+      return flag;
+   }
+
+   //--------------------------------------------------------------------------
+   // TestNpzResultSink
+   //
+   //    Parse the archive back: the central directory, the local headers,
+   //    the CRC-32s, and each .npy member.
+   //--------------------------------------------------------------------------
+   bool TestNpzResultSink()
+   {
+      bool flag = true;
+
+      const char check[] = "123456789";
+      flag &= CHECK( BitwiseCrc32(check, 9) == 0xCBF43926u );
+
+      const Grid grid = MakeGrid(3, 2);
+      const std::vector<ResultField> fields = OutputFields(false);
+      {
+         NpzResultSink sink(ROOT, false);
+         Send(sink, grid);
+      }
+      const std::string filename = std::string(ROOT) + ".npz";
+      const std::vector<char> bytes = ReadBytes(filename);
+      std::remove(filename.c_str());
+
+      // The members, in order, and their expected contents.
+      std::vector<std::string> names = {"k.npy", "h.npy"};
+      std::vector<std::string> shapes = {"3, ", "2, "};
+      std::vector<std::vector<double>> contents = {grid.k, grid.h};
+      for (const ResultField& field : fields) {
+         names.push_back( std::string(field.name) + ".npy" );
+         shapes.push_back( "3, 2, " );
+         std::vector<double> values;
+         for (const auto& row : grid.rows)
+            for (const CellResult& cell : row)
+               values.push_back( field.scale * (cell.*field.value) );
+         contents.push_back(values);
+      }
+
+      // The end of central directory record.
+      flag &= CHECK( bytes.size() > 22 );
+      if (!flag)
+         return flag;
+      const size_t end = bytes.size() - 22;
+      flag &= CHECK( Get32(bytes, end) == 0x06054b50 );
+      flag &= CHECK( Get16(bytes, end+8) == names.size() && Get16(bytes, end+10) == names.size() );
+      const size_t directory_size = Get32(bytes, end+12);
+      size_t entry = Get32(bytes, end+16);
+      flag &= CHECK( entry + directory_size == end );
+      if (!flag)
+         return flag;
+
+      for (size_t n = 0; n < names.size() && flag; ++n) {
+         // The central directory entry.
+         flag &= CHECK( Get32(bytes, entry) == 0x02014b50 );
+         flag &= CHECK( Get16(bytes, entry+10) == 0 );
+         const uint32_t crc    = Get32(bytes, entry+16);
+         const uint32_t size   = Get32(bytes, entry+20);
+         const size_t   length = Get16(bytes, entry+28);
+         const size_t   local  = Get32(bytes, entry+42);
+         flag &= CHECK( Get32(bytes, entry+24) == size );
+         flag &= CHECK( std::string(&bytes[entry+46], length) == names[n] );
+         entry += 46 + length + Get16(bytes, entry+30) + Get16(bytes, entry+32);
+
+         // The local file header must agree with it.
+         flag &= CHECK( Get32(bytes, local) == 0x04034b50 );
+         flag &= CHECK( Get16(bytes, local+8) == 0 );
+         flag &= CHECK( Get32(bytes, local+14) == crc );
+         flag &= CHECK( Get32(bytes, local+18) == size && Get32(bytes, local+22) == size );
+         flag &= CHECK( Get16(bytes, local+26) == length );
+         flag &= CHECK( std::string(&bytes[local+30], length) == names[n] );
+         const size_t data = local + 30 + length + Get16(bytes, local+28);
+         flag &= CHECK( data + size <= bytes.size() );
+         if (!flag)
+            break;
+
+         std::vector<char> npy(bytes.begin() + data, bytes.begin() + data + size);
+         flag &= CHECK( BitwiseCrc32(npy.data(), npy.size()) == crc );
+         flag &= CheckNpy(npy, shapes[n], contents[n]);
+      }
+      return flag;
+   }
+
+   //--------------------------------------------------------------------------
+   // TestNpzSizeLimit
+   //
+   //    A grid too large for the plain ZIP format must be rejected by Begin,
+   //    before the file is created.
+   //--------------------------------------------------------------------------
+   bool TestNpzSizeLimit()
+   {
+      bool flag = true;
+
+      const std::vector<double> axis(10000, 1.0);
+      const std::string filename = std::string(ROOT) + ".npz";
+      std::remove(filename.c_str());
+
+      bool thrown = false;
+      try {
+         NpzResultSink sink(ROOT, false);
+         sink.Begin(axis, axis);
+      }
+      catch (InvalidOutputFile&) {
+         thrown = true;
+      }
+      flag &= CHECK( thrown );
+      flag &= CHECK( !std::ifstream(filename).good() );
+      return flag;
+   }
+}
+
+//-----------------------------------------------------------------------------
+// test_WriteResults
+//-----------------------------------------------------------------------------
+std::pair<int,int> test_WriteResults()
+{
+   int nsucc = 0;
+   int nfail = 0;
+
+   TALLY( TestCsvResultSink() );
+   TALLY( TestNpzResultSink() );
+   TALLY( TestNpzSizeLimit() );
+
+   return std::make_pair( nsucc, nfail );
+}
@@ -0,0 +1,21 @@
+//=============================================================================
+// test_write_results.h
+//
+// author:
+//    Dr. Randal J. Barnes
+//    Department of Civil, Environmental, and Geo- Engineering
+//    University of Minnesota
+//
+// version:
+//    18 October 2026
+//=============================================================================
+#ifndef TEST_WRITE_RESULTS_H
+#define TEST_WRITE_RESULTS_H
+
+#include <utility>
+
+//-----------------------------------------------------------------------------
+std::pair<int,int> test_WriteResults();
+
+//=============================================================================
+#endif  // TEST_WRITE_RESULTS_H